@@ -4,6 +4,25 @@
 
 int main(int argc, char *argv[])
 {
+    // 离屏出图工作进程：不创建 Qt 界面，VTK 用离屏窗口和软件 OpenGL。
+    // VTK 的窗口实现在编译时选定，X11 的实现仍要连接 X 显示（DISPLAY），无显示器时主进程用 xvfb-run 启动工作进程
+    bool renderWorker = false;
+    bool selfTest = false;
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--render-worker") == 0) renderWorker = true;
+        if (qstrcmp(argv[i], "--self-test") == 0) selfTest = true;
+    }
+    // 几何算法自检：不需要界面
+    if (selfTest) {
+        return MainWindow::RunSelfTest();
+    }
+    // 工作进程只读结果和离屏渲染，不创建界面
+    if (renderWorker) {
+        if (!qEnvironmentVariableIsSet("LIBGL_ALWAYS_SOFTWARE")) qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+        QCoreApplication a(argc, argv);
+        return MainWindow::RunRenderWorker(a.arguments());
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -2,6 +2,7 @@
 #include "./ui_mainwindow.h"
 
 #include <QDebug>
+#include <QThread>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -13,6 +14,8 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->pushButton_extractFace, &QPushButton::clicked, this, &MainWindow::extractFace);
     connect(ui->pushButton_CenterLine, &QPushButton::clicked,this, &MainWindow::onExtractCenterlineButtonClicked);
     connect(ui->pushButton_Mesh1, &QPushButton::clicked,this, &MainWindow::on_meshButton_clicked);
+    connect(ui->pushButton_Inp, &QPushButton::clicked,this, &MainWindow::onGenerateInpClicked);
+    connect(ui->pushButton_AddMaterial, &QPushButton::clicked,this, &MainWindow::onAddMaterialClicked);
 
     //过程可视化
     connect(ui->pushButton_initmodel, &QPushButton::clicked,this, &MainWindow::init_model);
@@ -30,13 +33,629 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->pushButton_S_Mises, &QPushButton::clicked,this, &MainWindow::onButtonSMisesClicked);
     connect(ui->pushButton_S_principal, &QPushButton::clicked,this, &MainWindow::onButtonSPrincipalClicked);
     connect(ui->pushButton_U, &QPushButton::clicked,this, &MainWindow::onButtonUClicked);
+    connect(ui->pushButton_Compare, &QPushButton::clicked,this, &MainWindow::onCompareClicked);
+    connect(ui->pushButton_CutPlane, &QPushButton::clicked,this, &MainWindow::onCutPlaneClicked);
+    connect(ui->pushButton_MeshQuality, &QPushButton::clicked,this, &MainWindow::onMeshQualityClicked);
+    connect(ui->pushButton_BendingLine, &QPushButton::clicked,this, &MainWindow::onBendingLineClicked);
+
+    //结果分析
+    connect(ui->pushButton_ovality_all, &QPushButton::clicked,this, &MainWindow::onOvalityAllClicked);
+    connect(ui->pushButton_thickness_all, &QPushButton::clicked,this, &MainWindow::onThicknessAllClicked);
+    connect(ui->pushButton_wrinkles, &QPushButton::clicked,this, &MainWindow::onWrinklesClicked);
+    connect(ui->pushButton_wrinkles_all, &QPushButton::clicked,this, &MainWindow::onWrinklesAllClicked);
+    connect(ui->toolButton_wrinkles_or, &QToolButton::clicked,this, &MainWindow::onWrinklesOptionClicked);
+    connect(ui->pushButton_springback, &QPushButton::clicked,this, &MainWindow::onSpringbackClicked);
+    connect(ui->toolButton_springback_or, &QToolButton::clicked,this, &MainWindow::onSpringbackOptionClicked);
+    connect(ui->pushButton_compensation, &QPushButton::clicked,this, &MainWindow::onCompensationClicked);
+    connect(ui->toolButton_compensation_or, &QToolButton::clicked,this, &MainWindow::onCompensationOptionClicked);
+
+    //提交计算
+    connect(ui->pushButton_Step, &QPushButton::clicked,this, &MainWindow::onSubmitJobClicked);
+    m_jobWatcher = new QFileSystemWatcher(this);
+    connect(m_jobWatcher, &QFileSystemWatcher::directoryChanged, this, &MainWindow::PollSolverJobs);
+    m_jobPollTimer = new QTimer(this);
+    m_jobPollTimer->setInterval(500);
+    connect(m_jobPollTimer, &QTimer::timeout, this, &MainWindow::PollSolverJobs);
+    connect(ui->action_JobQueue, &QAction::triggered, this, &MainWindow::onJobPanelClicked);
+
+    //后台导出队列
+    m_maxConcurrentExports = std::max(2, std::min(4, QThread::idealThreadCount()));
+    m_exportPollTimer = new QTimer(this);
+    m_exportPollTimer->setInterval(100);
+    connect(m_exportPollTimer, &QTimer::timeout, this, &MainWindow::PollExports);
+
+    //结果索引：目录变化后稍作延迟再扫描，合并短时间内的多次通知
+    m_resultsWatcher = new QFileSystemWatcher(this);
+    m_resultIndexTimer = new QTimer(this);
+    m_resultIndexTimer->setSingleShot(true);
+    m_resultIndexTimer->setInterval(500);
+    connect(m_resultsWatcher, &QFileSystemWatcher::directoryChanged, m_resultIndexTimer, QOverload<>::of(&QTimer::start));
+    connect(m_resultIndexTimer, &QTimer::timeout, this, &MainWindow::RefreshResultIndex);
+
+    //内存预算：使用记录后在事件循环空闲时检查，避免在一次操作中途淘汰正在使用的数据
+    m_memoryTimer = new QTimer(this);
+    m_memoryTimer->setSingleShot(true);
+    m_memoryTimer->setInterval(200);
+    connect(m_memoryTimer, &QTimer::timeout, this, &MainWindow::EnforceMemoryBudget);
+    connect(ui->action_MemoryPanel, &QAction::triggered, this, &MainWindow::onMemoryPanelClicked);
+    connect(ui->action_RenderReport, &QAction::triggered, this, &MainWindow::onRenderReportClicked);
+    connect(ui->action_SectionOptions, &QAction::triggered, this, &MainWindow::onSectionOptionClicked);
+
+    //数模导入：转换后并行划分显示网格
+    connect(ui->action_ParallelImport, &QAction::toggled, this, [this](bool on) { m_parallelImportMesh = on; });
+    connect(ui->action_HealImport, &QAction::toggled, this, [this](bool on) { m_healImport = on; });
 }
 
 MainWindow::~MainWindow()
 {
+    // 等待仍在建模的弯管部件，其排队的回调随窗口一起丢弃
+    m_elbowPool.clear();
+    m_elbowPool.waitForDone();
+    // 关闭窗口时结束仍在运行的求解作业
+    for (auto& job : m_solverJobs) {
+        if (job.process) {
+            disconnect(job.process, nullptr, this, nullptr);
+            job.process->kill();
+            job.process->waitForFinished(1000);
+        }
+    }
+    for (auto& job : m_renderJobs) {
+        if (job.process) {
+            disconnect(job.process, nullptr, this, nullptr);
+            job.process->kill();
+            job.process->waitForFinished(1000);
+        }
+    }
     delete ui;
 }
 
+//----------网格顶点合并----------|
+//OCC 按面分别三角化，相邻面在公共边上的节点各有一份。这里把所有面的节点放在一起，
+//用空间哈希（网格边长 = 合并容差）并行查找容差内的重复节点，输出共享顶点、带精确节点法向的三角网格
+#include <vtkSMPTools.h>
+#include <vtkIntArray.h>
+#include <vtkCellData.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkFloatArray.h>
+#include <vtkPointData.h>
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <TopoDS.hxx>
+#include <TopExp_Explorer.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <BRepAdaptor_Surface.hxx>
+#pragma GCC diagnostic pop
+
+// 合并容差相对三角化弦高偏差的比例
+static const double kWeldToleranceRatio = 1e-3;
+
+// 法向不一致（夹角超过约 10°）的重合节点视为棱边两侧，不合并
+static const double kWeldCreaseCos = 0.985;
+
+// 一个面在合并前网格中的位置
+struct FaceTriangulationRef {
+    TopoDS_Face face;
+    Handle(Poly_Triangulation) triangulation;
+    TopLoc_Location loc;
+    size_t firstPoint = 0;
+    size_t firstTriangle = 0;
+};
+
+//收集各面的三角化（未合并），面按 TopExp_Explorer 顺序编号，反向面翻转三角形绕向。
+//节点法向按 UV 参数在 OCC 曲面上精确计算，各面并行处理
+static void CollectFaceTriangulations(const TopoDS_Shape& shape, WeldedMesh& mesh)
+{
+    mesh = WeldedMesh();
+
+    // 1. 按面顺序确定各面节点和三角形的起始位置
+    std::vector<FaceTriangulationRef> refs;
+    size_t numPoints = 0, numTriangles = 0;
+    for (TopExp_Explorer faceExp(shape, TopAbs_FACE); faceExp.More(); faceExp.Next()) {
+        FaceTriangulationRef ref;
+        ref.face = TopoDS::Face(faceExp.Current());
+        mesh.faces.push_back(ref.face);
+        ref.triangulation = BRep_Tool::Triangulation(ref.face, ref.loc);
+        if (ref.triangulation.IsNull()) {
+            refs.push_back(ref);
+            continue;
+        }
+        ref.firstPoint = numPoints;
+        ref.firstTriangle = numTriangles;
+        numPoints += ref.triangulation->NbNodes();
+        numTriangles += ref.triangulation->NbTriangles();
+        mesh.deflection = std::max(mesh.deflection, ref.triangulation->Deflection());
+        refs.push_back(ref);
+    }
+    mesh.points.resize(numPoints * 3);
+    mesh.normals.assign(numPoints * 3, 0.0f);
+    mesh.triangles.resize(numTriangles * 3);
+    mesh.faceIds.resize(numTriangles);
+
+    // 2. 各面并行写出节点、法向和三角形
+    vtkSMPTools::For(0, static_cast<vtkIdType>(refs.size()), [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType f = begin; f < end; ++f) {
+            const FaceTriangulationRef& ref = refs[f];
+            const Handle(Poly_Triangulation)& tri = ref.triangulation;
+            if (tri.IsNull()) continue;
+            const bool reversed = ref.face.Orientation() == TopAbs_REVERSED;
+            const Standard_Integer numNodes = tri->NbNodes();
+
+            double* pts = &mesh.points[ref.firstPoint * 3];
+            for (Standard_Integer i = 1; i <= numNodes; i++) {
+                gp_Pnt p = tri->Node(i);
+                if (!ref.loc.IsIdentity()) {
+                    p.Transform(ref.loc.Transformation());
+                }
+                pts[(i - 1) * 3] = p.X();
+                pts[(i - 1) * 3 + 1] = p.Y();
+                pts[(i - 1) * 3 + 2] = p.Z();
+            }
+
+            WeldIndex* tris = &mesh.triangles[ref.firstTriangle * 3];
+            const WeldIndex base = static_cast<WeldIndex>(ref.firstPoint);
+            for (Standard_Integer i = 1; i <= tri->NbTriangles(); i++) {
+                Standard_Integer n1, n2, n3;
+                tri->Triangle(i).Get(n1, n2, n3);
+                if (reversed) std::swap(n2, n3);
+                tris[(i - 1) * 3] = base + n1 - 1;
+                tris[(i - 1) * 3 + 1] = base + n2 - 1;
+                tris[(i - 1) * 3 + 2] = base + n3 - 1;
+                mesh.faceIds[ref.firstTriangle + i - 1] = static_cast<int>(f);
+            }
+
+            // 法向：有 UV 时在曲面上求 dS/du x dS/dv（BRepAdaptor_Surface 已含面的位置变换），
+            // 奇异点（如极点）和无 UV 的三角化用相邻三角形的面积加权法向
+            float* nrm = &mesh.normals[ref.firstPoint * 3];
+            std::vector<char> defined(numNodes, 0);
+            if (tri->HasUVNodes()) {
+                BRepAdaptor_Surface surface(ref.face);
+                for (Standard_Integer i = 1; i <= numNodes; i++) {
+                    const gp_Pnt2d uv = tri->UVNode(i);
+                    gp_Pnt p;
+                    gp_Vec du, dv;
+                    surface.D1(uv.X(), uv.Y(), p, du, dv);
+                    gp_Vec n = du.Crossed(dv);
+                    const double len = n.Magnitude();
+                    if (len < 1e-12) continue;
+                    n /= reversed ? -len : len;
+                    nrm[(i - 1) * 3] = static_cast<float>(n.X());
+                    nrm[(i - 1) * 3 + 1] = static_cast<float>(n.Y());
+                    nrm[(i - 1) * 3 + 2] = static_cast<float>(n.Z());
+                    defined[i - 1] = 1;
+                }
+            }
+            if (std::find(defined.begin(), defined.end(), 0) == defined.end()) continue;
+            std::vector<double> accum(numNodes * 3, 0.0);
+            for (Standard_Integer t = 0; t < tri->NbTriangles(); t++) {
+                const WeldIndex* v = tris + t * 3;
+                const double* a = &mesh.points[v[0] * 3];
+                const double* b = &mesh.points[v[1] * 3];
+                const double* c = &mesh.points[v[2] * 3];
+                const double e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+                const double e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+                const double cr[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+                for (int k = 0; k < 3; ++k) {
+                    for (int d = 0; d < 3; ++d) accum[(v[k] - base) * 3 + d] += cr[d];
+                }
+            }
+            for (Standard_Integer i = 0; i < numNodes; i++) {
+                if (defined[i]) continue;
+                const double* n = &accum[i * 3];
+                const double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (len <= 0) continue;
+                for (int d = 0; d < 3; ++d) nrm[i * 3 + d] = static_cast<float>(n[d] / len);
+            }
+        }
+    });
+}
+
+// 空间哈希的网格键
+static inline uint64_t WeldCellKey(int64_t x, int64_t y, int64_t z)
+{
+    uint64_t h = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ULL;
+    h ^= static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4FULL + (h << 6) + (h >> 2);
+    h ^= static_cast<uint64_t>(z) * 0x165667B19E3779F9ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+//合并容差内的重复顶点：每个节点并行查找相邻 27 个网格中编号最小、法向一致的重合节点，
+//再按编号顺序串联成代表节点。结果与线程数无关；棱边两侧的节点保持分开，合并后退化的三角形被删除
+static void WeldVertices(WeldedMesh& mesh)
+{
+    const vtkIdType n = static_cast<vtkIdType>(mesh.points.size() / 3);
+    if (n == 0) return;
+    double tolerance = kWeldToleranceRatio * mesh.deflection;
+    if (tolerance <= 0) {
+        double lo[3] = {mesh.points[0], mesh.points[1], mesh.points[2]}, hi[3] = {lo[0], lo[1], lo[2]};
+        for (vtkIdType i = 1; i < n; ++i) {
+            for (int k = 0; k < 3; ++k) {
+                lo[k] = std::min(lo[k], mesh.points[i * 3 + k]);
+                hi[k] = std::max(hi[k], mesh.points[i * 3 + k]);
+            }
+        }
+        tolerance = 1e-7 * std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) + (hi[1] - lo[1]) * (hi[1] - lo[1]) +
+                                     (hi[2] - lo[2]) * (hi[2] - lo[2]));
+        if (tolerance <= 0) tolerance = 1e-9;
+    }
+    const double inv = 1.0 / tolerance;
+    const double tol2 = tolerance * tolerance;
+    const double* pts = mesh.points.data();
+    const float* nrm = mesh.normals.size() == mesh.points.size() ? mesh.normals.data() : nullptr;
+
+    // 1. 节点按网格键排序，同一网格中的节点连续存放
+    std::vector<std::pair<uint64_t, WeldIndex>> keys(n);
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i) {
+            const double* p = pts + i * 3;
+            keys[i] = {WeldCellKey(static_cast<int64_t>(std::floor(p[0] * inv)),
+                                   static_cast<int64_t>(std::floor(p[1] * inv)),
+                                   static_cast<int64_t>(std::floor(p[2] * inv))),
+                       static_cast<WeldIndex>(i)};
+        }
+    });
+    vtkSMPTools::Sort(keys.begin(), keys.end());
+
+    // 2. 每个节点的代表：相邻网格内容差范围中编号最小的节点（哈希冲突只多比较几次距离）
+    std::vector<WeldIndex> rep(n);
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+        auto keyLess = [](const std::pair<uint64_t, WeldIndex>& a, uint64_t k) { return a.first < k; };
+        for (vtkIdType i = begin; i < end; ++i) {
+            const double* p = pts + i * 3;
+            const int64_t cx = static_cast<int64_t>(std::floor(p[0] * inv));
+            const int64_t cy = static_cast<int64_t>(std::floor(p[1] * inv));
+            const int64_t cz = static_cast<int64_t>(std::floor(p[2] * inv));
+            WeldIndex best = static_cast<WeldIndex>(i);
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dz = -1; dz <= 1; ++dz) {
+                        const uint64_t key = WeldCellKey(cx + dx, cy + dy, cz + dz);
+                        for (auto it = std::lower_bound(keys.begin(), keys.end(), key, keyLess);
+                             it != keys.end() && it->first == key && it->second < best; ++it) {
+                            const double* q = pts + static_cast<size_t>(it->second) * 3;
+                            const double d2 = (p[0] - q[0]) * (p[0] - q[0]) + (p[1] - q[1]) * (p[1] - q[1]) +
+                                              (p[2] - q[2]) * (p[2] - q[2]);
+                            if (d2 > tol2) continue;
+                            if (nrm) {
+                                const float* a = nrm + i * 3;
+                                const float* b = nrm + static_cast<size_t>(it->second) * 3;
+                                if (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] < kWeldCreaseCos) continue;
+                            }
+                            best = it->second;
+                        }
+                    }
+                }
+            }
+            rep[i] = best;
+        }
+    });
+
+    // 3. 代表节点依次编号（rep[i] <= i，按顺序处理时 rep[i] 已是最终编号）
+    std::vector<WeldIndex> newIndex(n);
+    std::vector<double> welded;
+    std::vector<float> weldedNormals;
+    welded.reserve(mesh.points.size());
+    weldedNormals.reserve(nrm ? mesh.normals.size() : 0);
+    WeldIndex next = 0;
+    for (vtkIdType i = 0; i < n; ++i) {
+        if (rep[i] == i) {
+            newIndex[i] = next++;
+            welded.insert(welded.end(), pts + i * 3, pts + i * 3 + 3);
+            if (nrm) weldedNormals.insert(weldedNormals.end(), nrm + i * 3, nrm + i * 3 + 3);
+        } else {
+            newIndex[i] = newIndex[rep[i]];
+        }
+    }
+    mesh.points.swap(welded);
+    mesh.normals.swap(weldedNormals);
+
+    // 4. 重排三角形索引并删除退化三角形
+    const vtkIdType numTriangles = static_cast<vtkIdType>(mesh.faceIds.size());
+    vtkSMPTools::For(0, numTriangles * 3, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType k = begin; k < end; ++k) {
+            mesh.triangles[k] = newIndex[mesh.triangles[k]];
+        }
+    });
+    vtkIdType kept = 0;
+    for (vtkIdType t = 0; t < numTriangles; ++t) {
+        const WeldIndex* tri = &mesh.triangles[t * 3];
+        if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) continue;
+        std::copy(tri, tri + 3, &mesh.triangles[kept * 3]);
+        mesh.faceIds[kept++] = mesh.faceIds[t];
+    }
+    mesh.triangles.resize(kept * 3);
+    mesh.faceIds.resize(kept);
+}
+
+//转为 VTK PolyData：连接关系用 32 位存储，三角形所属面序号存为单元数据 FaceId，节点法向存为单精度点法向
+static vtkSmartPointer<vtkPolyData> WeldedMeshToPolyData(const WeldedMesh& mesh)
+{
+    const vtkIdType numPoints = static_cast<vtkIdType>(mesh.points.size() / 3);
+    const vtkIdType numTriangles = static_cast<vtkIdType>(mesh.faceIds.size());
+
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(numPoints);
+    std::copy(mesh.points.begin(), mesh.points.end(), static_cast<double*>(points->GetVoidPointer(0)));
+
+    vtkSmartPointer<vtkTypeInt32Array> connectivity = vtkSmartPointer<vtkTypeInt32Array>::New();
+    connectivity->SetNumberOfValues(numTriangles * 3);
+    std::copy(mesh.triangles.begin(), mesh.triangles.end(), connectivity->GetPointer(0));
+    vtkSmartPointer<vtkCellArray> triangles = vtkSmartPointer<vtkCellArray>::New();
+    triangles->SetData(3, connectivity);
+
+    vtkSmartPointer<vtkIntArray> faceIds = vtkSmartPointer<vtkIntArray>::New();
+    faceIds->SetName("FaceId");
+    faceIds->SetNumberOfValues(numTriangles);
+    std::copy(mesh.faceIds.begin(), mesh.faceIds.end(), faceIds->GetPointer(0));
+
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetPolys(triangles);
+    polyData->GetCellData()->AddArray(faceIds);
+
+    if (mesh.normals.size() == mesh.points.size()) {
+        vtkSmartPointer<vtkFloatArray> normals = vtkSmartPointer<vtkFloatArray>::New();
+        normals->SetName("Normals");
+        normals->SetNumberOfComponents(3);
+        normals->SetNumberOfTuples(numPoints);
+        std::copy(mesh.normals.begin(), mesh.normals.end(), normals->GetPointer(0));
+        polyData->GetPointData()->SetNormals(normals);
+    }
+    return polyData;
+}
+
+//已三角化的形状 -> 共享顶点的 PolyData，faces 返回 FaceId 对应的 OCC 面
+static vtkSmartPointer<vtkPolyData> WeldedPolyDataFromShape(const TopoDS_Shape& shape, std::vector<TopoDS_Face>* faces = nullptr)
+{
+    WeldedMesh mesh;
+    CollectFaceTriangulations(shape, mesh);
+    const size_t rawPoints = mesh.points.size() / 3;
+    WeldVertices(mesh);
+    qDebug() << "顶点合并:" << rawPoints << "->" << mesh.points.size() / 3 << "个顶点," << mesh.faceIds.size() << "个三角形";
+    vtkSmartPointer<vtkPolyData> polyData = WeldedMeshToPolyData(mesh);
+    if (faces) *faces = std::move(mesh.faces);
+    return polyData;
+}
+
+//----------内存预算----------|
+//各子系统的占用每次从现有数据结构统计，不单独记账，因此不会与实际状态脱节；
+//只有最近使用时间单独记录。超出预算时按最久未用的顺序淘汰可重建的项：
+//结果帧（需要时按路径重新读取）、隐藏的场景图层（视图按钮重新三角化）、弯管部件缓存（建模时缓存未命中即重建）
+//和节点时程数据（下次探针时重新转置）
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDialog>
+#include <QFormLayout>
+#include <QSpinBox>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+static const QString kMemResultFrames = "结果帧";
+static const QString kMemSceneLayers = "场景图层";
+static const QString kMemElbowCache = "弯管部件缓存";
+static const QString kMemShapes = "OCC 形状三角化";
+static const QString kMemHexMesh = "六面体网格";
+static const QString kMemNodeHistory = "节点时程";
+
+// 视图按钮可以重新生成的图层
+static bool IsRebuildableLayer(const QString& layer)
+{
+    return layer == "original" || layer == "surface" || layer == "centerline" || layer == "mesh" || layer == "results";
+}
+
+// 形状中各面三角化的字节数（节点、UV 和三角形）
+static size_t ShapeTriangulationBytes(const TopoDS_Shape& shape)
+{
+    if (shape.IsNull()) return 0;
+    size_t bytes = 0;
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) tri = BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), loc);
+        if (tri.IsNull()) continue;
+        bytes += static_cast<size_t>(tri->NbNodes()) * (tri->HasUVNodes() ? 5 : 3) * sizeof(double);
+        bytes += static_cast<size_t>(tri->NbTriangles()) * 3 * sizeof(int);
+    }
+    return bytes;
+}
+
+// vtkActor 输入数据的字节数
+static size_t PropBytes(vtkProp* prop)
+{
+    vtkActor* actor = vtkActor::SafeDownCast(prop);
+    if (!actor || !actor->GetMapper()) return 0;
+    vtkDataSet* data = actor->GetMapper()->GetInputAsDataSet();
+    return data ? static_cast<size_t>(data->GetActualMemorySize()) * 1024 : 0;
+}
+
+//记录一项被使用，稍后检查预算
+void MainWindow::TouchMemory(const QString& subsystem, const QString& key)
+{
+    m_memoryLastUse[subsystem + "|" + key] = ++m_memoryTick;
+    if (m_memoryTimer && !m_memoryTimer->isActive()) {
+        m_memoryTimer->start();
+    }
+}
+
+//按子系统统计当前占用
+std::vector<MemoryEntry> MainWindow::CollectMemoryEntries() const
+{
+    std::vector<MemoryEntry> entries;
+    auto add = [&](const QString& subsystem, const QString& key, size_t bytes, bool evictable) {
+        if (bytes == 0) return;
+        MemoryEntry e;
+        e.subsystem = subsystem;
+        e.key = key;
+        e.bytes = bytes;
+        e.evictable = evictable;
+        auto it = m_memoryLastUse.find(subsystem + "|" + key);
+        e.lastUse = it != m_memoryLastUse.end() ? it->second : 0;
+        entries.push_back(e);
+    };
+
+    // 结果视图正在显示时其 Actor 引用着各帧网格，淘汰也释放不了
+    const bool resultsShown = m_visibleLayers.contains("results") && m_sceneLayers.count("results");
+    for (const auto& frame : m_resultFrames) {
+        if (frame.grid) add(kMemResultFrames, frame.filePath, frame.ByteSize(), !resultsShown);
+    }
+    for (const auto& layer : m_sceneLayers) {
+        size_t bytes = 0;
+        for (const auto& prop : layer.second) bytes += PropBytes(prop);
+        add(kMemSceneLayers, layer.first, bytes, !m_visibleLayers.contains(layer.first) && IsRebuildableLayer(layer.first));
+    }
+    for (const auto& component : m_elbowCache) {
+        const size_t bytes = component.second.polyData ? static_cast<size_t>(component.second.polyData->GetActualMemorySize()) * 1024 : 0;
+        add(kMemElbowCache, component.first, bytes, !m_sceneLayers.count("elbow"));
+    }
+    size_t historyBytes = 0;
+    for (const auto& field : m_nodeHistory) historyBytes += field.values.size() * sizeof(float);
+    add(kMemNodeHistory, "探针", historyBytes, true);
+    add(kMemShapes, "当前模型", ShapeTriangulationBytes(m_currentShape), false);
+    if (!m_meshedShape.IsSame(m_currentShape)) {
+        add(kMemShapes, "网格模型", ShapeTriangulationBytes(m_meshedShape), false);
+    }
+    add(kMemHexMesh, "管体", m_tubeHexMesh.points.size() * sizeof(double) + m_tubeHexMesh.cells.size() * sizeof(vtkIdType) +
+                                m_tubeHexMesh.segmentOfCell.size() * sizeof(int), false);
+    return entries;
+}
+
+//淘汰一项，返回是否确实释放
+bool MainWindow::EvictMemoryEntry(const MemoryEntry& entry)
+{
+    if (entry.subsystem == kMemResultFrames) {
+        const int i = FindResultFrame(entry.key);
+        if (i < 0) return false;
+        // 隐藏的结果图层引用着帧网格，一并丢弃（显示结果时重建）
+        ClearSceneLayer("results");
+        ResultFrame& frame = m_resultFrames[i];
+        frame.grid = nullptr;
+        std::vector<ResultField>().swap(frame.fields);
+        frame.boundBytes = 0;
+    } else if (entry.subsystem == kMemSceneLayers) {
+        ClearSceneLayer(entry.key);
+    } else if (entry.subsystem == kMemElbowCache) {
+        m_elbowCache.erase(entry.key);
+    } else if (entry.subsystem == kMemNodeHistory) {
+        std::vector<NodeHistoryField>().swap(m_nodeHistory);
+        m_nodeHistoryKey.clear();
+    } else {
+        return false;
+    }
+    m_memoryLastUse.erase(entry.subsystem + "|" + entry.key);
+    qDebug() << "内存预算: 淘汰" << entry.subsystem << entry.key << entry.bytes / (1024.0 * 1024.0) << "MB";
+    return true;
+}
+
+//超出预算时按最久未用顺序淘汰
+void MainWindow::EnforceMemoryBudget()
+{
+    std::vector<MemoryEntry> entries = CollectMemoryEntries();
+    size_t total = 0;
+    for (const auto& e : entries) total += e.bytes;
+    const size_t budget = static_cast<size_t>(m_memoryBudgetMB) * 1024 * 1024;
+    if (total > budget) {
+        std::sort(entries.begin(), entries.end(),
+                  [](const MemoryEntry& a, const MemoryEntry& b) { return a.lastUse < b.lastUse; });
+        for (const auto& e : entries) {
+            if (total <= budget) break;
+            if (e.evictable && EvictMemoryEntry(e)) total -= e.bytes;
+        }
+        if (total > budget) {
+            qDebug() << "内存预算: 可淘汰项已用完，仍占用" << total / (1024 * 1024) << "MB";
+        }
+    }
+    RefreshMemoryPanel();
+}
+
+//被淘汰的结果帧按路径重新读取
+bool MainWindow::EnsureResultFrameLoaded(ResultFrame& frame)
+{
+    if (frame.grid) {
+        TouchMemory(kMemResultFrames, frame.filePath);
+        return true;
+    }
+    ResultFrame reloaded;
+    if (!m_resultReader.LoadResultFrame(frame.filePath, reloaded)) {
+        return false;
+    }
+    frame = std::move(reloaded);
+    TouchMemory(kMemResultFrames, frame.filePath);
+    return true;
+}
+
+//内存面板：各子系统占用、可回收量和预算
+void MainWindow::onMemoryPanelClicked()
+{
+    if (!m_memoryPanel) {
+        m_memoryPanel = new QDialog(this);
+        m_memoryPanel->setWindowTitle("内存占用");
+        m_memoryPanel->setAttribute(Qt::WA_DeleteOnClose);
+        QVBoxLayout* layout = new QVBoxLayout(m_memoryPanel);
+
+        m_memoryTable = new QTableWidget(0, 4, m_memoryPanel);
+        m_memoryTable->setHorizontalHeaderLabels({"子系统", "项数", "占用 (MB)", "可回收 (MB)"});
+        m_memoryTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        m_memoryTable->verticalHeader()->setVisible(false);
+        m_memoryTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        m_memoryTable->setMinimumSize(460, 220);
+        layout->addWidget(m_memoryTable);
+
+        QFormLayout* form = new QFormLayout();
+        QSpinBox* budgetSpin = new QSpinBox(m_memoryPanel);
+        budgetSpin->setRange(64, 1024 * 1024);
+        budgetSpin->setSingleStep(256);
+        budgetSpin->setSuffix(" MB");
+        budgetSpin->setValue(static_cast<int>(m_memoryBudgetMB));
+        form->addRow("内存预算:", budgetSpin);
+        layout->addLayout(form);
+        connect(budgetSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int mb) {
+            m_memoryBudgetMB = mb;
+            m_memoryTimer->start();
+        });
+
+        QPushButton* enforceButton = new QPushButton("按预算回收", m_memoryPanel);
+        layout->addWidget(enforceButton);
+        connect(enforceButton, &QPushButton::clicked, this, &MainWindow::EnforceMemoryBudget);
+
+        // 面板打开期间定时刷新
+        QTimer* refreshTimer = new QTimer(m_memoryPanel);
+        refreshTimer->setInterval(1000);
+        connect(refreshTimer, &QTimer::timeout, this, &MainWindow::RefreshMemoryPanel);
+        refreshTimer->start();
+    }
+    RefreshMemoryPanel();
+    m_memoryPanel->show();
+    m_memoryPanel->raise();
+}
+
+void MainWindow::RefreshMemoryPanel()
+{
+    if (!m_memoryPanel) return;
+    struct Row { int count = 0; size_t bytes = 0, evictable = 0; };
+    std::map<QString, Row> rows;
+    Row total;
+    for (const auto& e : CollectMemoryEntries()) {
+        for (Row* r : {&rows[e.subsystem], &total}) {
+            r->count++;
+            r->bytes += e.bytes;
+            if (e.evictable) r->evictable += e.bytes;
+        }
+    }
+
+    const double mb = 1024.0 * 1024.0;
+    m_memoryTable->setRowCount(static_cast<int>(rows.size()) + 1);
+    int row = 0;
+    auto setRow = [&](const QString& name, const Row& r) {
+        m_memoryTable->setItem(row, 0, new QTableWidgetItem(name));
+        m_memoryTable->setItem(row, 1, new QTableWidgetItem(QString::number(r.count)));
+        m_memoryTable->setItem(row, 2, new QTableWidgetItem(QString::number(r.bytes / mb, 'f', 1)));
+        m_memoryTable->setItem(row, 3, new QTableWidgetItem(QString::number(r.evictable / mb, 'f', 1)));
+        row++;
+    };
+    for (const auto& r : rows) setRow(r.first, r.second);
+    setRow(QString("合计 / 预算 %1 MB").arg(m_memoryBudgetMB), total);
+}
+
 //-----------参数化建模模块----------|
 // 添加必要的VTK头文件
 #include <vtkLight.h>
@@ -80,8 +699,14 @@ MainWindow::~MainWindow()
 #include <gp_Dir.hxx>
 #include <gp_Ax1.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
+#include <TopTools_ListOfShape.hxx>
 // 在包含完 OpenCASCADE 头文件之后，恢复警告设置
 #pragma GCC diagnostic pop
+#include <QElapsedTimer>
+#include <Standard_Failure.hxx>
+#include <future>
+#include <memory>
+#include <chrono>
 
 
 // 辅助函数,将OCC形状转换为VTK PolyData
@@ -94,50 +719,8 @@ vtkSmartPointer<vtkPolyData> MainWindow::ConvertOCCShapeToVTKPolyData(const Topo
         throw std::runtime_error("网格生成失败！");
     }
 
-    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-    vtkSmartPointer<vtkCellArray> triangles = vtkSmartPointer<vtkCellArray>::New();
-    int pointIdOffset = 0;
-
-    // 遍历所有面并提取三角网格
-    for (TopExp_Explorer faceExp(shape, TopAbs_FACE); faceExp.More(); faceExp.Next()) {
-        TopoDS_Face face = TopoDS::Face(faceExp.Current());
-        TopLoc_Location loc;
-        Handle(Poly_Triangulation) triFace = BRep_Tool::Triangulation(face, loc);
-
-        if (!triFace.IsNull()) {
-            // 添加顶点
-            for (Standard_Integer i = 1; i <= triFace->NbNodes(); i++) {
-                gp_Pnt p = triFace->Node(i);
-                if (!loc.IsIdentity()) {
-                    p.Transform(loc.Transformation());
-                }
-                points->InsertNextPoint(p.X(), p.Y(), p.Z());
-            }
-
-            // 添加三角形
-            for (Standard_Integer i = 1; i <= triFace->NbTriangles(); i++) {
-                Poly_Triangle tri = triFace->Triangle(i);
-                Standard_Integer n1, n2, n3;
-                tri.Get(n1, n2, n3);
-
-                vtkIdType ids[3] = {
-                    n1 - 1 + pointIdOffset,
-                    n2 - 1 + pointIdOffset,
-                    n3 - 1 + pointIdOffset
-                };
-                triangles->InsertNextCell(3, ids);
-            }
-
-            pointIdOffset += triFace->NbNodes();
-        }
-    }
-
-    // 构建VTK PolyData
-    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
-    polyData->SetPoints(points);
-    polyData->SetPolys(triangles);
-
-    return polyData;
+    // 提取各面三角网格并合并公共边上的重复顶点
+    return WeldedPolyDataFromShape(shape);
 }
 
 // 修改CreateVTKActor函数，移除网格显示，使用实体颜色
@@ -167,271 +750,538 @@ vtkSmartPointer<vtkActor> MainWindow::CreateVTKActor(vtkSmartPointer<vtkPolyData
     return actor;
 }
 
-//建模函数
-void MainWindow::MakeElbowModel(
-    double tube_outer_radius, double tube_inner_radius, double tube_length,
-    double rotary_sleeve_thickness, double rotary_sleeve_length, double rotary_sleeve_pos,
-    double fixed_sleeve_thickness, double fixed_sleeve_length, double fixed_sleeve_pos,
-    double arc_radius, double arc_thickness, double arc_angle_rad) {
-
-    const double tolerance = 1E-3;
-    const double mesh_precision = 1.0;
-
-    try {
-        // 检查目标区域是否存在
-        if (!ui->mdiArea) {
-            QMessageBox::warning(this, "警告", "显示区域未找到！");
-            return;
-        }
-
-        // 清理区域中的现有内容
-        QLayout* layout = ui->mdiArea->layout();
-        if (layout) {
-            QLayoutItem* item;
-            while ((item = layout->takeAt(0)) != nullptr) {
-                if (item->widget()) {
-                    item->widget()->setParent(nullptr);
-                }
-                delete item;
-            }
-        } else {
-            // 如果没有布局，创建新的布局
-            layout = new QVBoxLayout(ui->mdiArea);
-            ui->mdiArea->setLayout(layout);
-        }
-
-        // Tube (管体) 参数
-        struct tube_param {
-            double R_out, R_in, length;
-        } tp = {tube_outer_radius, tube_inner_radius, tube_length};
-
-        // Rotary Sleeve (旋转套) 参数
-        struct rotary_sleeve_param {
-            double thickness, length, position;
-            double R_out, R_in, ref[3], rot[3];
-        } rsp = {rotary_sleeve_thickness, rotary_sleeve_length, rotary_sleeve_pos, 0.0, 0.0, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
-
-        // Fixed Sleeve (固定套) 参数
-        struct fixed_sleeve_param {
-            double thickness, length, position;
-            double R_out, R_in, ref[3], rot[3];
-        } fsp = {fixed_sleeve_thickness, fixed_sleeve_length, fixed_sleeve_pos, 0.0, 0.0, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
-
-        // Semi-circular Sleeve (半圆弧套) 参数
-        struct semi_circular_sleeve_param {
-            double R, thickness, angle, position, R_out, R_in, ref[3], rot[3];
-        } scsp = {arc_radius, arc_thickness, arc_angle_rad, 0.0, 0.0, 0.0, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
-
-        rsp.position = tp.length - rsp.position;
-        rsp.R_in     = tp.R_out + tolerance;
-        rsp.R_out    = rsp.R_in + rsp.thickness;
-
-        rsp.ref[0] = rsp.position + rsp.length/2;
-
-        fsp.position = tp.length - fsp.position;
-        fsp.R_in     = tp.R_out + tolerance;
-        fsp.R_out    = rsp.R_in + rsp.thickness;
-
-        // ref node
-        fsp.ref[0] = fsp.position + fsp.length / 2;
-        fsp.rot[0] = fsp.position + fsp.length / 2;
-
-        // generate arc
-        scsp.position = rsp.position - tolerance;
-        scsp.R_in     = tp.R_out + tolerance;
-        scsp.R_out    = scsp.R_in + scsp.thickness;
-
-        // rot node
-        scsp.rot[0] = scsp.position;
-        scsp.rot[1] = -scsp.R;
-        std::copy(scsp.rot, scsp.rot+3, scsp.ref);
-        std::copy(scsp.rot, scsp.rot+3, rsp.rot);
-
-        // ========== 写入 rigidbody.info ==========
-        //路径问题解决
-        QString appDirPath = QCoreApplication::applicationDirPath();
-        QDir dir(appDirPath);
-        dir.cdUp();
-        dir.cdUp();
-        QString parentDirPath = dir.absolutePath();
-        qDebug() << "" << parentDirPath;
-
-        QString filename = parentDirPath + "/Profile/rigidbody.info";
-        QFile file(filename);
-        if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            QTextStream out(&file);
-            out << "---\n";
-            out << "Volume2:\n";
-
-            out << "  ref: (" << scsp.ref[0] << "," << scsp.ref[1] << "," << scsp.ref[2] << ")\n";
-            out << "  rot: (" << scsp.rot[0] << "," << scsp.rot[1] << "," << scsp.rot[2] << ")\n";
-
-            out << "Volume3:\n";
-            out << "  ref: (" << rsp.ref[0] << "," << rsp.ref[1] << "," << rsp.ref[2] << ")\n";
-            out << "  rot: (" << rsp.rot[0] << "," << rsp.rot[1] << "," << rsp.rot[2] << ")\n";
-
-            out << "Volume4:\n";
-            out << "  ref: (" << fsp.ref[0] << "," << fsp.ref[1] << "," << fsp.ref[2] << ")\n";
-            out << "  rot: (" << fsp.rot[0] << "," << fsp.rot[1] << "," << fsp.rot[2] << ")\n";
-            file.close();
-            qDebug() << "参考点写入 rigidbody.info 成功。";
-        } else {
-            qDebug() << "无法写入 rigidbody.info 文件！";
-        }
+//带缓存的部件构建：参数键相同的形状和三角化结果直接复用
+const ElbowComponent& MainWindow::CachedElbowComponent(const QString& key, double deflection,
+                                                      const std::function<TopoDS_Shape()>& build)
+{
+    m_elbowCacheUsed.insert(key);
+    TouchMemory(kMemElbowCache, key);
+    auto it = m_elbowCache.find(key);
+    if (it != m_elbowCache.end()) {
+        return it->second;
+    }
 
-        // 创建VTK渲染部件
-        QVTKOpenGLNativeWidget *vtkWidget = new QVTKOpenGLNativeWidget(ui->mdiArea);
-        vtkWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    ElbowComponent component;
+    component.shape = build();
+    if (deflection > 0) {
+        component.polyData = ConvertOCCShapeToVTKPolyData(component.shape, deflection);
+    }
+    return m_elbowCache.emplace(key, component).first->second;
+}
 
-        // 创建渲染器
-        vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
-        renderer->SetBackground(1,1,1); // 背景
+// 布尔差运算，开启 OCC 的并行模式
+static TopoDS_Shape ParallelCut(const TopoDS_Shape& object, const TopoDS_Shape& tool)
+{
+    TopTools_ListOfShape arguments, tools;
+    arguments.Append(object);
+    tools.Append(tool);
+    BRepAlgoAPI_Cut cut;
+    cut.SetArguments(arguments);
+    cut.SetTools(tools);
+    cut.SetRunParallel(Standard_True);
+    cut.Build();
+    if (!cut.IsDone()) {
+        throw std::runtime_error("布尔运算失败！");
+    }
+    return cut.Shape();
+}
 
-        // 创建渲染窗口
-        vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow =
-            vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
-        vtkWidget->setRenderWindow(renderWindow);
-        renderWindow->AddRenderer(renderer);
+static QString ElbowCacheKey(const char* name, std::initializer_list<double> values)
+{
+    QString key = name;
+    for (double v : values) {
+        key += "/" + QString::number(v, 'g', 12);
+    }
+    return key;
+}
 
-        qDebug() << "开始创建弯管模型...";
+//构建弯管各部件并写入 rigidbody.info，返回管体、旋转套筒、固定套筒、圆弧段。
+//四个部件互不依赖，缓存未命中的部件各在一个线程中同时建模、布尔运算和三角化。
+//不给 onReady 时阻塞到全部完成；给出时立即返回（未完成的部件为空），缓存命中的部件当场回调，
+//其余部件完成后由事件循环在 GUI 线程中逐个回调，界面在建模期间保持响应
+std::vector<const ElbowComponent*> MainWindow::BuildElbowComponents(
+    const ElbowParameters& p, const std::function<void(size_t, const ElbowComponent&)>& onReady)
+{
+    const double tolerance = 1E-3;
+    const double mesh_precision = 1.0;
 
-        // 定义统一的颜色（金属灰色）
-        double metal_gray_r = 0.7;
-        double metal_gray_g = 0.7;
-        double metal_gray_b = 0.75;
+    const double tube_outer_radius = p.tube_outer_radius, tube_inner_radius = p.tube_inner_radius;
+    const double tube_length = p.tube_length;
+    const double rotary_sleeve_thickness = p.rotary_sleeve_thickness, rotary_sleeve_length = p.rotary_sleeve_length;
+    const double rotary_sleeve_pos = p.rotary_sleeve_pos;
+    const double fixed_sleeve_thickness = p.fixed_sleeve_thickness, fixed_sleeve_length = p.fixed_sleeve_length;
+    const double fixed_sleeve_pos = p.fixed_sleeve_pos;
+    const double arc_radius = p.arc_radius, arc_thickness = p.arc_thickness, arc_angle_rad = p.arc_angle_rad;
+
+    m_elbowCacheUsed.clear();
+
+    // Tube (管体) 参数
+    struct tube_param {
+        double R_out, R_in, length;
+    } tp = {tube_outer_radius, tube_inner_radius, tube_length};
+
+    // Rotary Sleeve (旋转套) 参数
+    struct rotary_sleeve_param {
+        double thickness, length, position;
+        double R_out, R_in, ref[3], rot[3];
+    } rsp = {rotary_sleeve_thickness, rotary_sleeve_length, rotary_sleeve_pos, 0.0, 0.0, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+
+    // Fixed Sleeve (固定套) 参数
+    struct fixed_sleeve_param {
+        double thickness, length, position;
+        double R_out, R_in, ref[3], rot[3];
+    } fsp = {fixed_sleeve_thickness, fixed_sleeve_length, fixed_sleeve_pos, 0.0, 0.0, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+
+    // Semi-circular Sleeve (半圆弧套) 参数
+    struct semi_circular_sleeve_param {
+        double R, thickness, angle, position, R_out, R_in, ref[3], rot[3];
+    } scsp = {arc_radius, arc_thickness, arc_angle_rad, 0.0, 0.0, 0.0, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+
+    rsp.position = tp.length - rsp.position;
+    rsp.R_in     = tp.R_out + tolerance;
+    rsp.R_out    = rsp.R_in + rsp.thickness;
+
+    rsp.ref[0] = rsp.position + rsp.length/2;
+
+    fsp.position = tp.length - fsp.position;
+    fsp.R_in     = tp.R_out + tolerance;
+    fsp.R_out    = rsp.R_in + rsp.thickness;
+
+    // ref node
+    fsp.ref[0] = fsp.position + fsp.length / 2;
+    fsp.rot[0] = fsp.position + fsp.length / 2;
+
+    // generate arc
+    scsp.position = rsp.position - tolerance;
+    scsp.R_in     = tp.R_out + tolerance;
+    scsp.R_out    = scsp.R_in + scsp.thickness;
+
+    // rot node
+    scsp.rot[0] = scsp.position;
+    scsp.rot[1] = -scsp.R;
+    std::copy(scsp.rot, scsp.rot+3, scsp.ref);
+    std::copy(scsp.rot, scsp.rot+3, rsp.rot);
+
+    // 参考点同时供 inp 生成使用，顺序与 rigidbody.info 中 Volume2/3/4 一致
+    m_rigidBodyRefs = {
+        {"ARC_SLEEVE", {scsp.ref[0], scsp.ref[1], scsp.ref[2]}, {scsp.rot[0], scsp.rot[1], scsp.rot[2]}},
+        {"ROTARY_SLEEVE", {rsp.ref[0], rsp.ref[1], rsp.ref[2]}, {rsp.rot[0], rsp.rot[1], rsp.rot[2]}},
+        {"FIXED_SLEEVE", {fsp.ref[0], fsp.ref[1], fsp.ref[2]}, {fsp.rot[0], fsp.rot[1], fsp.rot[2]}},
+    };
+
+    // ========== 写入 rigidbody.info ==========
+    //路径问题解决
+    QString appDirPath = QCoreApplication::applicationDirPath();
+    QDir dir(appDirPath);
+    dir.cdUp();
+    dir.cdUp();
+    QString parentDirPath = dir.absolutePath();
+    qDebug() << "" << parentDirPath;
+
+    QString filename = parentDirPath + "/Profile/rigidbody.info";
+    QFile file(filename);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream out(&file);
+        out << "---\n";
+        out << "Volume2:\n";
+
+        out << "  ref: (" << scsp.ref[0] << "," << scsp.ref[1] << "," << scsp.ref[2] << ")\n";
+        out << "  rot: (" << scsp.rot[0] << "," << scsp.rot[1] << "," << scsp.rot[2] << ")\n";
+
+        out << "Volume3:\n";
+        out << "  ref: (" << rsp.ref[0] << "," << rsp.ref[1] << "," << rsp.ref[2] << ")\n";
+        out << "  rot: (" << rsp.rot[0] << "," << rsp.rot[1] << "," << rsp.rot[2] << ")\n";
+
+        out << "Volume4:\n";
+        out << "  ref: (" << fsp.ref[0] << "," << fsp.ref[1] << "," << fsp.ref[2] << ")\n";
+        out << "  rot: (" << fsp.rot[0] << "," << fsp.rot[1] << "," << fsp.rot[2] << ")\n";
+        file.close();
+        qDebug() << "参考点写入 rigidbody.info 成功。";
+    } else {
+        qDebug() << "无法写入 rigidbody.info 文件！";
+    }
 
-        // 1. 创建管体
-        qDebug() << "创建管体...";
+    qDebug() << "开始创建弯管模型...";
+
+    // 部件任务：缓存键、三角化精度和建模函数（按值捕获，在工作线程中执行）
+    struct ComponentJob {
+        QString key;
+        double deflection;
+        std::function<TopoDS_Shape()> build;
+        const ElbowComponent* result = nullptr;
+        std::future<ElbowComponent> future;
+    };
+    std::vector<ComponentJob> jobs(4);
+
+    // 1. 创建管体
+    jobs[0].key = ElbowCacheKey("tube", {tube_outer_radius, tube_inner_radius, tube_length});
+    jobs[0].deflection = mesh_precision;
+    jobs[0].build = [=]() {
         gp_Ax2 tube_axis(gp_Pnt(0, 0, 0), gp_Dir(1, 0, 0));
         TopoDS_Shape outer_cylinder = BRepPrimAPI_MakeCylinder(tube_axis, tube_outer_radius, tube_length);
         TopoDS_Shape inner_cylinder = BRepPrimAPI_MakeCylinder(tube_axis, tube_inner_radius, tube_length);
-        TopoDS_Shape tube = BRepAlgoAPI_Cut(outer_cylinder, inner_cylinder);
+        return ParallelCut(outer_cylinder, inner_cylinder);
+    };
 
-        vtkSmartPointer<vtkPolyData> tubePolyData = ConvertOCCShapeToVTKPolyData(tube, mesh_precision);
-        vtkSmartPointer<vtkActor> tubeActor = CreateVTKActor(tubePolyData, metal_gray_r, metal_gray_g, metal_gray_b);
-        renderer->AddActor(tubeActor);
-
-        // 2. 创建旋转套筒
-        qDebug() << "创建旋转套筒...";
-        double rotary_pos_from_left = tube_length - rotary_sleeve_pos;
-        double rotary_inner_radius = tube_outer_radius + tolerance;
-        double rotary_outer_radius = rotary_inner_radius + rotary_sleeve_thickness;
+    // 2. 创建旋转套筒
+    double rotary_pos_from_left = tube_length - rotary_sleeve_pos;
+    double rotary_inner_radius = tube_outer_radius + tolerance;
+    double rotary_outer_radius = rotary_inner_radius + rotary_sleeve_thickness;
 
+    jobs[1].key = ElbowCacheKey("rotary", {rotary_pos_from_left, rotary_inner_radius, rotary_outer_radius, rotary_sleeve_length});
+    jobs[1].deflection = mesh_precision;
+    jobs[1].build = [=]() {
         gp_Ax2 rotary_axis(gp_Pnt(rotary_pos_from_left, 0, 0), gp_Dir(1, 0, 0));
         TopoDS_Shape rotary_inner = BRepPrimAPI_MakeCylinder(rotary_axis, rotary_inner_radius, rotary_sleeve_length);
         TopoDS_Shape rotary_outer = BRepPrimAPI_MakeCylinder(rotary_axis, rotary_outer_radius, rotary_sleeve_length);
-        TopoDS_Shape rotary_sleeve = BRepAlgoAPI_Cut(rotary_outer, rotary_inner);
-
-        vtkSmartPointer<vtkPolyData> rotaryPolyData = ConvertOCCShapeToVTKPolyData(rotary_sleeve, mesh_precision);
-        vtkSmartPointer<vtkActor> rotaryActor = CreateVTKActor(rotaryPolyData, metal_gray_r, metal_gray_g, metal_gray_b);
-        renderer->AddActor(rotaryActor);
+        return ParallelCut(rotary_outer, rotary_inner);
+    };
 
-        // 3. 创建固定套筒
-        qDebug() << "创建固定套筒...";
-        double fixed_pos_from_left = tube_length - fixed_sleeve_pos;
-        double fixed_inner_radius = tube_outer_radius + tolerance;
-        double fixed_outer_radius = fixed_inner_radius + fixed_sleeve_thickness;
+    // 3. 创建固定套筒
+    double fixed_pos_from_left = tube_length - fixed_sleeve_pos;
+    double fixed_inner_radius = tube_outer_radius + tolerance;
+    double fixed_outer_radius = fixed_inner_radius + fixed_sleeve_thickness;
 
+    jobs[2].key = ElbowCacheKey("fixed", {fixed_pos_from_left, fixed_inner_radius, fixed_outer_radius, fixed_sleeve_length});
+    jobs[2].deflection = mesh_precision;
+    jobs[2].build = [=]() {
         gp_Ax2 fixed_axis(gp_Pnt(fixed_pos_from_left, 0, 0), gp_Dir(1, 0, 0));
         TopoDS_Shape fixed_inner = BRepPrimAPI_MakeCylinder(fixed_axis, fixed_inner_radius, fixed_sleeve_length);
         TopoDS_Shape fixed_outer = BRepPrimAPI_MakeCylinder(fixed_axis, fixed_outer_radius, fixed_sleeve_length);
-        TopoDS_Shape fixed_sleeve = BRepAlgoAPI_Cut(fixed_outer, fixed_inner);
-
-        vtkSmartPointer<vtkPolyData> fixedPolyData = ConvertOCCShapeToVTKPolyData(fixed_sleeve, mesh_precision);
-        vtkSmartPointer<vtkActor> fixedActor = CreateVTKActor(fixedPolyData, metal_gray_r, metal_gray_g, metal_gray_b);
-        renderer->AddActor(fixedActor);
-
-        // 4. 创建圆弧段
-        qDebug() << "创建圆弧段...";
-        double arc_position = rotary_pos_from_left - tolerance;
-        double arc_inner_radius = tube_outer_radius + tolerance;
-        double arc_outer_radius = arc_inner_radius + arc_thickness;
-
-        // 创建圆弧截面
-        Handle(Geom_TrimmedCurve) inner_arc = GC_MakeArcOfCircle(
-            gp_Pnt(arc_position, 0, -arc_inner_radius),
-            gp_Pnt(arc_position, -arc_inner_radius, 0),
-            gp_Pnt(arc_position, 0, arc_inner_radius)
-            );
-
-        Handle(Geom_TrimmedCurve) outer_arc = GC_MakeArcOfCircle(
-            gp_Pnt(arc_position, 0, -arc_outer_radius),
-            gp_Pnt(arc_position, -arc_outer_radius, 0),
-            gp_Pnt(arc_position, 0, arc_outer_radius)
+        return ParallelCut(fixed_outer, fixed_inner);
+    };
+
+    // 4. 创建圆弧段
+    double arc_position = rotary_pos_from_left - tolerance;
+    double arc_inner_radius = tube_outer_radius + tolerance;
+    double arc_outer_radius = arc_inner_radius + arc_thickness;
+
+    // 截面只与位置和内外半径有关，补偿迭代中只改变角度和弯曲半径时可复用；截面构建很快，在调用线程中完成
+    const ElbowComponent& section = CachedElbowComponent(
+        ElbowCacheKey("arc_section", {arc_position, arc_inner_radius, arc_outer_radius}), 0.0, [&]() {
+            // 创建圆弧截面
+            Handle(Geom_TrimmedCurve) inner_arc = GC_MakeArcOfCircle(
+                gp_Pnt(arc_position, 0, -arc_inner_radius),
+                gp_Pnt(arc_position, -arc_inner_radius, 0),
+                gp_Pnt(arc_position, 0, arc_inner_radius)
+                );
+
+            Handle(Geom_TrimmedCurve) outer_arc = GC_MakeArcOfCircle(
+                gp_Pnt(arc_position, 0, -arc_outer_radius),
+                gp_Pnt(arc_position, -arc_outer_radius, 0),
+                gp_Pnt(arc_position, 0, arc_outer_radius)
+                );
+
+            // 创建连接边
+            TopoDS_Edge left_edge = BRepBuilderAPI_MakeEdge(
+                gp_Pnt(arc_position, 0, -arc_inner_radius),
+                gp_Pnt(arc_position, 0, -arc_outer_radius)
+                );
+
+            TopoDS_Edge right_edge = BRepBuilderAPI_MakeEdge(
+                gp_Pnt(arc_position, 0, arc_inner_radius),
+                gp_Pnt(arc_position, 0, arc_outer_radius)
+                );
+
+            // 创建截面线框
+            BRepBuilderAPI_MakeWire wire_builder;
+            wire_builder.Add(BRepBuilderAPI_MakeEdge(outer_arc));
+            wire_builder.Add(right_edge);
+            wire_builder.Add(BRepBuilderAPI_MakeEdge(inner_arc));
+            wire_builder.Add(left_edge);
+            TopoDS_Wire section_wire = wire_builder.Wire();
+
+            // 创建截面面
+            return TopoDS_Shape(BRepBuilderAPI_MakeFace(section_wire));
+        });
+
+    // 旋转生成圆弧段
+    const TopoDS_Shape section_shape = section.shape;
+    jobs[3].key = ElbowCacheKey("arc", {arc_position, arc_inner_radius, arc_outer_radius, arc_radius, arc_angle_rad});
+    jobs[3].deflection = mesh_precision * 0.5;
+    jobs[3].build = [=]() {
+        gp_Ax1 rotation_axis(
+            gp_Pnt(arc_position, -arc_radius, 0),
+            gp_Dir(0, 0, 1)
             );
+        return TopoDS_Shape(BRepPrimAPI_MakeRevol(section_shape, rotation_axis, arc_angle_rad));
+    };
 
-        // 创建连接边
-        TopoDS_Edge left_edge = BRepBuilderAPI_MakeEdge(
-            gp_Pnt(arc_position, 0, -arc_inner_radius),
-            gp_Pnt(arc_position, 0, -arc_outer_radius)
-            );
+    // 本次用到的缓存键；其余缓存项（旧的补偿迭代结果）直接淘汰
+    for (const ComponentJob& job : jobs) {
+        m_elbowCacheUsed.insert(job.key);
+    }
+    for (auto it = m_elbowCache.begin(); it != m_elbowCache.end();) {
+        if (!m_elbowCacheUsed.contains(it->first)) {
+            it = m_elbowCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
-        TopoDS_Edge right_edge = BRepBuilderAPI_MakeEdge(
-            gp_Pnt(arc_position, 0, arc_inner_radius),
-            gp_Pnt(arc_position, 0, arc_outer_radius)
-            );
+    // 缓存命中的部件立即可用
+    QElapsedTimer timer;
+    timer.start();
+    const char* names[4] = {"管体", "旋转套筒", "固定套筒", "圆弧段"};
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        ComponentJob& job = jobs[i];
+        TouchMemory(kMemElbowCache, job.key);
+        auto it = m_elbowCache.find(job.key);
+        if (it != m_elbowCache.end()) {
+            job.result = &it->second;
+            if (onReady) onReady(i, *job.result);
+        }
+    }
 
-        // 创建截面线框
-        BRepBuilderAPI_MakeWire wire_builder;
-        wire_builder.Add(BRepBuilderAPI_MakeEdge(outer_arc));
-        wire_builder.Add(right_edge);
-        wire_builder.Add(BRepBuilderAPI_MakeEdge(inner_arc));
-        wire_builder.Add(left_edge);
-        TopoDS_Wire section_wire = wire_builder.Wire();
+    auto buildComponent = [this](const std::function<TopoDS_Shape()>& build, double deflection) {
+        ElbowComponent component;
+        component.shape = build();
+        if (deflection > 0) {
+            component.polyData = ConvertOCCShapeToVTKPolyData(component.shape, deflection);
+        }
+        return component;
+    };
 
-        // 创建截面面
-        TopoDS_Face section_face = BRepBuilderAPI_MakeFace(section_wire);
+    if (!onReady) {
+        // 同步调用（生成 inp）：未命中的部件同时建模，按顺序阻塞等待，异常在 get() 时重新抛出
+        for (ComponentJob& job : jobs) {
+            if (!job.result) job.future = std::async(std::launch::async, buildComponent, job.build, job.deflection);
+        }
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            ComponentJob& job = jobs[i];
+            if (job.result) continue;
+            job.result = &m_elbowCache.emplace(job.key, job.future.get()).first->second;
+            qDebug() << "创建" << names[i] << "完成:" << timer.elapsed() << "ms";
+        }
+        return {jobs[0].result, jobs[1].result, jobs[2].result, jobs[3].result};
+    }
 
-        // 旋转生成圆弧段
-        gp_Ax1 rotation_axis(
-            gp_Pnt(arc_position, -arc_radius, 0),
-            gp_Dir(0, 0, 1)
-            );
-        TopoDS_Shape arc_sector = BRepPrimAPI_MakeRevol(section_face, rotation_axis, arc_angle_rad);
+    // 异步调用：未命中的部件各在 m_elbowPool 的一个线程中建模，完成后排队回到事件循环，
+    // 在 GUI 线程写入缓存并回调 onReady。再次建模后，上一次仍在运行的部件结果直接丢弃
+    const quint64 generation = ++m_elbowBuildGeneration;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const ComponentJob& job = jobs[i];
+        if (job.result) continue;
+        const QString key = job.key;
+        const QString name = names[i];
+        const std::function<TopoDS_Shape()> build = job.build;
+        const double deflection = job.deflection;
+        m_elbowPool.start([=]() {
+            auto component = std::make_shared<ElbowComponent>();
+            QString error;
+            try {
+                *component = buildComponent(build, deflection);
+            } catch (const std::exception& e) {
+                error = e.what();
+            } catch (const Standard_Failure& e) {
+                error = e.GetMessageString();
+            }
+            QMetaObject::invokeMethod(this, [=]() {
+                if (generation != m_elbowBuildGeneration) return;
+                if (!error.isEmpty()) {
+                    qDebug() << "错误:" << error;
+                    QMessageBox::critical(this, "错误", QString("%1创建失败: %2").arg(name, error));
+                    return;
+                }
+                const ElbowComponent& stored = m_elbowCache.emplace(key, std::move(*component)).first->second;
+                TouchMemory(kMemElbowCache, key);
+                qDebug() << "创建" << name << "完成:" << timer.elapsed() << "ms";
+                onReady(i, stored);
+            }, Qt::QueuedConnection);
+        });
+    }
+    return {jobs[0].result, jobs[1].result, jobs[2].result, jobs[3].result};
+}
 
-        vtkSmartPointer<vtkPolyData> arcPolyData = ConvertOCCShapeToVTKPolyData(arc_sector, mesh_precision * 0.5);
-        vtkSmartPointer<vtkActor> arcActor = CreateVTKActor(arcPolyData, metal_gray_r, metal_gray_g, metal_gray_b);
-        renderer->AddActor(arcActor);
+//建模函数
+void MainWindow::MakeElbowModel(
+    double tube_outer_radius, double tube_inner_radius, double tube_length,
+    double rotary_sleeve_thickness, double rotary_sleeve_length, double rotary_sleeve_pos,
+    double fixed_sleeve_thickness, double fixed_sleeve_length, double fixed_sleeve_pos,
+    double arc_radius, double arc_thickness, double arc_angle_rad) {
 
-        // 5. 写入参考点信息
+    try {
+        // 检查目标区域是否存在
+        if (!ui->mdiArea) {
+            QMessageBox::warning(this, "警告", "显示区域未找到！");
+            return;
+        }
 
-        // 6. 设置相机并渲染
-        renderer->ResetCamera();
+        ElbowParameters params = {
+            tube_outer_radius, tube_inner_radius, tube_length,
+            rotary_sleeve_thickness, rotary_sleeve_length, rotary_sleeve_pos,
+            fixed_sleeve_thickness, fixed_sleeve_length, fixed_sleeve_pos,
+            arc_radius, arc_thickness, arc_angle_rad};
+        m_elbowParameters = params;
 
-        // 7. 将VTK部件添加到布局中
-        layout->addWidget(vtkWidget);
+        // 定义统一的颜色（金属灰色）
+        double metal_gray_r = 0.7;
+        double metal_gray_g = 0.7;
+        double metal_gray_b = 0.75;
 
-        // 8. 强制刷新布局和渲染
-        ui->mdiArea->layout()->activate();
-        renderWindow->Render();
+        // 1. 清空弯管图层并只显示该图层
+        SetSceneLayer("elbow", {});
+        ShowSceneLayers({"elbow"}, false);
 
-        // 9. 添加交互器
-        vtkSmartPointer<vtkRenderWindowInteractor> interactor = renderWindow->GetInteractor();
-        vtkSmartPointer<vtkInteractorStyleTrackballCamera> style =
-            vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
-        interactor->SetInteractorStyle(style);
+        // 2-5. 并行创建管体、旋转套筒、固定套筒、圆弧段（参数未变的部件直接复用缓存），
+        // 每完成一个由事件循环回调显示
+        BuildElbowComponents(params, [=](size_t, const ElbowComponent& component) {
+            AddToSceneLayer("elbow", CreateVTKActor(component.polyData, metal_gray_r, metal_gray_g, metal_gray_b));
+            m_viewRenderer->ResetCamera();
+            m_viewWindow->Render();
+        });
 
-        qDebug() << "模型创建完成，已全屏显示在指定区域中";
+        qDebug() << "模型创建已开始，部件完成后逐个显示";
     } catch (const std::exception& e) {
         qDebug() << "错误:" << e.what();
         QMessageBox::critical(this, "错误", QString("模型创建失败: %1").arg(e.what()));
     }
 }
 
-//显示函数
-void MainWindow::ShowModelInMdiArea(vtkSmartPointer<vtkRenderer> renderer) {
-    try {
-        // 清空MDI区域的所有子窗口
-        ui->mdiArea->closeAllSubWindows();
-
-        // 创建VTK部件
-        QVTKOpenGLNativeWidget *vtkWidget = new QVTKOpenGLNativeWidget();
-        vtkWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+//----------场景视图----------|
+//显示区只保留一个长期存在的渲染窗口，各显示函数只替换自己图层中的 Actor，
+//视图按钮只切换图层可见性和相机，隐藏图层的 GPU 缓冲保留，再次显示时无需重新上传
+#include <vtkCallbackCommand.h>
 
-        // 创建渲染窗口
-        vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow =
-            vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
-        vtkWidget->setRenderWindow(renderWindow);
+//在显示区只显示 widget：场景视图隐藏保留，其他临时部件（如曲线图）删除
+void MainWindow::ShowInViewArea(QWidget* widget)
+{
+    QLayout* layout = ui->mdiArea->layout();
+    if (!layout) {
+        layout = new QVBoxLayout(ui->mdiArea);
+        ui->mdiArea->setLayout(layout);
+    }
+    for (int i = layout->count() - 1; i >= 0; --i) {
+        QWidget* w = layout->itemAt(i)->widget();
+        if (w == widget) continue;
+        if (w && w == m_viewWidget) {
+            w->hide();
+            continue;
+        }
+        QLayoutItem* item = layout->takeAt(i);
+        if (w) {
+            w->setParent(nullptr);
+            delete w;
+        }
+        delete item;
+    }
+    if (layout->indexOf(widget) < 0) {
+        layout->addWidget(widget);
+    }
+    widget->show();
+}
+
+//创建场景视图（仅第一次），显示由 ShowSceneLayers 负责
+vtkRenderer* MainWindow::EnsureSceneView()
+{
+    if (!m_viewWidget) {
+        m_viewWidget = new QVTKOpenGLNativeWidget(ui->mdiArea);
+        m_viewWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+        m_viewWindow = vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
+        m_viewWidget->setRenderWindow(m_viewWindow);
+        m_viewRenderer = vtkSmartPointer<vtkRenderer>::New();
+        m_viewRenderer->SetBackground(1, 1, 1);
+        m_viewWindow->AddRenderer(m_viewRenderer);
+
+        // 交互器和拾取回调只设置一次
+        vtkSmartPointer<vtkRenderWindowInteractor> interactor = m_viewWindow->GetInteractor();
+        vtkSmartPointer<vtkInteractorStyleTrackballCamera> style =
+            vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
+        interactor->SetInteractorStyle(style);
+
+        vtkSmartPointer<vtkCallbackCommand> clickCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+        clickCallback->SetCallback(OnLeftButtonDown);
+        clickCallback->SetClientData(this);
+        interactor->AddObserver(vtkCommand::LeftButtonPressEvent, clickCallback);
+    }
+    return m_viewRenderer;
+}
+
+//替换图层内容，新 Actor 的可见性跟随图层当前是否显示
+void MainWindow::SetSceneLayer(const QString& layer, const std::vector<vtkSmartPointer<vtkProp>>& props)
+{
+    EnsureSceneView();
+    ClearSceneLayer(layer);
+    std::vector<vtkSmartPointer<vtkProp>>& target = m_sceneLayers[layer];
+    for (const auto& prop : props) {
+        prop->SetVisibility(m_visibleLayers.contains(layer));
+        m_viewRenderer->AddViewProp(prop);
+        target.push_back(prop);
+    }
+}
+
+void MainWindow::AddToSceneLayer(const QString& layer, vtkProp* prop)
+{
+    EnsureSceneView();
+    prop->SetVisibility(m_visibleLayers.contains(layer));
+    m_viewRenderer->AddViewProp(prop);
+    m_sceneLayers[layer].push_back(prop);
+}
+
+//移除图层（及其 Actor）
+void MainWindow::ClearSceneLayer(const QString& layer)
+{
+    auto it = m_sceneLayers.find(layer);
+    if (it == m_sceneLayers.end()) return;
+    for (const auto& prop : it->second) {
+        m_viewRenderer->RemoveViewProp(prop);
+    }
+    m_sceneLayers.erase(it);
+    m_layerFaces.erase(layer);
+}
+
+bool MainWindow::HasSceneLayer(const QString& layer) const
+{
+    auto it = m_sceneLayers.find(layer);
+    return it != m_sceneLayers.end() && !it->second.empty();
+}
+
+//只显示给定图层，可选地让相机适配可见图层
+void MainWindow::ShowSceneLayers(const QStringList& layers, bool resetCamera)
+{
+    EnsureSceneView();
+    ClearCompareView();
+    ShowInViewArea(m_viewWidget);
+    m_visibleLayers = layers;
+    for (auto& entry : m_sceneLayers) {
+        const bool visible = layers.contains(entry.first);
+        if (visible) TouchMemory(kMemSceneLayers, entry.first);
+        for (const auto& prop : entry.second) {
+            prop->SetVisibility(visible);
+        }
+    }
+    if (resetCamera) {
+        m_viewRenderer->ResetCamera();
+    }
+    m_viewWindow->Render();
+}
+
+//场景中 prop 所在的图层，不在场景中时返回空串
+QString MainWindow::SceneLayerOf(vtkProp* prop) const
+{
+    for (const auto& entry : m_sceneLayers) {
+        for (const auto& p : entry.second) {
+            if (p == prop) return entry.first;
+        }
+    }
+    return QString();
+}
+
+//显示函数
+void MainWindow::ShowModelInMdiArea(vtkSmartPointer<vtkRenderer> renderer) {
+    try {
+        // 清空MDI区域的所有子窗口
+        ui->mdiArea->closeAllSubWindows();
+
+        // 创建VTK部件
+        QVTKOpenGLNativeWidget *vtkWidget = new QVTKOpenGLNativeWidget();
+        vtkWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+        // 创建渲染窗口
+        vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow =
+            vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
+        vtkWidget->setRenderWindow(renderWindow);
         renderWindow->AddRenderer(renderer);
 
         // 创建全屏子窗口（无边框）
@@ -501,9 +1351,56 @@ void MainWindow::make_elbow_model() {
 #include <vtkCallbackCommand.h>
 #pragma GCC diagnostic pop
 
+#include <BRep_Builder.hxx>
+#include <TopoDS_Compound.hxx>
+#include <QElapsedTimer>
+#include <QStatusBar>
+#include <mutex>
+#include <TopExp.hxx>
+
+// OCC 数据交换的全局状态（XSControl 控制器和转换器、Interface_Static 参数）不是线程安全的，
+// 所有 IGES/STEP 读写（包括后台导出线程中的 STEP 写出）都在此锁内进行
+static std::mutex& DataExchangeMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// 显示用的网格精度；DisplayShape 使用同样的参数，形状上已有满足精度的三角化时不再重新划分
+static const double kDisplayDeflection = 0.01;
+
+static int CountSubShapes(const TopoDS_Shape& shape, TopAbs_ShapeEnum type)
+{
+    int count = 0;
+    for (TopExp_Explorer exp(shape, type); exp.More(); exp.Next()) count++;
+    return count;
+}
+
+//转换已读入的文件。OCC 的转换器（XSControl 控制器和它的读取 Actor）是进程全局的，IGES 的 Actor 转换时
+//会切换模型，STEP 的 Actor 保存转换过程中的可变状态，不能多线程同时转换，所以根实体始终串行 TransferRoots。
+//parallelMesh 时随后并行划分显示用的网格：BRepMesh 先离散各条边，再按面并行划分，共享的边和面只划分一次。
+//report 返回各阶段用时
+template <typename Reader>
+static TopoDS_Shape TranslateRoots(Reader& reader, bool parallelMesh, QString& report)
+{
+    const int numRoots = reader.NbRootsForTransfer();
+    QElapsedTimer timer;
+    timer.start();
+    reader.TransferRoots();
+    TopoDS_Shape shape = reader.OneShape();
+    report = QString("转换 %1 个根实体，用时 %2 ms").arg(numRoots).arg(timer.elapsed());
+    if (parallelMesh && !shape.IsNull()) {
+        timer.restart();
+        BRepMesh_IncrementalMesh mesh(shape, kDisplayDeflection, Standard_False, 0.5, Standard_True);
+        report += QString("；并行划分 %1 个面的网格，用时 %2 ms").arg(CountSubShapes(shape, TopAbs_FACE)).arg(timer.elapsed());
+    }
+    return shape;
+}
+
 //读取STP文件
 TopoDS_Shape MainWindow::ReadSTEPFile(const QString& fileName)
 {
+    std::lock_guard<std::mutex> lock(DataExchangeMutex());
     STEPControl_Reader reader;
     IFSelect_ReturnStatus status = reader.ReadFile(fileName.toStdString().c_str());
 
@@ -513,8 +1410,10 @@ TopoDS_Shape MainWindow::ReadSTEPFile(const QString& fileName)
     }
 
     // 将所有可转换的形状加载到模型
-    reader.TransferRoots();
-    TopoDS_Shape shape = reader.OneShape();
+    QString report;
+    TopoDS_Shape shape = TranslateRoots(reader, m_parallelImportMesh, report);
+    qDebug() << "STEP" << report;
+    statusBar()->showMessage("STEP " + report);
 
     if (shape.IsNull()) {
         qWarning() << "转换失败：文件中无有效几何体";
@@ -527,6 +1426,11 @@ TopoDS_Shape MainWindow::ReadSTEPFile(const QString& fileName)
 //读取IGS文件
 TopoDS_Shape MainWindow::ReadIGESFile(const QString& fileName)
 {
+    std::lock_guard<std::mutex> lock(DataExchangeMutex());
+    // 设置精度模式：须在 ReadFile 之前设置，读取和转换时才会生效
+    Interface_Static::SetCVal("read.precision.mode", "1"); // 启用精度设置
+    Interface_Static::SetRVal("read.precision.val", 1.0e-6);
+
     IGESControl_Reader reader;
 
     IFSelect_ReturnStatus status = reader.ReadFile(fileName.toStdString().c_str());
@@ -536,15 +1440,11 @@ TopoDS_Shape MainWindow::ReadIGESFile(const QString& fileName)
         return TopoDS_Shape();
     }
 
-    // 设置精度模式
-    Interface_Static::SetCVal("read.precision.mode", "1"); // 启用精度设置
-    Interface_Static::SetRVal("read.precision.val", 1.0e-6);
-
-    // 传输所有根实体
-    reader.TransferRoots();
-
-    // 获取合并后的整体形状
-    TopoDS_Shape shape = reader.OneShape();
+    // 传输所有根实体，获取合并后的整体形状
+    QString report;
+    TopoDS_Shape shape = TranslateRoots(reader, m_parallelImportMesh, report);
+    qDebug() << "IGES" << report;
+    statusBar()->showMessage("IGES " + report);
 
     if (shape.IsNull()) {
         qWarning() << "转换失败：IGES文件中无有效几何体";
@@ -555,7 +1455,7 @@ TopoDS_Shape MainWindow::ReadIGESFile(const QString& fileName)
 }
 
 //复用显示逻辑
-void MainWindow::DisplayShape(const TopoDS_Shape& shape)
+void MainWindow::DisplayShape(const TopoDS_Shape& shape, const QString& layer)
 {
     try {
         if (shape.IsNull()) {
@@ -563,101 +1463,17 @@ void MainWindow::DisplayShape(const TopoDS_Shape& shape)
             return;
         }
 
-        // 清理 ui->mdiArea 中的旧内容
-        QLayout* layout = ui->mdiArea->layout();
-        if (layout) {
-            QLayoutItem* item;
-            while ((item = layout->takeAt(0)) != nullptr) {
-                if (item->widget()) {
-                    item->widget()->setParent(nullptr);
-                }
-                delete item;
-            }
-        } else {
-            layout = new QVBoxLayout(ui->mdiArea);
-            ui->mdiArea->setLayout(layout);
-        }
-
-        // 创建 VTK 渲染部件
-        QVTKOpenGLNativeWidget *vtkWidget = new QVTKOpenGLNativeWidget(ui->mdiArea);
-        vtkWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-
-        // 创建渲染器
-        vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
-        renderer->SetBackground(1, 1, 1); // 白色背景
-
-        // 创建渲染窗口
-        vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow =
-            vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
-        vtkWidget->setRenderWindow(renderWindow);
-        renderWindow->AddRenderer(renderer);
-
         // 转换 OCC Shape 为 VTK PolyData
-        BRepMesh_IncrementalMesh mesh(shape, 0.01);
+        BRepMesh_IncrementalMesh mesh(shape, kDisplayDeflection);
         mesh.Perform();
 
         if (!mesh.IsDone()) {
             throw std::runtime_error("网格生成失败！");
         }
 
-        vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-        vtkSmartPointer<vtkCellArray> triangles = vtkSmartPointer<vtkCellArray>::New();
-        int pointIdOffset = 0;
-
-        // 清空旧的映射
-        m_faceMap.clear();
-
-        // 准备建立新映射
-        std::vector<TopoDS_Face> faceOrderList; // 按顺序存储所有 Face
-        TopExp_Explorer tempExp(shape, TopAbs_FACE);
-        for (; tempExp.More(); tempExp.Next()) {
-            faceOrderList.push_back(TopoDS::Face(tempExp.Current()));
-        }
-
-        int currentVtkCellId = 0; // VTK 中 Cell 的全局 ID
-
-        // 修改后的循环（带映射）
-        int faceIndex = 0;
-        for (const auto& face : faceOrderList) {
-            TopLoc_Location loc;
-            Handle(Poly_Triangulation) triFace = BRep_Tool::Triangulation(face, loc);
-
-            if (!triFace.IsNull()) {
-                int numNodes = triFace->NbNodes();
-                int numTriangles = triFace->NbTriangles();
-
-                // 添加顶点
-                for (int i = 1; i <= numNodes; i++) {
-                    gp_Pnt p = triFace->Node(i);
-                    if (!loc.IsIdentity()) {
-                        p.Transform(loc.Transformation());
-                    }
-                    points->InsertNextPoint(p.X(), p.Y(), p.Z());
-                }
-
-                // 添加三角形 & 建立映射
-                for (int i = 1; i <= numTriangles; i++) {
-                    Poly_Triangle tri = triFace->Triangle(i);
-                    Standard_Integer n1, n2, n3;
-                    tri.Get(n1, n2, n3);
-
-                    vtkIdType ids[3] = {n1-1+pointIdOffset, n2-1+pointIdOffset, n3-1+pointIdOffset};
-                    vtkIdType cellId = triangles->InsertNextCell(3, ids);
-
-                    // 记录映射关系
-                    m_faceMap[currentVtkCellId + i - 1] = face;
-                }
-
-                pointIdOffset += numNodes;
-                currentVtkCellId += numTriangles; // 更新 Cell ID
-            }
-            faceIndex++;
-        }
-
-        // 创建 PolyData
-        vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
-        polyData->SetPoints(points);
-        polyData->SetPolys(triangles);
+        // 合并顶点后的 PolyData，单元数据 FaceId 指向 faces 中的面（拾取用）
+        std::vector<TopoDS_Face> faces;
+        vtkSmartPointer<vtkPolyData> polyData = WeldedPolyDataFromShape(shape, &faces);
 
         // 创建 Actor
         vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
@@ -670,28 +1486,10 @@ void MainWindow::DisplayShape(const TopoDS_Shape& shape)
         actor->GetProperty()->EdgeVisibilityOff();
         actor->GetProperty()->SetInterpolationToPhong();
 
-        // 添加到渲染器
-        renderer->AddActor(actor);
-        renderer->ResetCamera();
-
-        // 添加到布局
-        layout->addWidget(vtkWidget);
-        renderWindow->Render();
-
-        // 设置交互器
-        vtkSmartPointer<vtkRenderWindowInteractor> interactor = renderWindow->GetInteractor();
-        vtkSmartPointer<vtkInteractorStyleTrackballCamera> style =
-            vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
-        interactor->SetInteractorStyle(style);
-
-        // 创建回调命令对象
-        vtkSmartPointer<vtkCallbackCommand> clickCallback =
-            vtkSmartPointer<vtkCallbackCommand>::New();
-        clickCallback->SetCallback(OnLeftButtonDown);
-        clickCallback->SetClientData(this); // 传递 this 指针
-
-        // 添加观察者
-        interactor->AddObserver(vtkCommand::LeftButtonPressEvent, clickCallback);
+        // 替换图层并只显示该图层（拾取回调由场景视图统一设置）
+        SetSceneLayer(layer, {actor});
+        m_layerFaces[layer] = std::move(faces);
+        ShowSceneLayers({layer});
 
         qDebug() << "模型已成功显示。";
         qDebug() << "模型类型：" << m_currentShape.ShapeType();
@@ -701,6 +1499,131 @@ void MainWindow::DisplayShape(const TopoDS_Shape& shape)
     }
 }
 
+//----------导入缝合修复----------|
+//IGES 中的面是互不相连的面片，相邻面各有一条几何重合的边，只能按几何比较查找相邻面。
+//可选的导入后处理把面片修复、缝合成共享边的壳并合并同域面，之后相邻面按拓扑精确查找；
+//修复结果按文件（路径、大小、修改时间、容差）缓存为二进制 BRep，再次导入同一文件时直接读取，不再转换原文件
+#include <BRepBuilderAPI_Sewing.hxx>
+#include <ShapeFix_Face.hxx>
+#include <ShapeFix_Shape.hxx>
+#include <ShapeUpgrade_UnifySameDomain.hxx>
+#include <TopExp.hxx>
+#include <BinTools.hxx>
+#include <Precision.hxx>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+
+// 修复结果的缓存文件
+static QString HealedShapeCachePath(const QString& fileName, double tolerance)
+{
+    const QFileInfo info(fileName);
+    const QString key = QString("%1|%2|%3|%4")
+                            .arg(info.absoluteFilePath())
+                            .arg(info.size())
+                            .arg(info.lastModified().toMSecsSinceEpoch())
+                            .arg(tolerance, 0, 'g', 12);
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/healed";
+    QDir().mkpath(dir);
+    return dir + "/" + QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex() + ".brep";
+}
+
+// 读取修复结果的缓存，没有或读取失败时返回空形状
+static TopoDS_Shape ReadHealedShapeCache(const QString& fileName, double tolerance)
+{
+    const QString cachePath = HealedShapeCachePath(fileName, tolerance);
+    TopoDS_Shape cached;
+    if (!QFileInfo::exists(cachePath)) return cached;
+    try {
+        if (!BinTools::Read(cached, QFile::encodeName(cachePath).constData())) cached.Nullify();
+    } catch (const Standard_Failure&) {
+        cached.Nullify();
+    }
+    if (!cached.IsNull()) qDebug() << "使用缓存的缝合修复结果:" << cachePath;
+    return cached;
+}
+
+//修复各面、缝合、整体修复并合并同域面。面之间不共享边时（IGES 面片）各面互不影响，并行修复；
+//OCC 的缝合、ShapeFix_Shape 和 UnifySameDomain 没有并行模式，串行执行。缓存由调用方在转换前检查，这里只写入
+TopoDS_Shape MainWindow::HealImportedShape(const QString& fileName, const TopoDS_Shape& shape)
+{
+    const QString cachePath = HealedShapeCachePath(fileName, m_sewingTolerance);
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<TopoDS_Face> faces;
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        faces.push_back(TopoDS::Face(exp.Current()));
+    }
+    TopTools_IndexedDataMapOfShapeListOfShape edgeFaces;
+    TopExp::MapShapesAndAncestors(shape, TopAbs_EDGE, TopAbs_FACE, edgeFaces);
+    bool independent = true;
+    for (int i = 1; i <= edgeFaces.Extent() && independent; ++i) {
+        independent = edgeFaces.FindFromIndex(i).Extent() < 2;
+    }
+
+    // 1. 各面修复（边界线框、小边、参数曲线）
+    const double tolerance = m_sewingTolerance;
+    auto fixFace = [&](vtkIdType i) {
+        try {
+            ShapeFix_Face fix(faces[i]);
+            fix.SetPrecision(Precision::Confusion());
+            fix.SetMaxTolerance(tolerance);
+            fix.Perform();
+            faces[i] = fix.Face();
+        } catch (const Standard_Failure&) {
+            // 修复失败的面保持原样参与缝合
+        }
+    };
+    if (independent) {
+        vtkSMPTools::For(0, static_cast<vtkIdType>(faces.size()), [&](vtkIdType begin, vtkIdType end) {
+            for (vtkIdType i = begin; i < end; ++i) fixFace(i);
+        });
+    } else {
+        for (vtkIdType i = 0; i < static_cast<vtkIdType>(faces.size()); ++i) fixFace(i);
+    }
+    const qint64 fixMs = timer.restart();
+
+    // 2. 缝合为共享边的壳
+    BRepBuilderAPI_Sewing sewing(tolerance);
+    for (const auto& face : faces) sewing.Add(face);
+    sewing.Perform();
+    TopoDS_Shape healed = sewing.SewedShape();
+    const qint64 sewMs = timer.restart();
+
+    // 3. 整体修复（壳的朝向、缝合后的容差）并合并同一曲面上的相邻面
+    ShapeFix_Shape fixShape(healed);
+    fixShape.SetMaxTolerance(tolerance);
+    fixShape.Perform();
+    healed = fixShape.Shape();
+    ShapeUpgrade_UnifySameDomain unify(healed, Standard_True, Standard_True, Standard_False);
+    unify.Build();
+    healed = unify.Shape();
+    const qint64 unifyMs = timer.elapsed();
+
+    qDebug() << "缝合修复:" << faces.size() << "个面 ->" << CountSubShapes(healed, TopAbs_FACE) << "个面，自由边"
+             << sewing.NbFreeEdges() << "条；面修复" << fixMs << "ms" << (independent ? "(并行)" : "(串行)")
+             << "，缝合" << sewMs << "ms，整体修复与合并" << unifyMs << "ms";
+
+    if (!BinTools::Write(healed, QFile::encodeName(cachePath).constData())) {
+        qWarning() << "缝合修复结果缓存写入失败:" << cachePath;
+    }
+    return healed;
+}
+
+//建立边 -> 相邻面表；有共享边时相邻面按拓扑查找，否则（未缝合的面片）仍按几何比较
+void MainWindow::BuildEdgeFaceMap(const TopoDS_Shape& shape)
+{
+    m_edgeFaces.Clear();
+    m_adjacencyShape = shape;
+    m_sharedTopology = false;
+    if (shape.IsNull()) return;
+    TopExp::MapShapesAndAncestors(shape, TopAbs_EDGE, TopAbs_FACE, m_edgeFaces);
+    for (int i = 1; i <= m_edgeFaces.Extent() && !m_sharedTopology; ++i) {
+        m_sharedTopology = m_edgeFaces.FindFromIndex(i).Extent() >= 2;
+    }
+    qDebug() << "相邻面查找:" << (m_sharedTopology ? "拓扑共享边" : "几何比较");
+}
+
 //显示数模
 void MainWindow::import_part()
 {
@@ -715,20 +1638,31 @@ void MainWindow::import_part()
 
     TopoDS_Shape shape;
     QString suffix = QFileInfo(fileName).suffix().toLower();
-
-    if (suffix == "stp" || suffix == "step") {
-        shape = ReadSTEPFile(fileName);
-    }
-    else if (suffix == "igs" || suffix == "iges") {
-        shape = ReadIGESFile(fileName);
-    }
-    else {
+    const bool isStep = suffix == "stp" || suffix == "step";
+    const bool isIges = suffix == "igs" || suffix == "iges";
+    if (!isStep && !isIges) {
         QMessageBox::warning(this, "不支持", "仅支持 .stp/.step/.igs/.iges");
         return;
     }
 
+    // 有缝合修复缓存时直接读取，跳过转换和修复
+    if (m_healImport) {
+        shape = ReadHealedShapeCache(fileName, m_sewingTolerance);
+    }
+    if (shape.IsNull()) {
+        shape = isStep ? ReadSTEPFile(fileName) : ReadIGESFile(fileName);
+        if (!shape.IsNull() && m_healImport) {
+            shape = HealImportedShape(fileName, shape);
+        }
+    }
+
     if (!shape.IsNull()) {
         m_currentShape = shape;        // 👈 保存当前模型
+        BuildEdgeFaceMap(shape);
+        // 由旧模型派生的图层不再有效
+        ClearSceneLayer("surface");
+        ClearSceneLayer("centerline");
+        ClearSceneLayer("mesh");
         DisplayShape(shape);
     } else {
         QMessageBox::warning(this, "错误", "无法读取或解析该文件！");
@@ -745,24 +1679,35 @@ void MainWindow::import_part()
 void MainWindow::OnLeftButtonDown(vtkObject* obj, unsigned long eid, void* clientdata, void* calldata)
 {
     MainWindow* self = static_cast<MainWindow*>(clientdata);
+    if (!self->m_compareRenderers.empty()) return; // 对比视图中不拾取
     vtkRenderWindowInteractor* interactor = vtkRenderWindowInteractor::SafeDownCast(obj);
     int* pos = interactor->GetEventPosition();
 
-    vtkRenderer* renderer = self->ui->mdiArea->findChild<QVTKOpenGLNativeWidget*>()->renderWindow()->GetRenderers()->GetFirstRenderer();
+    vtkRenderer* renderer = self->m_viewRenderer;
 
     vtkSmartPointer<vtkCellPicker> picker = vtkSmartPointer<vtkCellPicker>::New();
     picker->SetTolerance(0.0005);
     picker->Pick(pos[0], pos[1], 0, renderer);
 
-    if (picker->GetCellId() != -1) {
-        vtkIdType cellId = picker->GetCellId();
-        auto it = self->m_faceMap.find(cellId);
-        if (it != self->m_faceMap.end()) {
-            TopoDS_Face clickedFace = it->second;
+    // 结果图层：探针，绘制最近节点的时程曲线
+    const QString layer = self->SceneLayerOf(picker->GetActor());
+    if (layer == "results" && picker->GetCellId() != -1) {
+        self->ProbeResultNode(picker->GetPickPosition());
+        return;
+    }
+
+    // 只有带面表的图层（原始模型、外表面、表面网格）可以拾取，三角形的 FaceId 指向面表
+    auto faces = self->m_layerFaces.find(layer);
+    if (picker->GetCellId() != -1 && picker->GetDataSet() && faces != self->m_layerFaces.end()) {
+        vtkIntArray* faceIds = vtkIntArray::SafeDownCast(picker->GetDataSet()->GetCellData()->GetArray("FaceId"));
+        const int faceId = faceIds ? faceIds->GetValue(picker->GetCellId()) : -1;
+        if (faceId >= 0 && faceId < static_cast<int>(faces->second.size())) {
+            TopoDS_Face clickedFace = faces->second[faceId];
             TopoDS_Shape outerSurface = self->FindConnectedOuterSurface(self->m_currentShape, clickedFace);
             if (!outerSurface.IsNull()) {
                 self->m_extractedOuterSurface = outerSurface; //保存结果
-                self->DisplayShape(outerSurface);
+                self->ClearSceneLayer("centerline");
+                self->DisplayShape(outerSurface, "surface");
             }
         }
     }
@@ -865,10 +1810,20 @@ bool AreEdgesSame(const TopoDS_Edge& e1, const TopoDS_Edge& e2)
     return sameOrder || reverseOrder;
 }
 
-//查找与给定边共享的所有面。
+//查找与给定边共享的所有面。共享拓扑时直接查边 -> 面表，否则逐面按几何比较
 void MainWindow::GetFacesSharingEdge(const TopoDS_Shape& shape, const TopoDS_Edge& edge, TopTools_ListOfShape& faceList)
 {
     TopTools_MapOfShape uniqueFaces;
+    if (m_sharedTopology && m_adjacencyShape.IsSame(shape)) {
+        const int index = m_edgeFaces.FindIndex(edge);
+        if (index > 0) {
+            for (const auto& face : m_edgeFaces.FindFromIndex(index)) {
+                if (uniqueFaces.Add(face)) faceList.Append(face);
+            }
+        }
+        return;
+    }
+
     TopExp_Explorer exp(shape, TopAbs_FACE);
     for (; exp.More(); exp.Next()) {
         TopoDS_Face face = TopoDS::Face(exp.Current());
@@ -887,7 +1842,177 @@ void MainWindow::GetFacesSharingEdge(const TopoDS_Shape& shape, const TopoDS_Edg
     }
 }
 
-//保存外壁
+//----------后台导出----------|
+//外壁在后台线程中导出为 STEP、二进制 BRep、二进制 STL 和 GLB，多个格式同时写入，界面不等待。
+//STL 和 GLB 直接使用形状上已有的三角化（合并顶点后的网格），不重新划分；每个文件写完后读回校验
+#include <BinTools.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <STEPControl_Reader.hxx>
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QHBoxLayout>
+#include <QProgressBar>
+#include <QThread>
+#include <QStatusBar>
+#include <QFileInfo>
+#include <QDialogButtonBox>
+#include <QRegularExpression>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <cstring>
+
+static const char* ExportFormatName(ExportJob::Format format)
+{
+    switch (format) {
+    case ExportJob::Step: return "STEP";
+    case ExportJob::BRep: return "BRep";
+    case ExportJob::Stl: return "STL";
+    default: return "GLB";
+    }
+}
+
+//在导出线程中运行：写出和读回校验都持有数据交换锁，与界面线程的导入互斥
+static QString ExportStep(const TopoDS_Shape& shape, const QString& path)
+{
+    std::lock_guard<std::mutex> lock(DataExchangeMutex());
+    Interface_Static::SetCVal("write.step.schema", "AP214");
+    STEPControl_Writer writer;
+    if (writer.Transfer(shape, STEPControl_AsIs) != IFSelect_RetDone) return "STEP 转换失败";
+    if (writer.Write(QFile::encodeName(path).constData()) != IFSelect_RetDone) return "写入失败";
+    STEPControl_Reader reader;
+    if (reader.ReadFile(QFile::encodeName(path).constData()) != IFSelect_RetDone || reader.NbRootsForTransfer() == 0) {
+        return "校验失败：文件无法读回";
+    }
+    return QString();
+}
+
+static QString ExportBRep(const TopoDS_Shape& shape, const QString& path)
+{
+    if (!BinTools::Write(shape, QFile::encodeName(path).constData())) return "写入失败";
+    TopoDS_Shape check;
+    if (!BinTools::Read(check, QFile::encodeName(path).constData()) || check.IsNull()) {
+        return "校验失败：文件无法读回";
+    }
+    if (CountSubShapes(check, TopAbs_FACE) != CountSubShapes(shape, TopAbs_FACE)) return "校验失败：面数不一致";
+    return QString();
+}
+
+// 二进制 STL：80 字节文件头、三角形数，每个三角形 50 字节
+static QString ExportStl(const WeldedMesh& mesh, const QString& path)
+{
+    const uint32_t numTriangles = static_cast<uint32_t>(mesh.triangles.size() / 3);
+    if (numTriangles == 0) return "形状没有三角化";
+    std::vector<char> buf(84 + static_cast<size_t>(numTriangles) * 50, 0);
+    std::strncpy(buf.data(), "binary STL exported from tessellation", 80);
+    std::memcpy(buf.data() + 80, &numTriangles, 4);
+    char* out = buf.data() + 84;
+    for (uint32_t t = 0; t < numTriangles; ++t, out += 50) {
+        float v[3][3];
+        for (int k = 0; k < 3; ++k) {
+            const double* p = &mesh.points[3 * static_cast<size_t>(mesh.triangles[3 * t + k])];
+            v[k][0] = static_cast<float>(p[0]);
+            v[k][1] = static_cast<float>(p[1]);
+            v[k][2] = static_cast<float>(p[2]);
+        }
+        const float a[3] = {v[1][0] - v[0][0], v[1][1] - v[0][1], v[1][2] - v[0][2]};
+        const float b[3] = {v[2][0] - v[0][0], v[2][1] - v[0][1], v[2][2] - v[0][2]};
+        float n[3] = {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        const float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len > 0) { n[0] /= len; n[1] /= len; n[2] /= len; }
+        std::memcpy(out, n, 12);
+        std::memcpy(out + 12, v, 36);
+    }
+
+    std::FILE* fp = std::fopen(QFile::encodeName(path).constData(), "wb");
+    if (!fp) return "无法创建文件";
+    const bool written = std::fwrite(buf.data(), 1, buf.size(), fp) == buf.size();
+    if (std::fclose(fp) != 0 || !written) return "写入失败";
+    if (QFileInfo(path).size() != static_cast<qint64>(buf.size())) return "校验失败：文件大小与三角形数不符";
+    return QString();
+}
+
+// GLB（二进制 glTF 2.0）：一个网格，坐标/法向 float32、索引 uint32；模型单位为 mm，节点缩放到 glTF 的 m
+static QString ExportGlb(const WeldedMesh& mesh, const QString& path)
+{
+    const size_t numPoints = mesh.points.size() / 3;
+    const size_t numIndices = mesh.triangles.size();
+    if (numIndices == 0) return "形状没有三角化";
+    const bool hasNormals = mesh.normals.size() == mesh.points.size();
+
+    std::vector<float> positions(mesh.points.size());
+    double lo[3] = {1e300, 1e300, 1e300}, hi[3] = {-1e300, -1e300, -1e300};
+    for (size_t i = 0; i < mesh.points.size(); ++i) {
+        positions[i] = static_cast<float>(mesh.points[i]);
+        lo[i % 3] = std::min(lo[i % 3], double(positions[i]));
+        hi[i % 3] = std::max(hi[i % 3], double(positions[i]));
+    }
+    const size_t positionBytes = positions.size() * sizeof(float);
+    const size_t normalBytes = hasNormals ? mesh.normals.size() * sizeof(float) : 0;
+    const size_t indexBytes = numIndices * sizeof(uint32_t);
+    const size_t binBytes = positionBytes + normalBytes + indexBytes; // 各段均为 4 字节对齐
+
+    QString json = QString("{\"asset\":{\"version\":\"2.0\",\"generator\":\"Tube\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+                           "\"nodes\":[{\"mesh\":0,\"scale\":[0.001,0.001,0.001]}],"
+                           "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0%1},\"indices\":%2,\"mode\":4}]}],"
+                           "\"buffers\":[{\"byteLength\":%3}],\"bufferViews\":[")
+                       .arg(hasNormals ? ",\"NORMAL\":1" : "")
+                       .arg(hasNormals ? 2 : 1)
+                       .arg(binBytes);
+    size_t offset = 0;
+    json += QString("{\"buffer\":0,\"byteOffset\":0,\"byteLength\":%1,\"target\":34962}").arg(positionBytes);
+    offset += positionBytes;
+    if (hasNormals) {
+        json += QString(",{\"buffer\":0,\"byteOffset\":%1,\"byteLength\":%2,\"target\":34962}").arg(offset).arg(normalBytes);
+        offset += normalBytes;
+    }
+    json += QString(",{\"buffer\":0,\"byteOffset\":%1,\"byteLength\":%2,\"target\":34963}],\"accessors\":[").arg(offset).arg(indexBytes);
+    json += QString("{\"bufferView\":0,\"componentType\":5126,\"count\":%1,\"type\":\"VEC3\",\"min\":[%2,%3,%4],\"max\":[%5,%6,%7]}")
+                .arg(numPoints)
+                .arg(lo[0], 0, 'g', 9).arg(lo[1], 0, 'g', 9).arg(lo[2], 0, 'g', 9)
+                .arg(hi[0], 0, 'g', 9).arg(hi[1], 0, 'g', 9).arg(hi[2], 0, 'g', 9);
+    if (hasNormals) {
+        json += QString(",{\"bufferView\":1,\"componentType\":5126,\"count\":%1,\"type\":\"VEC3\"}").arg(numPoints);
+    }
+    json += QString(",{\"bufferView\":%1,\"componentType\":5125,\"count\":%2,\"type\":\"SCALAR\"}]}")
+                .arg(hasNormals ? 2 : 1)
+                .arg(numIndices);
+    QByteArray jsonBytes = json.toUtf8();
+    while (jsonBytes.size() % 4) jsonBytes.append(' ');
+
+    const uint32_t jsonLength = static_cast<uint32_t>(jsonBytes.size());
+    const uint32_t binLength = static_cast<uint32_t>(binBytes);
+    const uint32_t header[3] = {0x46546C67u, 2u, 12u + 8u + jsonLength + 8u + binLength}; // "glTF"
+    const uint32_t jsonChunk[2] = {jsonLength, 0x4E4F534Au};                                // "JSON"
+    const uint32_t binChunk[2] = {binLength, 0x004E4942u};                                  // "BIN"
+
+    std::FILE* fp = std::fopen(QFile::encodeName(path).constData(), "wb");
+    if (!fp) return "无法创建文件";
+    bool written = std::fwrite(header, 4, 3, fp) == 3 && std::fwrite(jsonChunk, 4, 2, fp) == 2 &&
+                   std::fwrite(jsonBytes.constData(), 1, jsonLength, fp) == jsonLength &&
+                   std::fwrite(binChunk, 4, 2, fp) == 2 &&
+                   std::fwrite(positions.data(), 1, positionBytes, fp) == positionBytes;
+    if (written && hasNormals) {
+        written = std::fwrite(mesh.normals.data(), 1, normalBytes, fp) == normalBytes;
+    }
+    if (written) {
+        static_assert(sizeof(WeldIndex) == sizeof(uint32_t), "GLB 索引按 32 位写出");
+        written = std::fwrite(mesh.triangles.data(), 1, indexBytes, fp) == indexBytes;
+    }
+    if (std::fclose(fp) != 0 || !written) return "写入失败";
+
+    // 校验文件头和总长度
+    QFile file(path);
+    uint32_t check[3] = {0, 0, 0};
+    if (!file.open(QIODevice::ReadOnly) || file.read(reinterpret_cast<char*>(check), 12) != 12 ||
+        check[0] != header[0] || check[1] != 2u || check[2] != header[2] || file.size() != header[2]) {
+        return "校验失败：GLB 文件头或长度不符";
+    }
+    return QString();
+}
+
+//保存外壁：选择格式后加入后台导出队列
 void MainWindow::extractFace()
 {
     if (m_extractedOuterSurface.IsNull()) {
@@ -895,34 +2020,199 @@ void MainWindow::extractFace()
         return;
     }
 
-    QString fileName = QFileDialog::getSaveFileName(this,
-                                                    tr("保存外壁模型"), "", tr("STEP 文件 (*.stp *.step)"));
-
-    if (fileName.isEmpty()) {
+    QDialog dialog(this);
+    dialog.setWindowTitle("保存外壁模型");
+    QFormLayout* form = new QFormLayout(&dialog);
+    QWidget* pathRow = new QWidget(&dialog);
+    QHBoxLayout* pathLayout = new QHBoxLayout(pathRow);
+    pathLayout->setContentsMargins(0, 0, 0, 0);
+    QLineEdit* pathEdit = new QLineEdit(m_exportBasePath, pathRow);
+    pathEdit->setMinimumWidth(360);
+    QPushButton* browseButton = new QPushButton("浏览...", pathRow);
+    pathLayout->addWidget(pathEdit);
+    pathLayout->addWidget(browseButton);
+    connect(browseButton, &QPushButton::clicked, &dialog, [&]() {
+        const QString fileName = QFileDialog::getSaveFileName(&dialog, tr("保存外壁模型"), pathEdit->text(), tr("所有文件 (*)"));
+        if (!fileName.isEmpty()) pathEdit->setText(fileName);
+    });
+    form->addRow("文件名(不含扩展名):", pathRow);
+
+    const char* labels[4] = {"STEP (*.stp)", "二进制 BRep (*.brep)", "二进制 STL (*.stl)", "glTF 二进制 (*.glb)"};
+    QCheckBox* formatChecks[4];
+    for (int f = 0; f < 4; ++f) {
+        formatChecks[f] = new QCheckBox(labels[f], &dialog);
+        formatChecks[f]->setChecked(m_exportFormatMask & (1 << f));
+        form->addRow(f == 0 ? "格式:" : "", formatChecks[f]);
+    }
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
         return; // 用户取消保存
     }
 
-    // 确保文件名以 .stp 或 .step 结尾
-    if (!fileName.endsWith(".stp", Qt::CaseInsensitive) &&
-        !fileName.endsWith(".step", Qt::CaseInsensitive)) {
-        fileName += ".stp";
+    m_exportFormatMask = 0;
+    for (int f = 0; f < 4; ++f) {
+        if (formatChecks[f]->isChecked()) m_exportFormatMask |= 1 << f;
+    }
+    QString basePath = pathEdit->text().trimmed();
+    static const QRegularExpression knownSuffix("\\.(stp|step|brep|stl|glb)$", QRegularExpression::CaseInsensitiveOption);
+    basePath.remove(knownSuffix);
+    if (basePath.isEmpty() || m_exportFormatMask == 0) {
+        QMessageBox::warning(this, "警告", "请指定文件名并至少选择一种格式！");
+        return;
     }
+    m_exportBasePath = basePath;
 
-    STEPControl_Writer writer;
-    // 使用 STEPControl_Writer 更简单
-    STEPControl_Writer stepWriter;
+    // 缺三角化时先在这里划分；导出线程使用连同三角化一起复制的形状，
+    // 与 m_currentShape 不共用 TShape，界面线程之后重新划分网格也不影响正在进行的导出
+    for (TopExp_Explorer exp(m_extractedOuterSurface, TopAbs_FACE); exp.More(); exp.Next()) {
+        TopLoc_Location loc;
+        if (BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), loc).IsNull()) {
+            BRepMesh_IncrementalMesh(m_extractedOuterSurface, 0.5, false, 0.1, true);
+            break;
+        }
+    }
+    const TopoDS_Shape shape = BRepBuilderAPI_Copy(m_extractedOuterSurface, Standard_True, Standard_True).Shape();
+
+    // STL 和 GLB 共用一份合并顶点后的网格，由首个用到它的任务生成
+    auto meshTask = std::make_shared<std::packaged_task<std::shared_ptr<const WeldedMesh>()>>([shape]() {
+        auto mesh = std::make_shared<WeldedMesh>();
+        CollectFaceTriangulations(shape, *mesh);
+        WeldVertices(*mesh);
+        return std::shared_ptr<const WeldedMesh>(mesh);
+    });
+    std::shared_future<std::shared_ptr<const WeldedMesh>> meshFuture = meshTask->get_future().share();
+    auto once = std::make_shared<std::once_flag>();
+    auto weldedMesh = [meshTask, meshFuture, once]() {
+        std::call_once(*once, [&]() { (*meshTask)(); });
+        return meshFuture.get();
+    };
+
+    // 上一批已全部结束时清空列表，进度按本批计算
+    bool active = false;
+    for (const auto& job : m_exportJobs) {
+        if (job.state == ExportJob::Queued || job.state == ExportJob::Running) active = true;
+    }
+    if (!active) m_exportJobs.clear();
+
+    const char* suffixes[4] = {".stp", ".brep", ".stl", ".glb"};
+    for (int f = 0; f < 4; ++f) {
+        if (!(m_exportFormatMask & (1 << f))) continue;
+        ExportJob job;
+        job.id = m_nextExportId++;
+        job.format = static_cast<ExportJob::Format>(f);
+        job.path = basePath + suffixes[f];
+        const QString path = job.path;
+        switch (job.format) {
+        case ExportJob::Step: job.task = [shape, path]() { return ExportStep(shape, path); }; break;
+        case ExportJob::BRep: job.task = [shape, path]() { return ExportBRep(shape, path); }; break;
+        case ExportJob::Stl: job.task = [weldedMesh, path]() { return ExportStl(*weldedMesh(), path); }; break;
+        case ExportJob::Glb: job.task = [weldedMesh, path]() { return ExportGlb(*weldedMesh(), path); }; break;
+        }
+        m_exportJobs.push_back(std::move(job));
+    }
+    StartQueuedExports();
+}
 
-    // 设置 STEP 标准
-    Interface_Static::SetCVal("write.step.schema", "AP214");
+//在并行上限内启动排队的导出；STEP 写出持有数据交换锁，同一时间只启动一个 STEP 任务，避免占着并行名额等锁
+void MainWindow::StartQueuedExports()
+{
+    int running = 0;
+    bool stepRunning = false;
+    for (const auto& job : m_exportJobs) {
+        if (job.state != ExportJob::Running) continue;
+        running++;
+        if (job.format == ExportJob::Step) stepRunning = true;
+    }
+    for (auto& job : m_exportJobs) {
+        if (running >= m_maxConcurrentExports) break;
+        if (job.state != ExportJob::Queued || (job.format == ExportJob::Step && stepRunning)) continue;
+        // 任务只使用捕获的数据，不访问 MainWindow；异常转为错误信息
+        job.future = std::async(std::launch::async, [task = job.task]() -> QString {
+            try {
+                return task();
+            } catch (const std::exception& e) {
+                return QString("异常: %1").arg(e.what());
+            } catch (...) {
+                return QString("未知异常");
+            }
+        });
+        job.state = ExportJob::Running;
+        running++;
+        if (job.format == ExportJob::Step) stepRunning = true;
+        qDebug() << "开始导出" << ExportFormatName(job.format) << ":" << job.path;
+    }
+    if (running > 0 && !m_exportPollTimer->isActive()) m_exportPollTimer->start();
+    ReportExports();
+}
 
-    // 写入模型
-    stepWriter.Transfer(m_extractedOuterSurface, STEPControl_AsIs);
-    IFSelect_ReturnStatus status = stepWriter.Write(fileName.toStdString().c_str());
+//收取已完成的导出任务
+void MainWindow::PollExports()
+{
+    bool changed = false;
+    for (auto& job : m_exportJobs) {
+        if (job.state != ExportJob::Running ||
+            job.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            continue;
+        }
+        job.message = job.future.get();
+        job.state = job.message.isEmpty() ? ExportJob::Finished : ExportJob::Failed;
+        job.bytes = QFileInfo(job.path).size();
+        job.task = nullptr;
+        changed = true;
+        qDebug() << "导出" << ExportFormatName(job.format) << (job.message.isEmpty() ? "完成" : "失败") << ":" << job.path
+                 << job.message;
+    }
+    if (!changed) return;
+    StartQueuedExports();
 
-    if (status == IFSelect_RetDone) {
-        QMessageBox::information(this, "成功", "外壁模型已保存为: " + fileName);
+    bool active = false;
+    for (const auto& job : m_exportJobs) {
+        if (job.state == ExportJob::Queued || job.state == ExportJob::Running) active = true;
+    }
+    if (active) return;
+
+    // 本批全部结束：停止轮询并汇总结果
+    m_exportPollTimer->stop();
+    QStringList done, failed;
+    for (const auto& job : m_exportJobs) {
+        const QString line = QString("%1: %2").arg(ExportFormatName(job.format), job.path);
+        if (job.state == ExportJob::Finished) {
+            done << QString("%1 (%2 KB)").arg(line).arg(job.bytes / 1024.0, 0, 'f', 1);
+        } else {
+            failed << QString("%1 - %2").arg(line, job.message);
+        }
+    }
+    if (!failed.isEmpty()) {
+        QMessageBox::warning(this, "警告", "以下导出失败:\n" + failed.join("\n"));
     } else {
-        QMessageBox::critical(this, "错误", "保存失败！");
+        QMessageBox::information(this, "成功", "外壁模型已保存为:\n" + done.join("\n"));
+    }
+}
+
+//状态栏进度：本批已结束的任务数 / 总数
+void MainWindow::ReportExports()
+{
+    int finished = 0;
+    QStringList running;
+    for (const auto& job : m_exportJobs) {
+        if (job.state == ExportJob::Finished || job.state == ExportJob::Failed) finished++;
+        if (job.state == ExportJob::Running) running << ExportFormatName(job.format);
+    }
+    const int total = static_cast<int>(m_exportJobs.size());
+    if (!m_exportProgress) {
+        m_exportProgress = new QProgressBar(this);
+        m_exportProgress->setMaximumWidth(200);
+        m_exportProgress->setFormat("导出 %v/%m");
+        statusBar()->addPermanentWidget(m_exportProgress);
+    }
+    m_exportProgress->setRange(0, std::max(total, 1));
+    m_exportProgress->setValue(finished);
+    m_exportProgress->setVisible(finished < total);
+    if (!running.isEmpty()) {
+        statusBar()->showMessage(QString("正在导出: %1").arg(running.join(", ")));
     }
 }
 
@@ -960,34 +2250,7 @@ void MainWindow::DisplayOuterSurfaceAndCenterline(const TopoDS_Shape& outerShape
             return;
         }
 
-        // 清理 ui->mdiArea 中的旧内容
-        QLayout* layout = ui->mdiArea->layout();
-        if (layout) {
-            QLayoutItem* item;
-            while ((item = layout->takeAt(0)) != nullptr) {
-                if (item->widget()) {
-                    delete item->widget();
-                }
-                delete item;
-            }
-        } else {
-            layout = new QVBoxLayout(ui->mdiArea);
-            ui->mdiArea->setLayout(layout);
-        }
-
-        // 创建 VTK 渲染部件
-        QVTKOpenGLNativeWidget *vtkWidget = new QVTKOpenGLNativeWidget(ui->mdiArea);
-        vtkWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-
-        // 创建渲染器
-        vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
-        renderer->SetBackground(0.1, 0.1, 0.1);
-
-        // 创建渲染窗口
-        vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow =
-            vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
-        vtkWidget->setRenderWindow(renderWindow);
-        renderWindow->AddRenderer(renderer);
+        std::vector<vtkSmartPointer<vtkProp>> actors;
 
         // 1. 显示外壁模型 (半透明)
         {
@@ -997,43 +2260,8 @@ void MainWindow::DisplayOuterSurfaceAndCenterline(const TopoDS_Shape& outerShape
                 throw std::runtime_error("外壁模型网格生成失败！");
             }
 
-            vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-            vtkSmartPointer<vtkCellArray> triangles = vtkSmartPointer<vtkCellArray>::New();
-            vtkIdType pointIdOffset = 0;
-
-            TopExp_Explorer exp(outerShape, TopAbs_FACE);
-            for (; exp.More(); exp.Next()) {
-                TopoDS_Face face = TopoDS::Face(exp.Current());
-                TopLoc_Location loc;
-                Handle(Poly_Triangulation) triFace = BRep_Tool::Triangulation(face, loc);
-
-                if (!triFace.IsNull()) {
-                    int numNodes = triFace->NbNodes();
-                    int numTriangles = triFace->NbTriangles();
-
-                    for (int i = 1; i <= numNodes; i++) {
-                        gp_Pnt p = triFace->Node(i);
-                        if (!loc.IsIdentity()) {
-                            p.Transform(loc.Transformation());
-                        }
-                        points->InsertNextPoint(p.X(), p.Y(), p.Z());
-                    }
-
-                    for (int i = 1; i <= numTriangles; i++) {
-                        Poly_Triangle tri = triFace->Triangle(i);
-                        Standard_Integer n1, n2, n3;
-                        tri.Get(n1, n2, n3);
-
-                        vtkIdType ids[3] = {n1-1+pointIdOffset, n2-1+pointIdOffset, n3-1+pointIdOffset};
-                        triangles->InsertNextCell(3, ids);
-                    }
-                    pointIdOffset += numNodes;
-                }
-            }
-
-            vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
-            polyData->SetPoints(points);
-            polyData->SetPolys(triangles);
+            // 与其他视图相同：合并面间重合的顶点，带 FaceId 和 OCC 精确法向（Phong 着色用）
+            vtkSmartPointer<vtkPolyData> polyData = WeldedPolyDataFromShape(outerShape);
 
             vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
             mapper->SetInputData(polyData);
@@ -1045,7 +2273,7 @@ void MainWindow::DisplayOuterSurfaceAndCenterline(const TopoDS_Shape& outerShape
             //actor->GetProperty()->SetEdgeVisibilityOff();
             actor->GetProperty()->SetInterpolationToPhong();
 
-            renderer->AddActor(actor);
+            actors.push_back(actor);
         }
 
         // 2. 显示中心线 (红色)
@@ -1088,22 +2316,12 @@ void MainWindow::DisplayOuterSurfaceAndCenterline(const TopoDS_Shape& outerShape
             actor->GetProperty()->SetColor(1.0, 0.0, 0.0); // 红色
             actor->GetProperty()->SetLineWidth(3.0);       // 线宽
 
-            renderer->AddActor(actor);
+            actors.push_back(actor);
         }
 
-        // 3. 渲染
-        renderer->ResetCamera(); // 自动调整相机视角
-
-        layout->addWidget(vtkWidget);
-        renderWindow->Render();
-
-        // 设置交互器
-        vtkSmartPointer<vtkRenderWindowInteractor> interactor = renderWindow->GetInteractor();
-        vtkSmartPointer<vtkInteractorStyleTrackballCamera> style =
-            vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
-        interactor->SetInteractorStyle(style);
-        interactor->Initialize(); // 初始化交互器
-        // interactor->Start();      // 对于嵌入式部件，这通常由 Qt 管理
+        // 3. 替换中心线图层并只显示该图层
+        SetSceneLayer("centerline", actors);
+        ShowSceneLayers({"centerline"});
 
         qDebug() << "外壁模型和中心线已成功显示。";
 
@@ -1118,88 +2336,36 @@ void MainWindow::DisplayOuterSurfaceAndCenterline(const TopoDS_Shape& outerShape
 #include <Geom_Circle.hxx> //用于处理圆弧
 #include <GeomAdaptor_Curve.hxx> // 用于适配曲线
 
+// 定义在"六面体扫掠网格"一节
+static bool ExtractTubeSweepSegments(const TopoDS_Shape& shape, std::vector<TubeSweepSegment>& chain, bool requireInnerWall);
+
+//由外壁的圆柱面和环面提取中心线，与六面体扫掠共用扫掠段的识别：剖分成多个面的同一圆柱/圆环合并为一段，
+//轴线截取到各面在轴向的范围、圆弧截取到各面的角度范围，再按端点首尾相连。
+//每段一条边，按链的顺序放入复合体；没有圆柱面或环面时返回空形状
 TopoDS_Shape MainWindow::ExtractAnalyticalCenterlines(const TopoDS_Shape& shape)
 {
-    qDebug() << "ExtractAnalyticalCenterlines 开始处理 shape type:" << shape.ShapeType();
+    std::vector<TubeSweepSegment> chain;
+    if (!ExtractTubeSweepSegments(shape, chain, false)) {
+        qDebug() << "ExtractAnalyticalCenterlines: 没有圆柱面或环面";
+        return TopoDS_Shape();
+    }
 
     BRep_Builder builder;
     TopoDS_Compound comp;
     builder.MakeCompound(comp);
-
-    TopExp_Explorer exp(shape, TopAbs_FACE);
-    int faceCount = 0;
-    for (; exp.More(); exp.Next()) {
-        faceCount++;
-        TopoDS_Face face = TopoDS::Face(exp.Current());
-
-        if (face.IsNull()) {
-            qDebug() << "  跳过空面";
-            continue;
-        }
-
-        BRepAdaptor_Surface surf(face);
-        GeomAbs_SurfaceType surfType = surf.GetType();
-
-        qDebug() << "  处理第" << faceCount << "个面, 类型:" << surfType;
-
-        if (surfType != GeomAbs_Cylinder && surfType != GeomAbs_Torus) {
-            continue;
-        }
-
-        if (surfType == GeomAbs_Cylinder) {
-            qDebug() << "    -> 圆柱面";
-            try {
-                gp_Ax1 axis = surf.Cylinder().Axis();
-                Handle(Geom_Line) line = new Geom_Line(axis);
-
-                // 在圆柱面处理部分
-                TopoDS_Edge edge = BRepBuilderAPI_MakeEdge(line, -500, 500);
-                if (!edge.IsNull()) {
-                    // ✅ 添加几何验证
-                    BRepLib::BuildCurves3d(edge);
-                    Standard_Real first, last;
-                    Handle(Geom_Curve) curve = BRep_Tool::Curve(edge, first, last);
-                    if (curve.IsNull()) {
-                        qDebug() << "    -> Edge 几何无效，跳过";
-                    } else {
-                        builder.Add(comp, edge);
-                        qDebug() << "    -> 成功提取轴线";
-                    }
-                }
-
-            } catch (...) {
-                qDebug() << "    -> 提取圆柱轴线时发生异常";
-            }
-        }
-        else if (surfType == GeomAbs_Torus) {
-            qDebug() << "    -> 环面";
-            try {
-                gp_Torus torus = surf.Torus();
-                gp_Ax1 axis = torus.Axis();
-                gp_Circ centerCircle(gp_Ax2(axis.Location(), axis.Direction()), torus.MajorRadius());
-
-                // 在环面处理部分
-                TopoDS_Edge edge = BRepBuilderAPI_MakeEdge(centerCircle);
-                if (!edge.IsNull()) {
-                    // 添加几何验证
-                    BRepLib::BuildCurves3d(edge);
-                    Standard_Real first, last;
-                    Handle(Geom_Curve) curve = BRep_Tool::Curve(edge, first, last);
-                    if (curve.IsNull()) {
-                        qDebug() << "    -> Edge 几何无效，跳过";
-                    } else {
-                        builder.Add(comp, edge);
-                        qDebug() << "    -> 成功提取中心圆";
-                    }
-                }
-
-            } catch (...) {
-                qDebug() << "    -> 提取环面中心圆时发生异常";
-            }
+    for (const TubeSweepSegment& seg : chain) {
+        const gp_Pnt start(seg.start[0], seg.start[1], seg.start[2]);
+        const gp_Pnt end(seg.end[0], seg.end[1], seg.end[2]);
+        if (seg.toroidal) {
+            // 圆的参数 0 在起点，绕 axis 正向转 angle 到终点
+            const gp_Pnt center(seg.center[0], seg.center[1], seg.center[2]);
+            const gp_Ax2 ax(center, gp_Dir(seg.axis[0], seg.axis[1], seg.axis[2]), gp_Dir(gp_Vec(center, start)));
+            builder.Add(comp, BRepBuilderAPI_MakeEdge(gp_Circ(ax, seg.bendRadius), 0.0, seg.angle).Edge());
+        } else {
+            builder.Add(comp, BRepBuilderAPI_MakeEdge(start, end).Edge());
         }
     }
-
-    qDebug() << "ExtractAnalyticalCenterlines 处理完成，共处理" << faceCount << "个面";
+    qDebug() << "ExtractAnalyticalCenterlines: 中心线共" << chain.size() << "段";
     return comp;
 }
 
@@ -1232,127 +2398,505 @@ void MainWindow::onExtractCenterlineButtonClicked()
     qDebug() << "显示外壁模型(透明)和中心线(红色)";
     // 调用新的显示函数，传入外壁和中心线
     DisplayOuterSurfaceAndCenterline(m_extractedOuterSurface, centerlines);
+    if (m_bendingLine.size() >= 2) {
+        DisplayBendingLine(false);
+    }
+    UpdateBendingDeviation();
 
     qDebug() << "=== 中心线提取及显示完成 ===";
 }
 
-//----------网格划分-----------|
-#include <BRepBuilderAPI_Copy.hxx>
+//----------中心线与弯曲线偏差----------|
+//弯曲线是按顶点编辑的折线。中心线按弧长密集采样（只在中心线变化时重新采样），弯曲线各线段建包围盒层次树（BVH），
+//各采样点并行查询到弯曲线的最近距离，得到偏差最大值和按弧长的平均值；中心线长度用自适应 Gauss-Legendre 积分。
+//编辑弯曲线时只重建很小的 BVH 并重新查询，毫秒级完成，面板中的修改即时反映到偏差和长度
+#include <BRepAdaptor_Curve.hxx>
+#include <GCPnts_UniformAbscissa.hxx>
+#include <GCPnts_QuasiUniformDeflection.hxx>
+#include <STEPControl_Reader.hxx>
+#include <IGESControl_Reader.hxx>
+#include <vtkSMPTools.h>
+#include <vtkPolyLine.h>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QRegularExpression>
+#include <QTableWidget>
+#include <QTextStream>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 中心线采样点数（按各边长度比例分配）
+static const int kCenterlineSamples = 4096;
+
+// BVH 叶节点中的最多线段数
+static const int kSegmentBVHLeafSize = 4;
+
+//[a, b] 上 |C'(t)| 的 5 点 Gauss-Legendre 积分
+static double GaussArcLength(const Adaptor3d_Curve& curve, double a, double b)
+{
+    static const double kNodes[5] = {0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640};
+    static const double kWeights[5] = {0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891,
+                                       0.2369268850561891};
+    const double half = 0.5 * (b - a), mid = 0.5 * (a + b);
+    double sum = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        gp_Pnt p;
+        gp_Vec d;
+        curve.D1(mid + half * kNodes[i], p, d);
+        sum += kWeights[i] * d.Magnitude();
+    }
+    return sum * half;
+}
 
-//网格模型显示
-void MainWindow::DisplayMeshedShape(const TopoDS_Shape& meshedShape)
+//自适应积分：两半之和与整段相差超过容差时继续二分
+static double AdaptiveArcLength(const Adaptor3d_Curve& curve, double a, double b, double whole, double tolerance, int depth)
 {
-    try {
-        if (meshedShape.IsNull()) {
-            QMessageBox::warning(this, tr("警告"), tr("无效的几何体，无法显示！"));
-            qDebug() << "DisplayMeshedShape: 传入的 meshedShape 为空。";
-            return;
+    const double mid = 0.5 * (a + b);
+    const double left = GaussArcLength(curve, a, mid);
+    const double right = GaussArcLength(curve, mid, b);
+    if (depth <= 0 || std::fabs(left + right - whole) <= tolerance) {
+        return left + right;
+    }
+    return AdaptiveArcLength(curve, a, mid, left, 0.5 * tolerance, depth - 1) +
+           AdaptiveArcLength(curve, mid, b, right, 0.5 * tolerance, depth - 1);
+}
+
+static double EdgeArcLength(const BRepAdaptor_Curve& curve)
+{
+    const double a = curve.FirstParameter(), b = curve.LastParameter();
+    const double whole = GaussArcLength(curve, a, b);
+    return AdaptiveArcLength(curve, a, b, whole, 1e-9 * std::max(1.0, whole), 20);
+}
+
+//中心线按弧长采样，weights 为每个采样点代表的弧长（求平均偏差用），返回中心线总长
+static double SampleCenterline(const TopoDS_Shape& centerline, std::vector<gp_Pnt>& samples, std::vector<double>& weights)
+{
+    samples.clear();
+    weights.clear();
+    std::vector<TopoDS_Edge> edges;
+    std::vector<double> lengths;
+    double total = 0.0;
+    for (TopExp_Explorer exp(centerline, TopAbs_EDGE); exp.More(); exp.Next()) {
+        const TopoDS_Edge edge = TopoDS::Edge(exp.Current());
+        if (BRep_Tool::Degenerated(edge) || !BRep_Tool::IsGeometric(edge)) continue;
+        BRepAdaptor_Curve curve(edge);
+        edges.push_back(edge);
+        lengths.push_back(EdgeArcLength(curve));
+        total += lengths.back();
+    }
+    if (total <= 0) return 0.0;
+
+    for (size_t e = 0; e < edges.size(); ++e) {
+        BRepAdaptor_Curve curve(edges[e]);
+        const int count = std::max(2, static_cast<int>(std::lround(kCenterlineSamples * lengths[e] / total)));
+        GCPnts_UniformAbscissa abscissa(curve, count, curve.FirstParameter(), curve.LastParameter());
+        if (!abscissa.IsDone()) continue;
+        for (int i = 1; i <= abscissa.NbPoints(); ++i) {
+            samples.push_back(curve.Value(abscissa.Parameter(i)));
+            weights.push_back(lengths[e] / abscissa.NbPoints());
+        }
+    }
+    return total;
+}
+
+//折线段的包围盒层次树：按线段中点在最长轴上的中位数二分，叶节点最多 kSegmentBVHLeafSize 段
+struct SegmentBVH {
+    struct Node {
+        double lo[3], hi[3];
+        int left = -1, right = -1; // 内部节点的子节点
+        int first = 0, count = 0;  // 叶节点在 order 中的范围
+    };
+    const std::vector<gp_Pnt>* polyline = nullptr;
+    std::vector<int> order; // 线段 i 连接顶点 i 和 i + 1
+    std::vector<Node> nodes;
+
+    void Build(const std::vector<gp_Pnt>& points)
+    {
+        polyline = &points;
+        nodes.clear();
+        order.resize(points.size() > 1 ? points.size() - 1 : 0);
+        for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+        if (!order.empty()) BuildNode(0, static_cast<int>(order.size()));
+    }
+
+    int BuildNode(int first, int count)
+    {
+        const int index = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+        Node node;
+        double clo[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+        double chi[3] = {-clo[0], -clo[1], -clo[2]};
+        for (int k = 0; k < 3; ++k) {
+            node.lo[k] = clo[k];
+            node.hi[k] = chi[k];
+        }
+        for (int i = first; i < first + count; ++i) {
+            const gp_Pnt& a = (*polyline)[order[i]];
+            const gp_Pnt& b = (*polyline)[order[i] + 1];
+            for (int k = 0; k < 3; ++k) {
+                const double ak = a.Coord(k + 1), bk = b.Coord(k + 1);
+                node.lo[k] = std::min(node.lo[k], std::min(ak, bk));
+                node.hi[k] = std::max(node.hi[k], std::max(ak, bk));
+                clo[k] = std::min(clo[k], 0.5 * (ak + bk));
+                chi[k] = std::max(chi[k], 0.5 * (ak + bk));
+            }
+        }
+        if (count <= kSegmentBVHLeafSize) {
+            node.first = first;
+            node.count = count;
+            nodes[index] = node;
+            return index;
+        }
+        int axis = 0;
+        for (int k = 1; k < 3; ++k) {
+            if (chi[k] - clo[k] > chi[axis] - clo[axis]) axis = k;
+        }
+        const int half = count / 2;
+        std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count, [&](int s, int t) {
+            return (*polyline)[s].Coord(axis + 1) + (*polyline)[s + 1].Coord(axis + 1) <
+                   (*polyline)[t].Coord(axis + 1) + (*polyline)[t + 1].Coord(axis + 1);
+        });
+        node.left = BuildNode(first, half);
+        node.right = BuildNode(first + half, count - half);
+        nodes[index] = node;
+        return index;
+    }
+
+    static double BoxDistance2(const Node& node, const gp_Pnt& p)
+    {
+        double d2 = 0.0;
+        for (int k = 0; k < 3; ++k) {
+            const double v = p.Coord(k + 1);
+            const double d = v < node.lo[k] ? node.lo[k] - v : (v > node.hi[k] ? v - node.hi[k] : 0.0);
+            d2 += d * d;
         }
+        return d2;
+    }
+
+    double SegmentDistance2(int segment, const gp_Pnt& p) const
+    {
+        const gp_XYZ a = (*polyline)[segment].XYZ();
+        const gp_XYZ ab = (*polyline)[segment + 1].XYZ() - a;
+        const gp_XYZ ap = p.XYZ() - a;
+        const double len2 = ab.SquareModulus();
+        const double t = len2 > 0 ? std::max(0.0, std::min(1.0, ap.Dot(ab) / len2)) : 0.0;
+        return (ap - ab * t).SquareModulus();
+    }
 
-        // --- 1. 清理 ui->mdiArea 中的旧内容 ---
-        QLayout* layout = ui->mdiArea->layout();
-        if (layout) {
-            QLayoutItem* item;
-            while ((item = layout->takeAt(0)) != nullptr) {
-                if (item->widget()) {
-                    item->widget()->setParent(nullptr);
-                    delete item->widget();
+    //到折线的最近距离：先进入较近的子节点，包围盒比当前最优更远的分支直接跳过
+    double Distance(const gp_Pnt& p) const
+    {
+        if (nodes.empty()) return 0.0;
+        double best = std::numeric_limits<double>::max();
+        int stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (BoxDistance2(node, p) >= best) continue;
+            if (node.left < 0) {
+                for (int i = node.first; i < node.first + node.count; ++i) {
+                    best = std::min(best, SegmentDistance2(order[i], p));
                 }
-                delete item;
+                continue;
             }
+            const double dl = BoxDistance2(nodes[node.left], p);
+            const double dr = BoxDistance2(nodes[node.right], p);
+            const int nearChild = dl <= dr ? node.left : node.right;
+            const int farChild = dl <= dr ? node.right : node.left;
+            stack[top++] = farChild;
+            stack[top++] = nearChild;
+        }
+        return std::sqrt(best);
+    }
+};
+
+//读取弯曲线：文本文件每行 x y z（空格、逗号、分号或制表符分隔），IGES/STEP 中的曲线按顺序离散为折线
+static bool ReadBendingLineFile(const QString& fileName, std::vector<gp_Pnt>& points)
+{
+    points.clear();
+    const QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == "igs" || suffix == "iges" || suffix == "stp" || suffix == "step") {
+        TopoDS_Shape shape;
+        std::lock_guard<std::mutex> lock(DataExchangeMutex());
+        if (suffix == "igs" || suffix == "iges") {
+            IGESControl_Reader reader;
+            if (reader.ReadFile(fileName.toLocal8Bit().constData()) != IFSelect_RetDone) return false;
+            reader.TransferRoots();
+            shape = reader.OneShape();
         } else {
-            layout = new QVBoxLayout(ui->mdiArea);
-            ui->mdiArea->setLayout(layout);
+            STEPControl_Reader reader;
+            if (reader.ReadFile(fileName.toLocal8Bit().constData()) != IFSelect_RetDone) return false;
+            reader.TransferRoots();
+            shape = reader.OneShape();
+        }
+        // 各边首尾相接：下一条边的终点比起点更靠近当前末端时反向
+        for (TopExp_Explorer exp(shape, TopAbs_EDGE); exp.More(); exp.Next()) {
+            const TopoDS_Edge edge = TopoDS::Edge(exp.Current());
+            if (BRep_Tool::Degenerated(edge) || !BRep_Tool::IsGeometric(edge)) continue;
+            BRepAdaptor_Curve curve(edge);
+            GCPnts_QuasiUniformDeflection discretizer(curve, 1e-3);
+            if (!discretizer.IsDone() || discretizer.NbPoints() < 2) continue;
+            std::vector<gp_Pnt> edgePoints;
+            for (int i = 1; i <= discretizer.NbPoints(); ++i) edgePoints.push_back(discretizer.Value(i));
+            if (!points.empty() && points.back().SquareDistance(edgePoints.back()) < points.back().SquareDistance(edgePoints.front())) {
+                std::reverse(edgePoints.begin(), edgePoints.end());
+            }
+            for (const gp_Pnt& p : edgePoints) {
+                if (points.empty() || points.back().SquareDistance(p) > 1e-12) points.push_back(p);
+            }
         }
+        return points.size() >= 2;
+    }
 
-        // --- 2. 创建 VTK 渲染部件 ---
-        QVTKOpenGLNativeWidget *vtkWidget = new QVTKOpenGLNativeWidget(ui->mdiArea);
-        vtkWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    static const QRegularExpression separators("[\\s,;]+");
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QStringList tokens = in.readLine().trimmed().split(separators, Qt::SkipEmptyParts);
+        if (tokens.size() < 3) continue;
+        bool ok[3];
+        const gp_Pnt p(tokens[0].toDouble(&ok[0]), tokens[1].toDouble(&ok[1]), tokens[2].toDouble(&ok[2]));
+        if (ok[0] && ok[1] && ok[2]) points.push_back(p);
+    }
+    return points.size() >= 2;
+}
 
-        // --- 3. 创建渲染器和渲染窗口 ---
-        vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
-        renderer->SetBackground(1, 1, 1);
+//中心线采样点到弯曲线折线的最大距离和按弧长加权的平均距离
+static void CenterlineDeviation(const std::vector<gp_Pnt>& samples, const std::vector<double>& weights,
+                                const std::vector<gp_Pnt>& bendingLine, double& maxDeviation, double& meanDeviation)
+{
+    SegmentBVH bvh;
+    bvh.Build(bendingLine);
+    std::vector<double> distances(samples.size());
+    vtkSMPTools::For(0, static_cast<vtkIdType>(distances.size()), [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i) {
+            distances[i] = bvh.Distance(samples[i]);
+        }
+    });
+    double weighted = 0.0, totalWeight = 0.0;
+    maxDeviation = 0.0;
+    for (size_t i = 0; i < distances.size(); ++i) {
+        maxDeviation = std::max(maxDeviation, distances[i]);
+        weighted += distances[i] * weights[i];
+        totalWeight += weights[i];
+    }
+    meanDeviation = totalWeight > 0 ? weighted / totalWeight : 0.0;
+}
 
-        vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow =
-            vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
-        vtkWidget->setRenderWindow(renderWindow);
-        renderWindow->AddRenderer(renderer);
+//重新计算长度和偏差并填入界面；中心线只在变化后重新采样
+void MainWindow::UpdateBendingDeviation()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (m_extractedCenterline.IsNull()) {
+        m_centerlineSamples.clear();
+        m_centerlineSampleWeights.clear();
+        m_centerlineLength = 0.0;
+        m_centerlineSampleShape.Nullify();
+    } else if (!m_extractedCenterline.IsSame(m_centerlineSampleShape)) {
+        m_centerlineLength = SampleCenterline(m_extractedCenterline, m_centerlineSamples, m_centerlineSampleWeights);
+        m_centerlineSampleShape = m_extractedCenterline;
+    }
+    const QString centerlineText = m_centerlineLength > 0 ? QString::number(m_centerlineLength, 'f', 3) : QString();
+    ui->lineEdit_LineLength->setText(centerlineText);
+    ui->lineEdit_LineLength_2->setText(centerlineText);
+
+    // 折线的弧长就是各段长度之和（线性段上的积分是精确的）
+    double bendingLength = 0.0;
+    for (size_t i = 1; i < m_bendingLine.size(); ++i) {
+        bendingLength += m_bendingLine[i - 1].Distance(m_bendingLine[i]);
+    }
+    ui->lineEdit_BendingLength->setText(m_bendingLine.size() >= 2 ? QString::number(bendingLength, 'f', 3) : QString());
 
-        // --- 4. 从已划分的 Shape 提取 VTK PolyData ---
-        vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-        vtkSmartPointer<vtkCellArray> triangles = vtkSmartPointer<vtkCellArray>::New();
-        int pointIdOffset = 0;
-        int totalPointsAdded = 0;
-        int totalCellsAdded = 0;
-
-        m_faceMap.clear(); // 清空旧的面映射
-        std::vector<TopoDS_Face> faceOrderList;
-        TopExp_Explorer tempExp(meshedShape, TopAbs_FACE);
-        int faceCount = 0;
-        for (; tempExp.More(); tempExp.Next()) {
-            faceOrderList.push_back(TopoDS::Face(tempExp.Current()));
-            faceCount++;
-        }
-        qDebug() << "DisplayMeshedShape: 找到 " << faceCount << " 个面。";
-
-        int currentVtkCellId = 0;
-        for (const auto& face : faceOrderList) {
-            TopLoc_Location loc;
-            Handle(Poly_Triangulation) triFace = BRep_Tool::Triangulation(face, loc);
+    if (m_bendingLine.size() < 2 || m_centerlineSamples.empty()) {
+        ui->lineEdit_DeviationMax->clear();
+        ui->lineEdit_DeviationMean->clear();
+        return;
+    }
 
-            if (!triFace.IsNull()) {
-                int numNodes = triFace->NbNodes();
-                int numTriangles = triFace->NbTriangles();
+    double maxDeviation = 0.0, meanDeviation = 0.0;
+    CenterlineDeviation(m_centerlineSamples, m_centerlineSampleWeights, m_bendingLine, maxDeviation, meanDeviation);
+    ui->lineEdit_DeviationMax->setText(QString::number(maxDeviation, 'f', 4));
+    ui->lineEdit_DeviationMean->setText(QString::number(meanDeviation, 'f', 4));
+    qDebug() << "中心线偏差:" << m_centerlineSamples.size() << "个采样点," << m_bendingLine.size() - 1 << "段弯曲线, 最大" << maxDeviation
+             << ", 耗时" << timer.nsecsElapsed() / 1000 << "us";
+}
 
-                for (int i = 1; i <= numNodes; i++) {
-                    gp_Pnt p = triFace->Node(i);
-                    if (!loc.IsIdentity()) {
-                        p.Transform(loc.Transformation());
-                    }
-                    points->InsertNextPoint(p.X(), p.Y(), p.Z());
-                }
-                totalPointsAdded += numNodes;
+//弯曲线显示在 "bending" 图层（蓝色折线），与中心线图层一起显示
+void MainWindow::DisplayBendingLine(bool resetCamera)
+{
+    if (m_bendingLine.size() < 2) {
+        ClearSceneLayer("bending");
+        return;
+    }
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    vtkSmartPointer<vtkPolyLine> line = vtkSmartPointer<vtkPolyLine>::New();
+    line->GetPointIds()->SetNumberOfIds(static_cast<vtkIdType>(m_bendingLine.size()));
+    for (size_t i = 0; i < m_bendingLine.size(); ++i) {
+        points->InsertNextPoint(m_bendingLine[i].X(), m_bendingLine[i].Y(), m_bendingLine[i].Z());
+        line->GetPointIds()->SetId(static_cast<vtkIdType>(i), static_cast<vtkIdType>(i));
+    }
+    vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+    lines->InsertNextCell(line);
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetLines(lines);
 
-                for (int i = 1; i <= numTriangles; i++) {
-                    Poly_Triangle tri = triFace->Triangle(i);
-                    Standard_Integer n1, n2, n3;
-                    tri.Get(n1, n2, n3);
+    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    mapper->SetInputData(polyData);
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper(mapper);
+    actor->GetProperty()->SetColor(0.0, 0.3, 1.0);
+    actor->GetProperty()->SetLineWidth(3.0);
 
-                    vtkIdType ids[3] = {n1 - 1 + pointIdOffset, n2 - 1 + pointIdOffset, n3 - 1 + pointIdOffset};
-                    vtkIdType cellId = triangles->InsertNextCell(3, ids);
+    SetSceneLayer("bending", {actor});
+    QStringList layers{"bending"};
+    if (HasSceneLayer("centerline")) layers << "centerline";
+    ShowSceneLayers(layers, resetCamera);
+}
 
-                    m_faceMap[currentVtkCellId + i - 1] = face;
-                }
-                totalCellsAdded += numTriangles;
-                pointIdOffset += numNodes;
-                currentVtkCellId += numTriangles;
+//弯曲线面板：顶点表可直接编辑，每次修改后立即重新显示并计算偏差
+void MainWindow::onBendingLineClicked()
+{
+    if (m_bendingPanel) {
+        m_bendingPanel->raise();
+        return;
+    }
+    QDialog* panel = new QDialog(this);
+    m_bendingPanel = panel;
+    panel->setWindowTitle("弯曲线");
+    panel->setAttribute(Qt::WA_DeleteOnClose);
+    panel->resize(420, 420);
+    QVBoxLayout* layout = new QVBoxLayout(panel);
+    QTableWidget* table = new QTableWidget(0, 3, panel);
+    table->setHorizontalHeaderLabels({"X", "Y", "Z"});
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    layout->addWidget(table);
+    QHBoxLayout* buttons = new QHBoxLayout();
+    QPushButton* importButton = new QPushButton("导入...", panel);
+    QPushButton* addButton = new QPushButton("添加点", panel);
+    QPushButton* removeButton = new QPushButton("删除点", panel);
+    buttons->addWidget(importButton);
+    buttons->addWidget(addButton);
+    buttons->addWidget(removeButton);
+    layout->addLayout(buttons);
+
+    // 顶点表 <-> m_bendingLine
+    auto fillTable = [this, table]() {
+        QSignalBlocker blocker(table);
+        table->setRowCount(static_cast<int>(m_bendingLine.size()));
+        for (int r = 0; r < table->rowCount(); ++r) {
+            for (int k = 0; k < 3; ++k) {
+                table->setItem(r, k, new QTableWidgetItem(QString::number(m_bendingLine[r].Coord(k + 1), 'g', 10)));
             }
         }
+    };
+    auto readTable = [this, table](bool resetCamera) {
+        m_bendingLine.clear();
+        for (int r = 0; r < table->rowCount(); ++r) {
+            bool ok[3] = {false, false, false};
+            double xyz[3];
+            for (int k = 0; k < 3; ++k) {
+                const QTableWidgetItem* item = table->item(r, k);
+                xyz[k] = item ? item->text().toDouble(&ok[k]) : 0.0;
+            }
+            if (ok[0] && ok[1] && ok[2]) m_bendingLine.emplace_back(xyz[0], xyz[1], xyz[2]);
+        }
+        DisplayBendingLine(resetCamera);
+        UpdateBendingDeviation();
+    };
+    fillTable();
+
+    connect(table, &QTableWidget::cellChanged, panel, [readTable]() { readTable(false); });
+    connect(importButton, &QPushButton::clicked, panel, [this, panel, fillTable, readTable]() {
+        const QString fileName = QFileDialog::getOpenFileName(panel, "导入弯曲线", "",
+            "点或曲线文件 (*.txt *.csv *.dat *.igs *.iges *.stp *.step);;所有文件 (*)");
+        if (fileName.isEmpty()) return;
+        std::vector<gp_Pnt> points;
+        if (!ReadBendingLineFile(fileName, points)) {
+            QMessageBox::warning(panel, "警告", QString("无法从文件读取弯曲线（至少需要 2 个点）:\n%1").arg(fileName));
+            return;
+        }
+        m_bendingLine = std::move(points);
+        fillTable();
+        readTable(true);
+    });
+    connect(addButton, &QPushButton::clicked, panel, [this, fillTable, readTable]() {
+        // 沿最后一段方向延长一段；不足两点时从原点开始
+        gp_Pnt next(0, 0, 0);
+        if (m_bendingLine.size() >= 2) {
+            const gp_Pnt& a = m_bendingLine[m_bendingLine.size() - 2];
+            const gp_Pnt& b = m_bendingLine.back();
+            next = gp_Pnt(2 * b.XYZ() - a.XYZ());
+        } else if (m_bendingLine.size() == 1) {
+            next = m_bendingLine.back().Translated(gp_Vec(10, 0, 0));
+        }
+        m_bendingLine.push_back(next);
+        fillTable();
+        readTable(false);
+    });
+    connect(removeButton, &QPushButton::clicked, panel, [table, readTable]() {
+        std::vector<int> rows;
+        for (const QModelIndex& index : table->selectionModel()->selectedRows()) rows.push_back(index.row());
+        if (rows.empty() && table->currentRow() >= 0) rows.push_back(table->currentRow());
+        std::sort(rows.rbegin(), rows.rend());
+        {
+            QSignalBlocker blocker(table);
+            for (int r : rows) table->removeRow(r);
+        }
+        readTable(false);
+    });
+
+    panel->show();
+    if (m_bendingLine.size() >= 2) {
+        DisplayBendingLine(false);
+    }
+    UpdateBendingDeviation();
+}
+
+//----------网格划分-----------|
+#include <BRepBuilderAPI_Copy.hxx>
+
+//网格模型显示
+void MainWindow::DisplayMeshedShape(const TopoDS_Shape& meshedShape)
+{
+    try {
+        if (meshedShape.IsNull()) {
+            QMessageBox::warning(this, tr("警告"), tr("无效的几何体，无法显示！"));
+            qDebug() << "DisplayMeshedShape: 传入的 meshedShape 为空。";
+            return;
+        }
 
-        qDebug() << "DisplayMeshedShape: 总共添加了 " << totalPointsAdded << " 个顶点, "
-                 << totalCellsAdded << " 个三角形。";
+        // --- 1. 从已划分的 Shape 提取共享顶点的 VTK PolyData ---
+        std::vector<TopoDS_Face> faces;
+        vtkSmartPointer<vtkPolyData> polyData = WeldedPolyDataFromShape(meshedShape, &faces);
+        qDebug() << "DisplayMeshedShape: " << faces.size() << " 个面, " << polyData->GetNumberOfPoints() << " 个顶点, "
+                 << polyData->GetNumberOfPolys() << " 个三角形。";
 
-        if (totalCellsAdded == 0) {
+        if (polyData->GetNumberOfPolys() == 0) {
             QString warnMsg = tr("模型似乎没有有效的网格数据（0 个三角形），无法显示。");
             qDebug() << "DisplayMeshedShape: " << warnMsg;
             QMessageBox::warning(this, tr("警告"), warnMsg);
-            delete vtkWidget;
             return;
         }
 
-        // --- 5. 创建 VTK PolyData 对象 ---
-        vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
-        polyData->SetPoints(points);
-        polyData->SetPolys(triangles);
-
-        // --- 6. 创建 Mapper 和 Actor ---
+        // --- 2. 创建 Mapper 和 Actor ---
         vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
         mapper->SetInputData(polyData);
 
         vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
         actor->SetMapper(mapper);
 
-        // --- 7. 设置透明度和网格线显示 ---
+        // --- 3. 设置透明度和网格线显示 ---
         // 设置面颜色
         actor->GetProperty()->SetColor(0.8, 0.8, 0.8); // 灰色
         // 设置不透明度 (0.0 完全透明, 1.0 完全不透明)
@@ -1366,25 +2910,10 @@ void MainWindow::DisplayMeshedShape(const TopoDS_Shape& meshedShape)
         // 如果只想显示线，用 WIREFRAME；如果想显示透明面+线，用 SURFACE
         actor->GetProperty()->SetRepresentationToSurface();
 
-        // --- 8. 添加 Actor 到渲染器并重置相机 ---
-        renderer->AddActor(actor);
-        renderer->ResetCamera();
-
-        // --- 9. 将 VTK 部件添加到 UI 布局 ---
-        layout->addWidget(vtkWidget);
-
-        // --- 10. 触发渲染 ---
-        renderWindow->Render();
-
-        // --- 11. 设置交互器和样式 ---
-        vtkSmartPointer<vtkRenderWindowInteractor> interactor = renderWindow->GetInteractor();
-        if (interactor) {
-            vtkSmartPointer<vtkInteractorStyleTrackballCamera> style =
-                vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
-            interactor->SetInteractorStyle(style);
-        } else {
-            qWarning() << "DisplayMeshedShape: 获取 VTK 渲染窗口交互器失败。";
-        }
+        // --- 4. 替换场景中的网格图层并显示 ---
+        SetSceneLayer("mesh", {actor});
+        m_layerFaces["mesh"] = std::move(faces);
+        ShowSceneLayers({"mesh"});
 
         qDebug() << "DisplayMeshedShape: 透明网格模型显示成功。";
     } catch (const std::exception& e) {
@@ -1408,6 +2937,12 @@ void MainWindow::on_meshButton_clicked()
         return;
     }
 
+    // 六面体扫掠网格：单元尺寸是单独的设置，不使用表面网格的弦高
+    if (ui->comboBox_MeshType->currentIndex() == 1) {
+        MeshTubeHex();
+        return;
+    }
+
     // 2. 从界面获取网格大小参数
     double linearDeflection = ui->spinBox->value();
     // 确保值是正数
@@ -1417,6 +2952,12 @@ void MainWindow::on_meshButton_clicked()
         return;
     }
 
+    // 各向同性重划分：网格大小作为目标单元边长
+    if (ui->comboBox_MeshType->currentIndex() == 2) {
+        RemeshIsotropic(linearDeflection);
+        return;
+    }
+
     // 3. 创建原始模型的深拷贝，避免修改 m_currentShape 本身
     // BRepMesh_IncrementalMesh 会修改 Shape 内部的三角剖分数据
     BRepBuilderAPI_Copy copier(m_currentShape);
@@ -1468,295 +3009,5885 @@ void MainWindow::on_meshButton_clicked()
 }
 
 
-//----------过程可视化----------|
-//原始模型
-void MainWindow::init_model(){
-    if (!m_currentShape.IsNull()) {
-        DisplayShape(m_currentShape);
-    } else {
-        QMessageBox::warning(this, "错误", "没有可用模型！");
-    }
-}
-//网格模型
-void MainWindow::mesh_model(){
-    if (!m_meshedShape.IsNull()) {
-        DisplayMeshedShape(m_meshedShape);
-    } else {
-        QMessageBox::warning(this, "错误", "没有可用模型！");
-    }
-}
-//表面模型
-void MainWindow::surface_model(){
-    if (!m_extractedOuterSurface.IsNull()) {
-        DisplayShape(m_extractedOuterSurface);
+//----------各向同性重划分----------|
+//以目标单元尺寸 L 重划分表面网格：长于 4/3·L 的边剖分、短于 4/5·L 的边收缩、翻转边使节点度数接近 6、
+//切向光顺，新节点和移动后的节点都投影回 OCC 面。每条拓扑边只按弧长等分一次，相邻面使用同一组边界节点，
+//各面的面内重划分互不影响，因此按面并行且面之间的边界协调
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <BRep_Builder.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <GCPnts_AbscissaPoint.hxx>
+#include <GCPnts_UniformAbscissa.hxx>
+#include <Geom_Surface.hxx>
+#include <Geom2d_Curve.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <ShapeAnalysis_Surface.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+
+// 重划分迭代次数（每次依次剖分、收缩、翻转、光顺）
+static const int kRemeshIterations = 5;
+
+// 初始三角化的弦高偏差相对单元尺寸的比例：边界折线足够贴近曲线，插入等分点时不会使三角形翻转
+static const double kRemeshSeedDeflectionRatio = 0.1;
+
+// 一条拓扑边按弧长等分的结果（含两端），参数为边自身的曲线参数
+struct EdgeSamples {
+    std::vector<double> params;
+    std::vector<gp_Pnt> points;
+};
+
+//按弧长把边等分为约 length / size 段；退化边（如锥顶）不等分，保持初始三角化的边界
+static void SampleEdgeUniform(const TopoDS_Edge& edge, double size, EdgeSamples& samples)
+{
+    samples = EdgeSamples();
+    if (BRep_Tool::Degenerated(edge) || !BRep_Tool::IsGeometric(edge)) return;
+
+    BRepAdaptor_Curve curve(edge);
+    const double first = curve.FirstParameter();
+    const double last = curve.LastParameter();
+    const double length = GCPnts_AbscissaPoint::Length(curve, first, last);
+    const int segments = std::max(1, static_cast<int>(std::lround(length / size)));
+
+    GCPnts_UniformAbscissa abscissa(curve, segments + 1, first, last);
+    if (abscissa.IsDone() && abscissa.NbPoints() == segments + 1) {
+        for (int i = 1; i <= segments + 1; i++) samples.params.push_back(abscissa.Parameter(i));
     } else {
-        QMessageBox::warning(this, "错误", "没有可用模型！");
+        for (int i = 0; i <= segments; i++) samples.params.push_back(first + (last - first) * i / segments);
     }
+    for (double t : samples.params) samples.points.push_back(curve.Value(t));
 }
-//中线模型
-void MainWindow::centerline_model(){
-
-}
-
-
-//----------结果可视化----------|
-#include <vtkTextProperty.h>
 
-//tab栏读取VTK文件
-void MainWindow::onTabInitClicked(int index)
+//单个面上的三角网格重划分：节点带 UV 参数，面片边界上的节点锁定不动。
+//三角形保持曲面自然方向（与 Poly_Triangulation 一致），坐标为全局坐标
+class FaceRemesher
 {
-    // 获取被点击的tab的文本
-    QString tabText = ui->tabWidget->tabText(index);
+public:
+    FaceRemesher(const TopoDS_Face& face, double size)
+        : m_face(face), m_size(size), m_surface(BRep_Tool::Surface(face)), m_analysis(new ShapeAnalysis_Surface(m_surface))
+    {
+        m_precision = 1e-3 * size;
+    }
 
-    // 根据点击的tab索引执行不同的逻辑
-    switch (index) {
-    case 0:
-        qDebug() << "第一个标签页被点击了! 索引:" << index << ", 文本:" << tabText;
-        // 在这里添加第一个tab的点击处理逻辑
-        break;
-    case 1:
-        qDebug() << "第二个标签页被点击了! 索引:" << index << ", 文本:" << tabText;
-        // 在这里添加第二个tab的点击处理逻辑
-        break;
-    case 2:
-        qDebug() << "第三个标签页被点击了! 索引:" << index << ", 文本:" << tabText;
-        // 在这里添加第三个tab的点击处理逻辑
-        break;
-    case 3:
-        qDebug() << "第四个标签页被点击了! 索引:" << index << ", 文本:" << tabText;
-        {
-            // 1. 获取当前工作目录
-            QString currentDir = QDir::currentPath();
-            // 2. 构建results文件夹路径
-            QString resultsDirPath = currentDir + "/results";
-            QDir resultsDir(resultsDirPath);
+    //载入初始三角化，并把各拓扑边上的边界节点替换为等分点
+    bool Load(const Handle(Poly_Triangulation)& tri, const TopLoc_Location& loc,
+              const TopTools_IndexedMapOfShape& edgeMap, const std::vector<EdgeSamples>& samples)
+    {
+        if (tri.IsNull() || !tri->HasUVNodes()) return false;
+        m_deflection = tri->Deflection();
+        for (Standard_Integer i = 1; i <= tri->NbNodes(); i++) {
+            AddVertex(tri->Node(i).Transformed(loc.Transformation()), tri->UVNode(i), false);
+        }
+        for (Standard_Integer i = 1; i <= tri->NbTriangles(); i++) {
+            Standard_Integer n1, n2, n3;
+            tri->Triangle(i).Get(n1, n2, n3);
+            AddTriangle(n1 - 1, n2 - 1, n3 - 1);
+        }
 
-            // 3. 检查results文件夹是否存在
-            if (!resultsDir.exists()) {
-                qWarning() << "Results directory does not exist: " << resultsDirPath;
-                return;
+        // 闭合面的缝合边在线框中出现两次（正反两个方向），各自对应一组节点和一条 pcurve
+        for (TopExp_Explorer edgeExp(m_face, TopAbs_EDGE); edgeExp.More(); edgeExp.Next()) {
+            const TopoDS_Edge edge = TopoDS::Edge(edgeExp.Current());
+            Handle(Poly_PolygonOnTriangulation) polygon = BRep_Tool::PolygonOnTriangulation(edge, tri, loc);
+            if (polygon.IsNull()) return false;
+            std::vector<int> chain;
+            for (Standard_Integer i = 1; i <= polygon->NbNodes(); i++) {
+                chain.push_back(polygon->Node(i) - 1);
+                m_locked[chain.back()] = 1;
             }
+            const int index = edgeMap.FindIndex(edge);
+            if (index == 0 || !polygon->HasParameters()) continue;
+            const EdgeSamples& edgeSamples = samples[index - 1];
+            if (edgeSamples.params.size() < 2) continue;
+            std::vector<double> chainParams;
+            for (Standard_Integer i = 1; i <= polygon->NbNodes(); i++) chainParams.push_back(polygon->Parameter(i));
+            ResampleBoundary(edge, chain, chainParams, edgeSamples);
+        }
+        return true;
+    }
 
-            // 4. 获取results文件夹下所有以.vtk结尾的文件
-            QStringList nameFilters;
-            nameFilters << "*.vtk";
-            QFileInfoList fileInfoList = resultsDir.entryInfoList(nameFilters, QDir::Files | QDir::NoDotAndDotDot, QDir::Name); // 按名称排序
-
-            // 5. 提取文件路径到QStringList
-            for (const QFileInfo& fileInfo : fileInfoList) {
-                vtkFilePaths.append(fileInfo.absoluteFilePath());
-            }
-            qDebug() << "Found " << vtkFilePaths.size() << " VTK files in " << resultsDirPath;
+    void Remesh(int iterations)
+    {
+        const double high = 4.0 / 3.0 * m_size;
+        const double low = 4.0 / 5.0 * m_size;
+        for (int it = 0; it < iterations; it++) {
+            SplitLongEdges(high);
+            CollapseShortEdges(low, high);
+            FlipEdges();
+            SmoothTangential();
         }
-        break;
-    default:
-        qDebug() << "未知的标签页被点击! 索引:" << index;
-        break;
     }
-}
 
-void MainWindow::VisualVTKGroupFile(const QStringList& fileNames, const QString& scalarType)
-{
-    // --- 1. 清空并准备 MDI 子窗口 ---
-    QLayout* layout_vtk = ui->mdiArea->layout();
-    if (layout_vtk) {
-        QLayoutItem* item;
-        while ((item = layout_vtk->takeAt(0)) != nullptr) {
-            if (item->widget()) {
-                item->widget()->setParent(nullptr);
-                delete item->widget();
+    //紧凑编号后写回 Poly_Triangulation（面的局部坐标）
+    Handle(Poly_Triangulation) Result(const TopLoc_Location& loc) const
+    {
+        std::vector<int> newIndex(m_points.size(), -1);
+        int numNodes = 0, numTriangles = 0;
+        for (size_t t = 0; t < m_triangles.size(); t++) {
+            if (!m_alive[t]) continue;
+            numTriangles++;
+            for (int v : m_triangles[t]) {
+                if (newIndex[v] < 0) newIndex[v] = numNodes++;
             }
-            delete item;
         }
-    } else {
-        layout_vtk = new QVBoxLayout(ui->mdiArea);
-        ui->mdiArea->setLayout(layout_vtk);
+        Handle(Poly_Triangulation) tri = new Poly_Triangulation(numNodes, numTriangles, Standard_True);
+        const gp_Trsf toLocal = loc.Transformation().Inverted();
+        for (size_t v = 0; v < m_points.size(); v++) {
+            if (newIndex[v] < 0) continue;
+            tri->SetNode(newIndex[v] + 1, m_points[v].Transformed(toLocal));
+            tri->SetUVNode(newIndex[v] + 1, m_uv[v]);
+        }
+        int k = 1;
+        for (size_t t = 0; t < m_triangles.size(); t++) {
+            if (!m_alive[t]) continue;
+            const std::array<int, 3>& tr = m_triangles[t];
+            tri->SetTriangle(k++, Poly_Triangle(newIndex[tr[0]] + 1, newIndex[tr[1]] + 1, newIndex[tr[2]] + 1));
+        }
+        tri->Deflection(m_deflection);
+        return tri;
     }
 
-    // 检查是否有文件需要处理
-    if (fileNames.isEmpty()) {
-        qDebug() << "No files provided to VisualVTKGroupFile.";
-        return; // 如果没有文件，直接返回
+    //边界上因收缩会翻转三角形而保留下来的原始节点数
+    int KeptBoundaryNodes() const { return m_keptBoundaryNodes; }
+
+private:
+    int AddVertex(const gp_Pnt& p, const gp_Pnt2d& uv, bool locked)
+    {
+        m_points.push_back(p);
+        m_uv.push_back(uv);
+        m_locked.push_back(locked ? 1 : 0);
+        m_vertexTriangles.emplace_back();
+        return static_cast<int>(m_points.size()) - 1;
     }
 
-    // 创建一个中心部件用于容纳 QVTKOpenGLNativeWidget
-    QWidget *centralWidget = new QWidget();
-    QVBoxLayout *layout = new QVBoxLayout(centralWidget);
-    layout->setContentsMargins(0, 0, 0, 0);
+    int AddTriangle(int a, int b, int c)
+    {
+        const int t = static_cast<int>(m_triangles.size());
+        m_triangles.push_back({a, b, c});
+        m_alive.push_back(1);
+        m_vertexTriangles[a].push_back(t);
+        m_vertexTriangles[b].push_back(t);
+        m_vertexTriangles[c].push_back(t);
+        return t;
+    }
 
-    // 创建 QVTKOpenGLNativeWidget
-    QVTKOpenGLNativeWidget *vtkWidget = new QVTKOpenGLNativeWidget(centralWidget);
+    void DetachTriangle(int t, int v)
+    {
+        std::vector<int>& list = m_vertexTriangles[v];
+        list.erase(std::remove(list.begin(), list.end(), t), list.end());
+    }
 
-    // 创建 VTK 渲染窗口和渲染器
-    // 每次调用函数时都创建新的RenderWindow和Renderer
-    vtkSmartPointer<vtkGenericOpenGLRenderWindow> localRenderWindow =
-        vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
-    vtkSmartPointer<vtkRenderer> localRenderer = vtkSmartPointer<vtkRenderer>::New();
-    localRenderer->SetBackground(1.0, 1.0, 1.0);
-    localRenderWindow->AddRenderer(localRenderer);
+    void RemoveTriangle(int t)
+    {
+        for (int v : m_triangles[t]) DetachTriangle(t, v);
+        m_alive[t] = 0;
+    }
 
-    // 设置 VTK 部件的渲染窗口
-    vtkWidget->setRenderWindow(localRenderWindow);
+    //共享边 (a, b) 的三角形
+    std::vector<int> EdgeTriangles(int a, int b) const
+    {
+        std::vector<int> result;
+        for (int t : m_vertexTriangles[a]) {
+            const std::array<int, 3>& tr = m_triangles[t];
+            if (tr[0] == b || tr[1] == b || tr[2] == b) result.push_back(t);
+        }
+        return result;
+    }
 
-    // 将 VTK 部件添加到布局
-    layout->addWidget(vtkWidget);
+    std::vector<int> Neighbors(int v) const
+    {
+        std::vector<int> result;
+        for (int t : m_vertexTriangles[v]) {
+            for (int w : m_triangles[t]) {
+                if (w != v) result.push_back(w);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
 
-    // 创建全屏子窗口
-    QMdiSubWindow *subWindow = new QMdiSubWindow(ui->mdiArea);
-    subWindow->setWidget(centralWidget); // 设置包含VTK部件的中心部件
-    subWindow->setWindowFlags(Qt::FramelessWindowHint); // 无边框
-    subWindow->setAttribute(Qt::WA_DeleteOnClose);
+    //节点度数的目标值：面内 6，边界 4
+    int ValenceExcess(int v, int delta) const
+    {
+        const int valence = static_cast<int>(m_vertexTriangles[v].size()) + (m_locked[v] ? 1 : 0) + delta;
+        return std::abs(valence - (m_locked[v] ? 4 : 6));
+    }
 
-    // 将子窗口添加到 MDI 区域
-    ui->mdiArea->addSubWindow(subWindow);
+    gp_Vec TriangleNormal(const gp_Pnt& a, const gp_Pnt& b, const gp_Pnt& c) const
+    {
+        return gp_Vec(a, b).Crossed(gp_Vec(a, c));
+    }
 
-    // --- 2. 执行 VTK 可视化逻辑 ---
-    QString currentTypeForThisWindow = scalarType;
-    int currentFrame = 0;
-    QList<vtkActor*> vtkActorsForThisWindow;
-    QList<vtkUnstructuredGrid*> vtkGridsForThisWindow;
-    vtkSmartPointer<vtkUnstructuredGridReader> reader;
+    gp_Vec TriangleNormal(int t) const
+    {
+        const std::array<int, 3>& tr = m_triangles[t];
+        return TriangleNormal(m_points[tr[0]], m_points[tr[1]], m_points[tr[2]]);
+    }
 
-    // 在循环外创建scalarBar，但只在需要时
-    vtkSmartPointer<vtkScalarBarActor> scalarBar = nullptr; // 初始化为nullptr
-    vtkSmartPointer<vtkLookupTable> lut = nullptr; // 也推迟LUT的创建
+    //空间点投影到面上，guess 为附近的 UV（面片在 UV 中是单连通的，相邻节点的 UV 可直接插值）
+    void Project(const gp_Pnt& p, const gp_Pnt2d& guess, gp_Pnt& projected, gp_Pnt2d& uv)
+    {
+        uv = m_analysis->NextValueOfUV(guess, p, m_precision);
+        projected = m_surface->Value(uv.X(), uv.Y());
+    }
 
-    for (const auto& fileName : fileNames) {
-        reader = vtkSmartPointer<vtkUnstructuredGridReader>::New();
-        reader->SetFileName(fileName.toStdString().c_str());
-        reader->Update();
+    //在边 (a, b) 上插入节点 v，两侧三角形各分为两个
+    void SplitEdge(int a, int b, int v)
+    {
+        for (int t : EdgeTriangles(a, b)) {
+            std::array<int, 3> tr = m_triangles[t];
+            int i = 0;
+            while (!((tr[i] == a && tr[(i + 1) % 3] == b) || (tr[i] == b && tr[(i + 1) % 3] == a))) i++;
+            const int x = tr[i], y = tr[(i + 1) % 3], c = tr[(i + 2) % 3];
+            m_triangles[t] = {x, v, c};
+            DetachTriangle(t, y);
+            m_vertexTriangles[v].push_back(t);
+            AddTriangle(v, y, c);
+        }
+    }
+
+    //把 a 收缩到 b：检查连接条件（共同邻点数等于边的三角形数）、三角形不翻转，
+    //maxLength > 0 时还要求收缩后 b 的新边不超过 maxLength
+    bool CanCollapse(int a, int b, double maxLength) const
+    {
+        const std::vector<int> edgeTriangles = EdgeTriangles(a, b);
+        if (edgeTriangles.empty()) return false;
+        const std::vector<int> na = Neighbors(a), nb = Neighbors(b);
+        std::vector<int> common;
+        std::set_intersection(na.begin(), na.end(), nb.begin(), nb.end(), std::back_inserter(common));
+        if (common.size() != edgeTriangles.size()) return false;
+        if (maxLength > 0) {
+            for (int w : na) {
+                if (w != b && m_points[w].SquareDistance(m_points[b]) > maxLength * maxLength) return false;
+            }
+        }
+        for (int t : m_vertexTriangles[a]) {
+            if (std::find(edgeTriangles.begin(), edgeTriangles.end(), t) != edgeTriangles.end()) continue;
+            std::array<gp_Pnt, 3> moved = {m_points[m_triangles[t][0]], m_points[m_triangles[t][1]], m_points[m_triangles[t][2]]};
+            for (int k = 0; k < 3; k++) {
+                if (m_triangles[t][k] == a) moved[k] = m_points[b];
+            }
+            const gp_Vec after = TriangleNormal(moved[0], moved[1], moved[2]);
+            if (after.SquareMagnitude() < 1e-24 || after.Dot(TriangleNormal(t)) <= 0) return false;
+        }
+        return true;
+    }
 
-        vtkSmartPointer<vtkDataArray> selectedScalar;
-        QString color_name = "Solid";
-        bool useScalar = true;
+    void Collapse(int a, int b)
+    {
+        for (int t : EdgeTriangles(a, b)) RemoveTriangle(t);
+        for (int t : m_vertexTriangles[a]) {
+            for (int& w : m_triangles[t]) {
+                if (w == a) w = b;
+            }
+            m_vertexTriangles[b].push_back(t);
+        }
+        m_vertexTriangles[a].clear();
+    }
 
-        std::string typeStr = currentTypeForThisWindow.toStdString();
-        selectedScalar = reader->GetOutput()->GetPointData()->GetArray(typeStr.c_str());
-        color_name = currentTypeForThisWindow.toStdString().c_str();
+    //把初始三角化在一条拓扑边上的节点链换成共享的等分点：先在所在线段上插入等分点，再把原有的内部节点收缩到相邻节点。
+    //等分点按边的参数递增排列，节点链与边反向（PolygonOnTriangulation 逆着边的参数方向）时先把链反过来
+    void ResampleBoundary(const TopoDS_Edge& edge, std::vector<int> chain, std::vector<double> chainParams,
+                          const EdgeSamples& samples)
+    {
+        Standard_Real first, last;
+        Handle(Geom2d_Curve) pcurve = BRep_Tool::CurveOnSurface(edge, m_face, first, last);
+        if (pcurve.IsNull()) return;
+        if (chainParams.back() < chainParams.front()) {
+            std::reverse(chain.begin(), chain.end());
+            std::reverse(chainParams.begin(), chainParams.end());
+        }
+        std::vector<char> inserted(chain.size(), 0);
+        inserted.front() = inserted.back() = 1;
+
+        size_t j = 0;
+        for (size_t k = 1; k + 1 < samples.params.size(); k++) {
+            const double t = samples.params[k];
+            while (j + 2 < chain.size() && t >= chainParams[j + 1]) j++;
+            const int v = AddVertex(samples.points[k], pcurve->Value(t), true);
+            SplitEdge(chain[j], chain[j + 1], v);
+            chain.insert(chain.begin() + j + 1, v);
+            chainParams.insert(chainParams.begin() + j + 1, t);
+            inserted.insert(inserted.begin() + j + 1, 1);
+            j++;
+        }
 
-        if (!selectedScalar) {
-            qWarning() << "标量数组 " << currentTypeForThisWindow << " 不存在 in file " << fileName << "!";
-            continue; // 跳过当前文件，继续处理下一个
+        // 自前向后处理，优先收缩到前一个节点。两侧收缩都会使三角形翻转时保留该节点：
+        // 相邻面在这里可能多出一个悬挂节点，但不会产生折叠的三角形
+        for (size_t i = 1; i + 1 < chain.size();) {
+            if (inserted[i]) {
+                i++;
+                continue;
+            }
+            const int v = chain[i];
+            if (CanCollapse(v, chain[i - 1], 0)) {
+                Collapse(v, chain[i - 1]);
+            } else if (CanCollapse(v, chain[i + 1], 0)) {
+                Collapse(v, chain[i + 1]);
+            } else {
+                m_keptBoundaryNodes++;
+                i++;
+                continue;
+            }
+            chain.erase(chain.begin() + i);
+            inserted.erase(inserted.begin() + i);
         }
+    }
 
-        vtkSmartPointer<vtkDataSetMapper> mapper = vtkSmartPointer<vtkDataSetMapper>::New();
-        mapper->SetInputConnection(reader->GetOutputPort());
+    //当前所有内部边 (a < b)
+    std::vector<std::pair<int, int>> CollectEdges() const
+    {
+        std::vector<std::pair<int, int>> edges;
+        for (size_t t = 0; t < m_triangles.size(); t++) {
+            if (!m_alive[t]) continue;
+            const std::array<int, 3>& tr = m_triangles[t];
+            for (int k = 0; k < 3; k++) {
+                edges.emplace_back(std::min(tr[k], tr[(k + 1) % 3]), std::max(tr[k], tr[(k + 1) % 3]));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        return edges;
+    }
 
-        if (useScalar && selectedScalar) {
-            int numComponents = selectedScalar->GetNumberOfComponents();
-            mapper->SetScalarVisibility(true);
-            mapper->SelectColorArray(selectedScalar->GetName());
+    bool IsBoundaryEdge(int a, int b) const
+    {
+        return m_locked[a] && m_locked[b] && EdgeTriangles(a, b).size() < 2;
+    }
 
-            if (numComponents == 1) {
-                mapper->SetScalarModeToUsePointFieldData();
-            } else {
-                mapper->SetScalarModeToUsePointFieldData();
+    void SplitLongEdges(double high)
+    {
+        // 新边在同一轮中继续检查，直到所有内部边都不长于 high（投影不收敛时限制轮数）
+        std::vector<std::pair<int, int>> edges = CollectEdges();
+        for (int round = 0; round < 32 && !edges.empty(); round++) {
+            std::vector<std::pair<int, int>> next;
+            for (const auto& e : edges) {
+                const int a = e.first, b = e.second;
+                if (m_points[a].SquareDistance(m_points[b]) <= high * high) continue;
+                if (EdgeTriangles(a, b).empty() || IsBoundaryEdge(a, b)) continue;
+                const gp_Pnt mid((m_points[a].XYZ() + m_points[b].XYZ()) / 2);
+                const gp_Pnt2d guess((m_uv[a].XY() + m_uv[b].XY()) / 2);
+                gp_Pnt p;
+                gp_Pnt2d uv;
+                Project(mid, guess, p, uv);
+                const int v = AddVertex(p, uv, false);
+                SplitEdge(a, b, v);
+                for (int w : Neighbors(v)) next.emplace_back(std::min(v, w), std::max(v, w));
             }
+            edges.swap(next);
+        }
+    }
+
+    void CollapseShortEdges(double low, double high)
+    {
+        for (const auto& e : CollectEdges()) {
+            int a = e.first, b = e.second;
+            if (m_vertexTriangles[a].empty() || m_vertexTriangles[b].empty()) continue;
+            if (m_points[a].SquareDistance(m_points[b]) >= low * low) continue;
+            if (m_locked[a] && m_locked[b]) continue;
+            if (m_locked[a]) std::swap(a, b);
+            if (CanCollapse(a, b, high)) Collapse(a, b);
+        }
+    }
 
-            double range[2];
-            selectedScalar->GetRange(range);
-            if (range[0] >= range[1]) {
-                range[0] = 0;
-                range[1] = 1;
+    void FlipEdges()
+    {
+        for (const auto& e : CollectEdges()) {
+            const int a = e.first, b = e.second;
+            const std::vector<int> tris = EdgeTriangles(a, b);
+            if (tris.size() != 2) continue;
+            // 以 t1 中 a -> b 的方向定位两侧顶点 c、d
+            int t1 = tris[0], t2 = tris[1];
+            auto opposite = [&](int t, int& from) {
+                const std::array<int, 3>& tr = m_triangles[t];
+                for (int k = 0; k < 3; k++) {
+                    if (tr[k] != a && tr[k] != b) {
+                        from = tr[(k + 1) % 3];
+                        return tr[k];
+                    }
+                }
+                return -1;
+            };
+            int from1 = -1, from2 = -1;
+            int c = opposite(t1, from1);
+            int d = opposite(t2, from2);
+            // t1 = (a, b, c) 时 c 之后是 a
+            if (from1 != a) {
+                std::swap(t1, t2);
+                std::swap(c, d);
             }
-            mapper->SetScalarRange(range[0], range[1]);
+            if (c == d || !EdgeTriangles(c, d).empty()) continue;
+
+            const int before = ValenceExcess(a, 0) + ValenceExcess(b, 0) + ValenceExcess(c, 0) + ValenceExcess(d, 0);
+            const int after = ValenceExcess(a, -1) + ValenceExcess(b, -1) + ValenceExcess(c, 1) + ValenceExcess(d, 1);
+            if (after >= before) continue;
+
+            const gp_Vec reference = TriangleNormal(t1) + TriangleNormal(t2);
+            const gp_Vec n1 = TriangleNormal(m_points[a], m_points[d], m_points[c]);
+            const gp_Vec n2 = TriangleNormal(m_points[b], m_points[c], m_points[d]);
+            if (n1.Dot(reference) <= 0 || n2.Dot(reference) <= 0) continue;
+
+            // (a, b, c) + (b, a, d) -> (a, d, c) + (b, c, d)
+            DetachTriangle(t1, b);
+            DetachTriangle(t2, a);
+            m_triangles[t1] = {a, d, c};
+            m_triangles[t2] = {b, c, d};
+            m_vertexTriangles[d].push_back(t1);
+            m_vertexTriangles[c].push_back(t2);
+        }
+    }
 
-            // --- 在这里创建LUT和scalarBar（如果还没有） ---
-            if (!lut) { // 只在第一次找到有效的scalar时创建LUT
-                lut = vtkSmartPointer<vtkLookupTable>::New();
-                lut->SetHueRange(0.666667, 0.0); // Blue to Red
-                lut->Build();
-                mapper->SetLookupTable(lut);
-            } else { // 如果LUT已存在，也应用到这个mapper
-                mapper->SetLookupTable(lut);
+    //向邻点重心移动（只取切向分量）后投影回曲面；移动导致相邻三角形翻转时保持原位
+    void SmoothTangential()
+    {
+        const size_t n = m_points.size();
+        std::vector<gp_Pnt> newPoints(m_points);
+        std::vector<gp_Pnt2d> newUV(m_uv);
+        for (size_t v = 0; v < n; v++) {
+            if (m_locked[v] || m_vertexTriangles[v].empty()) continue;
+            const std::vector<int> neighbors = Neighbors(static_cast<int>(v));
+            gp_XYZ centroid(0, 0, 0);
+            for (int w : neighbors) centroid += m_points[w].XYZ();
+            centroid /= static_cast<double>(neighbors.size());
+
+            gp_Pnt p;
+            gp_Vec du, dv;
+            m_surface->D1(m_uv[v].X(), m_uv[v].Y(), p, du, dv);
+            gp_Vec normal = du.Crossed(dv);
+            gp_Vec move(centroid - m_points[v].XYZ());
+            if (normal.SquareMagnitude() > 1e-24) {
+                normal.Normalize();
+                move -= normal * move.Dot(normal);
             }
+            Project(m_points[v].Translated(move * 0.5), m_uv[v], newPoints[v], newUV[v]);
+        }
+        for (size_t v = 0; v < n; v++) {
+            if (m_locked[v] || m_vertexTriangles[v].empty()) continue;
+            bool valid = true;
+            for (int t : m_vertexTriangles[v]) {
+                std::array<gp_Pnt, 3> moved;
+                for (int k = 0; k < 3; k++) moved[k] = m_triangles[t][k] == static_cast<int>(v) ? newPoints[v] : m_points[m_triangles[t][k]];
+                if (TriangleNormal(moved[0], moved[1], moved[2]).Dot(TriangleNormal(t)) <= 0) {
+                    valid = false;
+                    break;
+                }
+            }
+            if (valid) {
+                m_points[v] = newPoints[v];
+                m_uv[v] = newUV[v];
+            }
+        }
+    }
 
-            // 在这里创建scalarBar
-            if (!scalarBar) { // 只在第一次找到有效的scalar时创建scalarBar
-                scalarBar = vtkSmartPointer<vtkScalarBarActor>::New();
-                scalarBar->SetLookupTable(lut); // 使用刚创建或已存在的LUT
-                scalarBar->SetTitle(color_name.toStdString().c_str());
-                scalarBar->SetNumberOfLabels(10);
-                scalarBar->SetDragable(true);
+    TopoDS_Face m_face;
+    double m_size;
+    double m_precision;
+    double m_deflection = 0;
+    Handle(Geom_Surface) m_surface;
+    Handle(ShapeAnalysis_Surface) m_analysis;
+    std::vector<gp_Pnt> m_points;
+    std::vector<gp_Pnt2d> m_uv;
+    std::vector<char> m_locked;
+    std::vector<std::array<int, 3>> m_triangles;
+    std::vector<char> m_alive;
+    std::vector<std::vector<int>> m_vertexTriangles;
+    int m_keptBoundaryNodes = 0;
+};
+
+//各向同性重划分：结果写回模型副本各面的三角化，与表面三角网格共用 m_meshedShape 和显示流程
+void MainWindow::RemeshIsotropic(double elementSize)
+{
+    QElapsedTimer timer;
+    timer.start();
 
-                // --- 设置标量条文字颜色和固定字体大小 ---
-                scalarBar->GetLabelTextProperty()->SetColor(0.0, 0.0, 0.0); // 黑色
-                scalarBar->GetLabelTextProperty()->SetFontSize(18); // 固定字体大小
-                scalarBar->GetTitleTextProperty()->SetColor(0.0, 0.0, 0.0); // 黑色
-                scalarBar->GetTitleTextProperty()->SetFontSize(20); // 固定字体大小
+    BRepBuilderAPI_Copy copier(m_currentShape);
+    TopoDS_Shape shape = copier.Shape();
+    std::vector<TopoDS_Face> faces;
+    std::vector<Handle(Poly_Triangulation)> results;
+    int failedFaces = 0;
+    int keptBoundaryNodes = 0;
+    try {
+        // 1. 初始三角化只提供各面的拓扑和 UV 种子
+        BRepMesh_IncrementalMesh mesher(shape, elementSize * kRemeshSeedDeflectionRatio, Standard_False, 0.5, Standard_True);
+        if (!mesher.IsDone()) {
+            QMessageBox::critical(this, tr("网格划分错误"), tr("初始三角化失败！"));
+            return;
+        }
 
-                // 保持颜色条大小固定 (相对窗口大小的比例)
-                scalarBar->SetWidth(0.1);
-                scalarBar->SetHeight(0.8);
+        // 2. 每条拓扑边等分一次，相邻面共用
+        TopTools_IndexedMapOfShape edgeMap;
+        TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
+        std::vector<EdgeSamples> samples(edgeMap.Extent());
+        vtkSMPTools::For(0, static_cast<vtkIdType>(samples.size()), [&](vtkIdType begin, vtkIdType end) {
+            for (vtkIdType i = begin; i < end; ++i) {
+                try {
+                    SampleEdgeUniform(TopoDS::Edge(edgeMap(static_cast<int>(i) + 1)), elementSize, samples[i]);
+                } catch (const Standard_Failure&) {
+                    samples[i] = EdgeSamples();
+                }
+            }
+        });
 
-                // 只添加一次scalarBar到renderer
-                localRenderer->AddActor2D(scalarBar);
+        // 3. 各面并行重划分，三角形多的面先处理
+        for (TopExp_Explorer faceExp(shape, TopAbs_FACE); faceExp.More(); faceExp.Next()) {
+            faces.push_back(TopoDS::Face(faceExp.Current()));
+        }
+        std::vector<int> sizes(faces.size(), 0);
+        for (size_t f = 0; f < faces.size(); f++) {
+            TopLoc_Location loc;
+            Handle(Poly_Triangulation) tri = BRep_Tool::Triangulation(faces[f], loc);
+            if (!tri.IsNull()) sizes[f] = tri->NbTriangles();
+        }
+        std::vector<int> order(faces.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return sizes[a] > sizes[b]; });
+
+        results.resize(faces.size());
+        std::atomic<int> failed(0), kept(0);
+        vtkSMPTools::For(0, static_cast<vtkIdType>(order.size()), 1, [&](vtkIdType begin, vtkIdType end) {
+            for (vtkIdType i = begin; i < end; ++i) {
+                const int f = order[i];
+                try {
+                    TopLoc_Location loc;
+                    Handle(Poly_Triangulation) tri = BRep_Tool::Triangulation(faces[f], loc);
+                    FaceRemesher remesher(faces[f], elementSize);
+                    if (!remesher.Load(tri, loc, edgeMap, samples)) {
+                        failed++;
+                        continue;
+                    }
+                    kept += remesher.KeptBoundaryNodes();
+                    remesher.Remesh(kRemeshIterations);
+                    results[f] = remesher.Result(loc);
+                } catch (const Standard_Failure&) {
+                    failed++;
+                }
             }
+        });
+        failedFaces = failed;
+        keptBoundaryNodes = kept;
+    } catch (const Standard_Failure& e) {
+        QMessageBox::critical(this, tr("网格划分错误"), QString("各向同性重划分失败: %1").arg(e.GetMessageString()));
+        return;
+    }
+
+    // 4. 写回三角化（未能重划分的面保留初始三角化，其边界可能与相邻面不协调）
+    BRep_Builder builder;
+    int numTriangles = 0;
+    for (size_t f = 0; f < faces.size(); f++) {
+        if (results[f].IsNull()) continue;
+        builder.UpdateFace(faces[f], results[f]);
+        numTriangles += results[f]->NbTriangles();
+    }
+    qDebug() << "各向同性重划分: 单元尺寸" << elementSize << "," << faces.size() << "个面," << numTriangles << "个三角形,"
+             << failedFaces << "个面保留初始三角化," << keptBoundaryNodes << "个边界节点未能收缩, 耗时" << timer.elapsed() << "ms";
+
+    m_meshedShape = shape;
+    DisplayMeshedShape(m_meshedShape);
+    QString message = QString("各向同性重划分完成：单元尺寸 %1，%2 个三角形").arg(elementSize).arg(numTriangles);
+    if (failedFaces > 0) {
+        message += QString("\n%1 个面无法重划分，保留了初始三角化").arg(failedFaces);
+    }
+    QMessageBox::information(this, tr("网格划分"), message);
+}
+
+//----------六面体扫掠网格----------|
+#include <QInputDialog>
+#include <Standard_Failure.hxx>
+#include <vtkSMPTools.h>
+#include <vtkCellData.h>
+#include <vtkIntArray.h>
+#include <array>
+
+static inline double SweepDot(const double* a, const double* b) { return a[0]*b[0] + a[1]*b[1] + a[2]*b[2]; }
+
+static inline void SweepCross(const double* a, const double* b, double* out)
+{
+    out[0] = a[1]*b[2] - a[2]*b[1];
+    out[1] = a[2]*b[0] - a[0]*b[2];
+    out[2] = a[0]*b[1] - a[1]*b[0];
+}
+
+static inline void SweepNormalize(double* v)
+{
+    const double len = std::sqrt(SweepDot(v, v));
+    if (len > 0) { v[0] /= len; v[1] /= len; v[2] /= len; }
+}
+
+// 绕单位轴 n 旋转 phi（Rodrigues）
+static inline void SweepRotate(const double* n, double phi, const double* v, double* out)
+{
+    const double c = std::cos(phi), s = std::sin(phi), d = SweepDot(n, v) * (1.0 - c);
+    double nxv[3];
+    SweepCross(n, v, nxv);
+    for (int k = 0; k < 3; ++k) out[k] = v[k] * c + nxv[k] * s + n[k] * d;
+}
+
+static inline double SweepDistance(const double* a, const double* b)
+{
+    const double d[3] = {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+    return std::sqrt(SweepDot(d, d));
+}
 
+// 从管体几何中识别扫掠段：同轴圆柱面合并为直线段，同心圆环面合并为圆环段，
+// 同一段的最大/最小截面半径即外/内壁半径；再按端点首尾相连排成一条链。
+// requireInnerWall 时跳过只有一层壁面的段（扫掠网格需要壁厚），只取中心线时不要求
+static bool ExtractTubeSweepSegments(const TopoDS_Shape& shape, std::vector<TubeSweepSegment>& chain, bool requireInnerWall)
+{
+    struct Primitive {
+        TubeSweepSegment seg;
+        double dir[3];        // 直线段轴向 / 圆环 X 方向
+        double yDir[3];       // 圆环 Y 方向
+        double tMin, tMax;    // 轴向投影范围 / 圆环角度范围
+    };
+    std::vector<Primitive> prims;
+    const double tol = 1e-4;
+
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        const TopoDS_Face face = TopoDS::Face(exp.Current());
+        BRepAdaptor_Surface surf(face);
+        Primitive p = {};
+        double radius = 0.0;
+        if (surf.GetType() == GeomAbs_Cylinder) {
+            const gp_Cylinder cyl = surf.Cylinder();
+            const gp_Pnt o = cyl.Location();
+            const gp_Dir d = cyl.Axis().Direction();
+            p.seg.center[0] = o.X(); p.seg.center[1] = o.Y(); p.seg.center[2] = o.Z();
+            p.dir[0] = d.X(); p.dir[1] = d.Y(); p.dir[2] = d.Z();
+            radius = cyl.Radius();
+            p.tMin = 1e300; p.tMax = -1e300;
+            for (TopExp_Explorer v(face, TopAbs_VERTEX); v.More(); v.Next()) {
+                const gp_Pnt q = BRep_Tool::Pnt(TopoDS::Vertex(v.Current()));
+                const double rel[3] = {q.X() - o.X(), q.Y() - o.Y(), q.Z() - o.Z()};
+                const double t = SweepDot(rel, p.dir);
+                p.tMin = std::min(p.tMin, t);
+                p.tMax = std::max(p.tMax, t);
+            }
+            if (p.tMax <= p.tMin) continue;
+        } else if (surf.GetType() == GeomAbs_Torus) {
+            const gp_Torus torus = surf.Torus();
+            const gp_Ax3 ax = torus.Position();
+            const gp_Pnt o = ax.Location();
+            p.seg.toroidal = true;
+            p.seg.center[0] = o.X(); p.seg.center[1] = o.Y(); p.seg.center[2] = o.Z();
+            p.seg.bendRadius = torus.MajorRadius();
+            p.dir[0] = ax.XDirection().X(); p.dir[1] = ax.XDirection().Y(); p.dir[2] = ax.XDirection().Z();
+            p.yDir[0] = ax.YDirection().X(); p.yDir[1] = ax.YDirection().Y(); p.yDir[2] = ax.YDirection().Z();
+            radius = torus.MinorRadius();
+            double v0, v1;
+            BRepTools::UVBounds(face, p.tMin, p.tMax, v0, v1);
+            if (p.tMax <= p.tMin) continue;
         } else {
-            mapper->SetScalarVisibility(false);
+            continue;
         }
 
-        vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
-        actor->SetMapper(mapper);
-        actor->GetProperty()->EdgeVisibilityOn();
-        actor->GetProperty()->SetAmbient(0.25);
-        if (!useScalar) {
-            actor->GetProperty()->SetColor(0.8, 0.8, 0.8);
+        // 与已有段合并（剖分成多个面的同一圆柱/圆环，以及内外壁）
+        bool merged = false;
+        for (Primitive& q : prims) {
+            if (q.seg.toroidal != p.seg.toroidal) continue;
+            double c[3];
+            SweepCross(q.dir, p.dir, c);
+            const double rel[3] = {p.seg.center[0] - q.seg.center[0], p.seg.center[1] - q.seg.center[1],
+                                   p.seg.center[2] - q.seg.center[2]};
+            bool same;
+            if (p.seg.toroidal) {
+                double qn[3], pn[3];
+                SweepCross(q.dir, q.yDir, qn);
+                SweepCross(p.dir, p.yDir, pn);
+                same = SweepDot(rel, rel) < tol * tol && SweepDot(qn, pn) > 1.0 - tol &&
+                       std::fabs(q.seg.bendRadius - p.seg.bendRadius) < tol &&
+                       SweepDot(q.dir, p.dir) > 1.0 - tol; // X 方向一致时角度范围可直接比较
+            } else {
+                double off[3];
+                SweepCross(rel, q.dir, off);
+                same = SweepDot(c, c) < tol * tol && SweepDot(off, off) < tol * tol;
+                if (same && SweepDot(q.dir, p.dir) < 0) {
+                    // 反向轴：把 p 的投影范围换算到 q 的方向上
+                    const double shift = SweepDot(rel, q.dir);
+                    const double t0 = shift - p.tMax, t1 = shift - p.tMin;
+                    p.tMin = t0; p.tMax = t1;
+                } else if (same) {
+                    const double shift = SweepDot(rel, q.dir);
+                    p.tMin += shift; p.tMax += shift;
+                }
+            }
+            if (!same) continue;
+            q.tMin = std::min(q.tMin, p.tMin);
+            q.tMax = std::max(q.tMax, p.tMax);
+            q.seg.rOut = std::max(q.seg.rOut, radius);
+            q.seg.rIn = std::min(q.seg.rIn, radius);
+            merged = true;
+            break;
+        }
+        if (!merged) {
+            p.seg.rOut = p.seg.rIn = radius;
+            prims.push_back(p);
         }
+    }
 
-        vtkGridsForThisWindow.push_back(reader->GetOutput());
-        vtkActorsForThisWindow.push_back(actor);
-        localRenderer->AddActor(actor);
+    // 端点
+    std::vector<TubeSweepSegment> segs;
+    for (Primitive& p : prims) {
+        if (requireInnerWall && p.seg.rOut - p.seg.rIn < tol) {
+            qDebug() << "扫掠段缺少内壁，已跳过 (R =" << p.seg.rOut << ")";
+            continue;
+        }
+        TubeSweepSegment& s = p.seg;
+        if (s.toroidal) {
+            SweepCross(p.dir, p.yDir, s.axis);
+            SweepNormalize(s.axis);
+            s.angle = p.tMax - p.tMin;
+            for (int k = 0; k < 3; ++k) {
+                s.start[k] = s.center[k] + s.bendRadius * (std::cos(p.tMin) * p.dir[k] + std::sin(p.tMin) * p.yDir[k]);
+                s.end[k] = s.center[k] + s.bendRadius * (std::cos(p.tMax) * p.dir[k] + std::sin(p.tMax) * p.yDir[k]);
+            }
+        } else {
+            for (int k = 0; k < 3; ++k) {
+                s.start[k] = s.center[k] + p.tMin * p.dir[k];
+                s.end[k] = s.center[k] + p.tMax * p.dir[k];
+            }
+        }
+        segs.push_back(s);
+    }
+    if (segs.empty()) return false;
+
+    // 首尾相连：从一个自由端出发贪心连接
+    double joinTol = 0.0;
+    for (const auto& s : segs) joinTol = std::max(joinTol, 0.05 * s.rOut);
+    auto connected = [&](const double* pt, size_t self) {
+        for (size_t j = 0; j < segs.size(); ++j) {
+            if (j == self) continue;
+            if (SweepDistance(pt, segs[j].start) < joinTol || SweepDistance(pt, segs[j].end) < joinTol) return true;
+        }
+        return false;
+    };
+    size_t first = 0;
+    for (size_t i = 0; i < segs.size(); ++i) {
+        if (!connected(segs[i].start, i)) { first = i; break; }
+        if (!connected(segs[i].end, i)) { segs[i].Reverse(); first = i; break; }
     }
 
-    // 检查是否成功添加了任何带有标量的Actor（即是否创建了LUT和scalarBar）
-    if (!lut) {
-        qDebug() << "警告: 没有找到有效的标量数组用于任何输入文件，scalarBar 未创建。";
+    std::vector<bool> used(segs.size(), false);
+    chain.clear();
+    chain.push_back(segs[first]);
+    used[first] = true;
+    for (bool grown = true; grown;) {
+        grown = false;
+        for (size_t j = 0; j < segs.size(); ++j) {
+            if (used[j]) continue;
+            if (SweepDistance(chain.back().end, segs[j].end) < joinTol) segs[j].Reverse();
+            if (SweepDistance(chain.back().end, segs[j].start) < joinTol) {
+                chain.push_back(segs[j]);
+                used[j] = true;
+                grown = true;
+                break;
+            }
+        }
+    }
+    if (chain.size() < segs.size()) {
+        qDebug() << "有" << segs.size() - chain.size() << "个扫掠段未与中心线相连，已忽略";
+    }
+    return true;
+}
+
+// 沿扫掠段链生成结构化六面体：截面为 numThickness x numCircumferential 的环形四边形网格，
+// 相邻段共用连接处的截面节点。各段节点和单元编号可预先确定，按段并行生成
+static void SweepTubeHexMesh(const std::vector<TubeSweepSegment>& chain, int numThickness, int numCircumferential,
+                             double elementSize, TubeHexMesh& mesh)
+{
+    const size_t numSegments = chain.size();
+    mesh = TubeHexMesh();
+    if (numSegments == 0 || numThickness < 1 || numCircumferential < 3 || elementSize <= 0) return;
+
+    // 各段起始截面序号、起始切向和截面参考方向（沿链平行移动）
+    std::vector<vtkIdType> ringStart(numSegments + 1, 0);
+    std::vector<std::array<double, 3>> startTangent(numSegments), startRef(numSegments);
+    double ref[3] = {0.0, 0.0, 0.0};
+    for (size_t i = 0; i < numSegments; ++i) {
+        const TubeSweepSegment& s = chain[i];
+        const int n = std::max(1, static_cast<int>(std::ceil(s.Length() / elementSize)));
+        ringStart[i + 1] = ringStart[i] + n;
+
+        double t[3];
+        if (s.toroidal) {
+            const double rel[3] = {s.start[0] - s.center[0], s.start[1] - s.center[1], s.start[2] - s.center[2]};
+            SweepCross(s.axis, rel, t);
+        } else {
+            for (int k = 0; k < 3; ++k) t[k] = s.end[k] - s.start[k];
+        }
+        SweepNormalize(t);
+
+        if (i == 0) {
+            // 取与切向最不平行的坐标轴
+            int m = 0;
+            for (int k = 1; k < 3; ++k) if (std::fabs(t[k]) < std::fabs(t[m])) m = k;
+            ref[m] = 1.0;
+        }
+        const double along = SweepDot(ref, t);
+        for (int k = 0; k < 3; ++k) ref[k] -= along * t[k];
+        SweepNormalize(ref);
+
+        std::copy(t, t + 3, startTangent[i].begin());
+        std::copy(ref, ref + 3, startRef[i].begin());
+        if (s.toroidal) {
+            double rotated[3];
+            SweepRotate(s.axis, s.angle, ref, rotated);
+            std::copy(rotated, rotated + 3, ref);
+        }
     }
 
-    currentFrame = 0;
+    const vtkIdType numRings = ringStart.back() + 1;
+    const vtkIdType perRing = static_cast<vtkIdType>(numThickness + 1) * numCircumferential;
+    const vtkIdType perSlab = static_cast<vtkIdType>(numThickness) * numCircumferential;
+    mesh.numRings = numRings;
+    mesh.numThickness = numThickness;
+    mesh.numCircumferential = numCircumferential;
+    mesh.points.resize(numRings * perRing * 3);
+    mesh.cells.resize((numRings - 1) * perSlab * 8);
+    mesh.segmentOfCell.resize((numRings - 1) * perSlab);
+
+    std::vector<double> cosTheta(numCircumferential), sinTheta(numCircumferential);
+    for (int c = 0; c < numCircumferential; ++c) {
+        cosTheta[c] = std::cos(2.0 * M_PI * c / numCircumferential);
+        sinTheta[c] = std::sin(2.0 * M_PI * c / numCircumferential);
+    }
 
-    // --- 3. 设置交互器 ---
-    vtkSmartPointer<vtkRenderWindowInteractor> interactor = localRenderWindow->GetInteractor();
-    vtkSmartPointer<vtkInteractorStyleTrackballCamera> style = vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
-    interactor->SetInteractorStyle(style);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(numSegments), 1, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i) {
+            const TubeSweepSegment& s = chain[i];
+            const vtkIdType n = ringStart[i + 1] - ringStart[i];
+
+            // 截面节点：第一段包含起始截面，其余段的起始截面由前一段生成
+            for (vtkIdType k = (i == 0 ? 0 : 1); k <= n; ++k) {
+                const double f = static_cast<double>(k) / n;
+                double center[3], t[3], e1[3], e2[3];
+                if (s.toroidal) {
+                    const double rel[3] = {s.start[0] - s.center[0], s.start[1] - s.center[1], s.start[2] - s.center[2]};
+                    double relRot[3];
+                    SweepRotate(s.axis, f * s.angle, rel, relRot);
+                    SweepRotate(s.axis, f * s.angle, startTangent[i].data(), t);
+                    SweepRotate(s.axis, f * s.angle, startRef[i].data(), e1);
+                    for (int m = 0; m < 3; ++m) center[m] = s.center[m] + relRot[m];
+                } else {
+                    std::copy(startTangent[i].begin(), startTangent[i].end(), t);
+                    std::copy(startRef[i].begin(), startRef[i].end(), e1);
+                    for (int m = 0; m < 3; ++m) center[m] = s.start[m] + f * (s.end[m] - s.start[m]);
+                }
+                SweepCross(t, e1, e2);
+
+                double* out = &mesh.points[(ringStart[i] + k) * perRing * 3];
+                for (int layer = 0; layer <= numThickness; ++layer) {
+                    const double r = s.rIn + (s.rOut - s.rIn) * layer / numThickness;
+                    for (int c = 0; c < numCircumferential; ++c, out += 3) {
+                        for (int m = 0; m < 3; ++m) {
+                            out[m] = center[m] + r * (cosTheta[c] * e1[m] + sinTheta[c] * e2[m]);
+                        }
+                    }
+                }
+            }
 
-    // --- 4. 强制刷新布局和渲染 ---
-    localRenderWindow->Render();
+            // 单元：底面法向（右手定则）指向下一截面
+            for (vtkIdType ring = ringStart[i]; ring < ringStart[i + 1]; ++ring) {
+                vtkIdType* cell = &mesh.cells[ring * perSlab * 8];
+                int* seg = &mesh.segmentOfCell[ring * perSlab];
+                for (int layer = 0; layer < numThickness; ++layer) {
+                    for (int c = 0; c < numCircumferential; ++c, cell += 8) {
+                        const int c1 = (c + 1) % numCircumferential;
+                        const vtkIdType a = ring * perRing;
+                        const vtkIdType ids[4] = {
+                            a + layer * numCircumferential + c,
+                            a + (layer + 1) * numCircumferential + c,
+                            a + (layer + 1) * numCircumferential + c1,
+                            a + layer * numCircumferential + c1};
+                        for (int m = 0; m < 4; ++m) {
+                            cell[m] = ids[m];
+                            cell[m + 4] = ids[m] + perRing;
+                        }
+                        *seg++ = static_cast<int>(i);
+                    }
+                }
+            }
+        }
+    });
+}
 
-    // --- 5. 重置相机以适应模型 ---
-    localRenderer->ResetCamera();
+// 六面体网格转为 VTK 非结构网格
+static vtkSmartPointer<vtkUnstructuredGrid> TubeHexMeshToGrid(const TubeHexMesh& mesh)
+{
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(static_cast<vtkIdType>(mesh.points.size() / 3));
+    std::copy(mesh.points.begin(), mesh.points.end(),
+              static_cast<double*>(points->GetData()->GetVoidPointer(0)));
+
+    const vtkIdType numCells = static_cast<vtkIdType>(mesh.cells.size() / 8);
+    vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+    cells->AllocateExact(numCells, numCells * 8);
+    for (vtkIdType c = 0; c < numCells; ++c) {
+        cells->InsertNextCell(8, &mesh.cells[c * 8]);
+    }
 
-    // --- 6. 再次渲染以应用相机调整 ---
-    localRenderWindow->Render();
+    vtkSmartPointer<vtkIntArray> segment = vtkSmartPointer<vtkIntArray>::New();
+    segment->SetName("Segment");
+    segment->SetNumberOfValues(numCells);
+    std::copy(mesh.segmentOfCell.begin(), mesh.segmentOfCell.end(), segment->GetPointer(0));
 
-    // 显示子窗口并最大化
-    subWindow->showMaximized();
+    vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    grid->SetPoints(points);
+    grid->SetCells(VTK_HEXAHEDRON, cells);
+    grid->GetCellData()->SetScalars(segment);
+    return grid;
 }
 
-//显示S
-void MainWindow::onButtonSClicked()
+//六面体扫掠网格显示
+void MainWindow::DisplayTubeHexMesh(const TubeHexMesh& mesh)
 {
-    // vtkFilePaths是之前获取的VTK文件路径列表
-    VisualVTKGroupFile(vtkFilePaths, "S");
+    // 按扫掠段着色，显示单元边
+    vtkSmartPointer<vtkUnstructuredGrid> grid = TubeHexMeshToGrid(mesh);
+    vtkSmartPointer<vtkDataSetMapper> mapper = vtkSmartPointer<vtkDataSetMapper>::New();
+    mapper->SetInputData(grid);
+    mapper->SetScalarModeToUseCellData();
+    mapper->SetScalarRange(grid->GetCellData()->GetScalars()->GetRange());
+
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper(mapper);
+    actor->GetProperty()->EdgeVisibilityOn();
+    actor->GetProperty()->SetEdgeColor(0, 0, 0);
+
+    // 与表面网格共用 "mesh" 图层，没有面映射
+    SetSceneLayer("mesh", {actor});
+    ShowSceneLayers({"mesh"});
 }
-//显示S_Mises
-void MainWindow::onButtonSMisesClicked()
+
+// 轴向单元长度：0 表示与外壁周向单元等长
+static double HexAxialElementSize(double elementSize, double rOut, int numCircumferential)
 {
-    VisualVTKGroupFile(vtkFilePaths, "S_Mises");
+    return elementSize > 0 ? elementSize : 2.0 * M_PI * rOut / numCircumferential;
 }
-//显示S_Principal
-void MainWindow::onButtonSPrincipalClicked()
+
+//六面体扫掠网格划分：沿中心线扫掠管体截面，网格参数与生成 inp 共用
+void MainWindow::MeshTubeHex()
 {
-    VisualVTKGroupFile(vtkFilePaths, "S_Principal");
+    bool ok = false;
+    int layers = QInputDialog::getInt(this, tr("网格划分"), tr("厚度方向单元数:"), m_hexThicknessLayers, 1, 50, 1, &ok);
+    if (!ok) return;
+    int circumferential = QInputDialog::getInt(this, tr("网格划分"), tr("周向单元数:"), m_hexCircumferential, 8, 1440, 4, &ok);
+    if (!ok) return;
+    double axialSize = QInputDialog::getDouble(this, tr("网格划分"), tr("轴向单元长度 (mm，0 = 与周向单元等长):"),
+                                               m_hexElementSize, 0.0, 1000.0, 3, &ok);
+    if (!ok) return;
+    m_hexThicknessLayers = layers;
+    m_hexCircumferential = circumferential;
+    m_hexElementSize = axialSize;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<TubeSweepSegment> chain;
+    try {
+        if (!ExtractTubeSweepSegments(m_currentShape, chain, true)) {
+            QMessageBox::warning(this, tr("网格划分"), tr("未识别到带内外壁的圆柱/圆环管段，无法扫掠六面体网格！"));
+            return;
+        }
+        double rOut = 0.0;
+        for (const TubeSweepSegment& segment : chain) rOut = std::max(rOut, segment.rOut);
+        SweepTubeHexMesh(chain, m_hexThicknessLayers, m_hexCircumferential,
+                         HexAxialElementSize(m_hexElementSize, rOut, m_hexCircumferential), m_tubeHexMesh);
+    } catch (const Standard_Failure& e) {
+        QMessageBox::critical(this, tr("网格划分错误"), QString("识别管段失败: %1").arg(e.GetMessageString()));
+        return;
+    }
+
+    const vtkIdType numNodes = static_cast<vtkIdType>(m_tubeHexMesh.points.size() / 3);
+    const vtkIdType numCells = static_cast<vtkIdType>(m_tubeHexMesh.cells.size() / 8);
+    qDebug() << "六面体扫掠网格:" << chain.size() << "段," << numNodes << "节点," << numCells << "单元, 耗时" << timer.elapsed() << "ms";
+
+    DisplayTubeHexMesh(m_tubeHexMesh);
+    QMessageBox::information(this, tr("网格划分"),
+        QString("六面体网格划分完成：%1 段，%2 个节点，%3 个单元").arg(chain.size()).arg(numNodes).arg(numCells));
 }
-//显示U
-void MainWindow::onButtonUClicked()
+
+
+//----------网格质量----------|
+//表面三角网格和六面体网格的单元质量：长宽比、最小/最大角、等角偏斜度，六面体另有缩放雅可比。
+//各指标在单元数组上并行计算，直接写入连续的 float 单元数据；切换指标时只重新着色、统计直方图和挑选最差单元
+#include <vtkSMPTools.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkExtractCells.h>
+#include <vtkChartXY.h>
+#include <vtkPlot.h>
+#include <vtkTable.h>
+#include <vtkAxis.h>
+#include <vtkDoubleArray.h>
+#include <vtkContextScene.h>
+#include <vtkTextProperty.h>
+#include <QComboBox>
+#include <QLabel>
+#include <QSpinBox>
+#include <QFormLayout>
+#include <QVBoxLayout>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+// 质量指标：单元数据名、是否越大越差，以及三角形/六面体的常用合格界限
+struct MeshQualityMetric {
+    const char* name;
+    const char* label;
+    bool higherIsWorse;
+    double triangleLimit;
+    double hexLimit;
+};
+static const MeshQualityMetric kMeshQualityMetrics[] = {
+    {"AspectRatio", "长宽比", true, 5.0, 10.0},
+    {"MinAngle", "最小角 (°)", false, 20.0, 45.0},
+    {"MaxAngle", "最大角 (°)", true, 120.0, 135.0},
+    {"Skewness", "偏斜度", true, 0.75, 0.75},
+    {"ScaledJacobian", "缩放雅可比", false, 0.0, 0.2},
+};
+static const int kMeshQualityJacobian = 4;
+
+// 退化单元的长宽比上限，避免直方图范围被无穷大撑开
+static const float kMaxAspectRatio = 1e6f;
+
+static const int kMeshQualityBins = 40;
+
+static inline double QualityAngle(const double* u, const double* v)
 {
-    VisualVTKGroupFile(vtkFilePaths, "U");
+    const double dot = u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+    const double len = std::sqrt((u[0] * u[0] + u[1] * u[1] + u[2] * u[2]) * (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]));
+    if (len <= 0) return 0.0;
+    return std::acos(std::max(-1.0, std::min(1.0, dot / len))) * (180.0 / M_PI);
+}
+
+//三角形：长宽比 lmax·(l0+l1+l2)/(4√3·A)（正三角形为 1），等角偏斜度 max((θmax-60)/120, (60-θmin)/60)
+template <typename Index>
+static void TriangleQuality(const double* pts, const Index* tris, vtkIdType numCells, float* aspect, float* minAngle,
+                            float* maxAngle, float* skew)
+{
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType c = begin; c < end; ++c) {
+            const double* p[3] = {pts + static_cast<size_t>(tris[c * 3]) * 3, pts + static_cast<size_t>(tris[c * 3 + 1]) * 3,
+                                  pts + static_cast<size_t>(tris[c * 3 + 2]) * 3};
+            double e[3][3];
+            double len[3];
+            for (int k = 0; k < 3; ++k) {
+                const double* a = p[k];
+                const double* b = p[(k + 1) % 3];
+                e[k][0] = b[0] - a[0];
+                e[k][1] = b[1] - a[1];
+                e[k][2] = b[2] - a[2];
+                len[k] = std::sqrt(e[k][0] * e[k][0] + e[k][1] * e[k][1] + e[k][2] * e[k][2]);
+            }
+            const double cr[3] = {e[0][1] * e[2][2] - e[0][2] * e[2][1], e[0][2] * e[2][0] - e[0][0] * e[2][2],
+                                  e[0][0] * e[2][1] - e[0][1] * e[2][0]};
+            const double area = 0.5 * std::sqrt(cr[0] * cr[0] + cr[1] * cr[1] + cr[2] * cr[2]);
+            const double lmax = std::max(len[0], std::max(len[1], len[2]));
+            aspect[c] = area > 0 ? static_cast<float>(std::min<double>(kMaxAspectRatio, lmax * (len[0] + len[1] + len[2]) / (4.0 * std::sqrt(3.0) * area)))
+                                 : kMaxAspectRatio;
+
+            // 顶点 k 的内角：边 k（k -> k+1）与边 k-1 反向的夹角
+            double lo = 180.0, hi = 0.0;
+            for (int k = 0; k < 3; ++k) {
+                const double* prev = e[(k + 2) % 3];
+                const double back[3] = {-prev[0], -prev[1], -prev[2]};
+                const double angle = QualityAngle(e[k], back);
+                lo = std::min(lo, angle);
+                hi = std::max(hi, angle);
+            }
+            minAngle[c] = static_cast<float>(lo);
+            maxAngle[c] = static_cast<float>(hi);
+            skew[c] = static_cast<float>(std::max((hi - 60.0) / 120.0, (60.0 - lo) / 60.0));
+        }
+    });
+}
+
+//六面体（VTK 节点顺序）：长宽比为最长/最短棱，角度取 8 个角点处三条棱两两夹角（即各面的角），
+//偏斜度 max((θmax-90)/90, (90-θmin)/90)，缩放雅可比为各角点三条棱的归一化混合积的最小值
+static void HexahedronQuality(const double* pts, const vtkIdType* cells, vtkIdType numCells, float* aspect, float* minAngle,
+                              float* maxAngle, float* skew, float* jacobian)
+{
+    // 每个角点的三个相邻节点，顺序使正常单元的混合积为正
+    static const int kCornerNeighbors[8][3] = {{1, 3, 4}, {2, 0, 5}, {3, 1, 6}, {0, 2, 7},
+                                               {7, 5, 0}, {4, 6, 1}, {5, 7, 2}, {6, 4, 3}};
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType c = begin; c < end; ++c) {
+            const vtkIdType* cell = cells + c * 8;
+            double lmin = std::numeric_limits<double>::max(), lmax = 0.0;
+            double lo = 180.0, hi = 0.0, jmin = 1.0;
+            for (int i = 0; i < 8; ++i) {
+                const double* o = pts + cell[i] * 3;
+                double e[3][3], len[3];
+                for (int k = 0; k < 3; ++k) {
+                    const double* q = pts + cell[kCornerNeighbors[i][k]] * 3;
+                    e[k][0] = q[0] - o[0];
+                    e[k][1] = q[1] - o[1];
+                    e[k][2] = q[2] - o[2];
+                    len[k] = std::sqrt(e[k][0] * e[k][0] + e[k][1] * e[k][1] + e[k][2] * e[k][2]);
+                    lmin = std::min(lmin, len[k]);
+                    lmax = std::max(lmax, len[k]);
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double angle = QualityAngle(e[k], e[(k + 1) % 3]);
+                    lo = std::min(lo, angle);
+                    hi = std::max(hi, angle);
+                }
+                const double det = e[0][0] * (e[1][1] * e[2][2] - e[1][2] * e[2][1]) -
+                                   e[0][1] * (e[1][0] * e[2][2] - e[1][2] * e[2][0]) +
+                                   e[0][2] * (e[1][0] * e[2][1] - e[1][1] * e[2][0]);
+                const double scale = len[0] * len[1] * len[2];
+                jmin = std::min(jmin, scale > 0 ? det / scale : -1.0);
+            }
+            aspect[c] = lmin > 0 ? static_cast<float>(std::min<double>(kMaxAspectRatio, lmax / lmin)) : kMaxAspectRatio;
+            minAngle[c] = static_cast<float>(lo);
+            maxAngle[c] = static_cast<float>(hi);
+            skew[c] = static_cast<float>(std::max((hi - 90.0) / 90.0, (90.0 - lo) / 90.0));
+            jacobian[c] = static_cast<float>(jmin);
+        }
+    });
+}
+
+static vtkSmartPointer<vtkFloatArray> NewQualityArray(const char* name, vtkIdType numCells)
+{
+    vtkSmartPointer<vtkFloatArray> array = vtkSmartPointer<vtkFloatArray>::New();
+    array->SetName(name);
+    array->SetNumberOfValues(numCells);
+    return array;
+}
+
+//计算网格质量：hex 为 true 时用六面体扫掠网格，否则用表面网格（合并共享顶点后的三角形）
+bool MainWindow::BuildMeshQuality(bool hex)
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_meshQuality = MeshQuality();
+    m_meshQuality.hex = hex;
+
+    std::vector<vtkSmartPointer<vtkFloatArray>> arrays;
+    if (hex) {
+        if (m_tubeHexMesh.cells.empty()) return false;
+        vtkSmartPointer<vtkUnstructuredGrid> grid = TubeHexMeshToGrid(m_tubeHexMesh);
+        const vtkIdType numCells = static_cast<vtkIdType>(m_tubeHexMesh.cells.size() / 8);
+        for (const auto& metric : kMeshQualityMetrics) arrays.push_back(NewQualityArray(metric.name, numCells));
+        HexahedronQuality(m_tubeHexMesh.points.data(), m_tubeHexMesh.cells.data(), numCells, arrays[0]->GetPointer(0),
+                          arrays[1]->GetPointer(0), arrays[2]->GetPointer(0), arrays[3]->GetPointer(0),
+                          arrays[kMeshQualityJacobian]->GetPointer(0));
+        m_meshQuality.dataSet = grid;
+    } else {
+        if (m_meshedShape.IsNull()) return false;
+        WeldedMesh mesh;
+        CollectFaceTriangulations(m_meshedShape, mesh);
+        WeldVertices(mesh);
+        const vtkIdType numCells = static_cast<vtkIdType>(mesh.faceIds.size());
+        if (numCells == 0) return false;
+        for (int m = 0; m < kMeshQualityJacobian; ++m) arrays.push_back(NewQualityArray(kMeshQualityMetrics[m].name, numCells));
+        TriangleQuality(mesh.points.data(), mesh.triangles.data(), numCells, arrays[0]->GetPointer(0),
+                        arrays[1]->GetPointer(0), arrays[2]->GetPointer(0), arrays[3]->GetPointer(0));
+        m_meshQuality.dataSet = WeldedMeshToPolyData(mesh);
+        m_meshQuality.faces = std::move(mesh.faces);
+    }
+    for (const auto& array : arrays) {
+        m_meshQuality.dataSet->GetCellData()->AddArray(array);
+    }
+    qDebug() << "网格质量:" << m_meshQuality.dataSet->GetNumberOfCells() << (hex ? "个六面体" : "个三角形") << ", 耗时"
+             << timer.elapsed() << "ms";
+    return true;
+}
+
+//按指标着色网格、统计直方图并高亮最差的 worstCount 个单元
+void MainWindow::ShowMeshQuality(int metric, int worstCount)
+{
+    vtkPointSet* dataSet = m_meshQuality.dataSet;
+    if (!dataSet) return;
+    const MeshQualityMetric& info = kMeshQualityMetrics[metric];
+    vtkFloatArray* values = vtkFloatArray::SafeDownCast(dataSet->GetCellData()->GetArray(info.name));
+    if (!values) return;
+    const vtkIdType numCells = values->GetNumberOfValues();
+    const float* v = values->GetPointer(0);
+    const double limit = m_meshQuality.hex ? info.hexLimit : info.triangleLimit;
+
+    // 1. 并行统计范围、均值和不合格单元数
+    struct Stats {
+        double lo = std::numeric_limits<double>::max();
+        double hi = -std::numeric_limits<double>::max();
+        double sum = 0;
+        vtkIdType bad = 0;
+    };
+    vtkSMPThreadLocal<Stats> localStats;
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        Stats& s = localStats.Local();
+        for (vtkIdType c = begin; c < end; ++c) {
+            s.lo = std::min(s.lo, double(v[c]));
+            s.hi = std::max(s.hi, double(v[c]));
+            s.sum += v[c];
+            s.bad += info.higherIsWorse ? v[c] > limit : v[c] < limit;
+        }
+    });
+    Stats stats;
+    for (const Stats& s : localStats) {
+        stats.lo = std::min(stats.lo, s.lo);
+        stats.hi = std::max(stats.hi, s.hi);
+        stats.sum += s.sum;
+        stats.bad += s.bad;
+    }
+
+    // 2. 直方图：长宽比的上界截到合格界限的 4 倍，超出的计入最后一格
+    double range[2] = {stats.lo, stats.hi};
+    if (metric == 0) range[1] = std::min(range[1], 4.0 * limit);
+    if (range[1] <= range[0]) range[1] = range[0] + 1e-6;
+    const double binWidth = (range[1] - range[0]) / kMeshQualityBins;
+    vtkSMPThreadLocal<std::vector<vtkIdType>> localBins;
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        std::vector<vtkIdType>& bins = localBins.Local();
+        bins.resize(kMeshQualityBins, 0);
+        for (vtkIdType c = begin; c < end; ++c) {
+            const int b = static_cast<int>((v[c] - range[0]) / binWidth);
+            bins[std::max(0, std::min(kMeshQualityBins - 1, b))]++;
+        }
+    });
+    std::vector<vtkIdType> bins(kMeshQualityBins, 0);
+    for (const auto& local : localBins) {
+        for (size_t b = 0; b < local.size(); ++b) bins[b] += local[b];
+    }
+
+    // 3. 最差单元
+    worstCount = static_cast<int>(std::min<vtkIdType>(worstCount, numCells));
+    std::vector<vtkIdType> order(numCells);
+    std::iota(order.begin(), order.end(), 0);
+    auto worse = [&](vtkIdType a, vtkIdType b) { return info.higherIsWorse ? v[a] > v[b] : v[a] < v[b]; };
+    std::partial_sort(order.begin(), order.begin() + worstCount, order.end(), worse);
+    vtkSmartPointer<vtkIdList> worstIds = vtkSmartPointer<vtkIdList>::New();
+    for (int i = 0; i < worstCount; ++i) worstIds->InsertNextId(order[i]);
+
+    // 4. 场景 "mesh" 图层：按指标着色的网格、红色最差单元和色标（不合格一端为红色）
+    dataSet->GetCellData()->SetActiveScalars(info.name);
+    vtkSmartPointer<vtkLookupTable> lut = vtkSmartPointer<vtkLookupTable>::New();
+    if (info.higherIsWorse) {
+        lut->SetHueRange(0.666667, 0.0);
+    } else {
+        lut->SetHueRange(0.0, 0.666667);
+    }
+    lut->SetTableRange(range);
+    lut->Build();
+    vtkSmartPointer<vtkDataSetMapper> mapper = vtkSmartPointer<vtkDataSetMapper>::New();
+    mapper->SetInputData(dataSet);
+    mapper->SetLookupTable(lut);
+    mapper->SetScalarModeToUseCellData();
+    mapper->SetScalarRange(range);
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper(mapper);
+    actor->GetProperty()->EdgeVisibilityOn();
+    actor->GetProperty()->SetEdgeColor(0.2, 0.2, 0.2);
+
+    vtkSmartPointer<vtkExtractCells> extract = vtkSmartPointer<vtkExtractCells>::New();
+    extract->SetInputData(dataSet);
+    extract->SetCellList(worstIds);
+    extract->Update();
+    vtkSmartPointer<vtkDataSetMapper> worstMapper = vtkSmartPointer<vtkDataSetMapper>::New();
+    worstMapper->SetInputConnection(extract->GetOutputPort());
+    worstMapper->ScalarVisibilityOff();
+    vtkSmartPointer<vtkActor> worstActor = vtkSmartPointer<vtkActor>::New();
+    worstActor->SetMapper(worstMapper);
+    worstActor->GetProperty()->SetRepresentationToWireframe();
+    worstActor->GetProperty()->SetColor(1.0, 0.0, 1.0);
+    worstActor->GetProperty()->SetLineWidth(3.0);
+
+    vtkSmartPointer<vtkScalarBarActor> scalarBar = vtkSmartPointer<vtkScalarBarActor>::New();
+    scalarBar->SetLookupTable(lut);
+    scalarBar->SetTitle(info.name);
+    scalarBar->SetNumberOfLabels(6);
+    scalarBar->GetLabelTextProperty()->SetColor(0.0, 0.0, 0.0);
+    scalarBar->GetTitleTextProperty()->SetColor(0.0, 0.0, 0.0);
+    scalarBar->SetWidth(0.1);
+    scalarBar->SetHeight(0.8);
+
+    SetSceneLayer("mesh", {actor, worstActor, scalarBar});
+    if (!m_meshQuality.hex) m_layerFaces["mesh"] = m_meshQuality.faces;
+    ShowSceneLayers({"mesh"}, false);
+
+    // 5. 直方图
+    if (m_qualityChartView) {
+        vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+        vtkSmartPointer<vtkDoubleArray> centerCol = vtkSmartPointer<vtkDoubleArray>::New();
+        centerCol->SetName(info.name);
+        vtkSmartPointer<vtkDoubleArray> countCol = vtkSmartPointer<vtkDoubleArray>::New();
+        countCol->SetName("Count");
+        table->AddColumn(centerCol);
+        table->AddColumn(countCol);
+        table->SetNumberOfRows(kMeshQualityBins);
+        for (int b = 0; b < kMeshQualityBins; ++b) {
+            table->SetValue(b, 0, range[0] + (b + 0.5) * binWidth);
+            table->SetValue(b, 1, static_cast<double>(bins[b]));
+        }
+        vtkContextScene* scene = m_qualityChartView->GetScene();
+        scene->ClearItems();
+        vtkSmartPointer<vtkChartXY> chart = vtkSmartPointer<vtkChartXY>::New();
+        scene->AddItem(chart);
+        vtkPlot* bar = chart->AddPlot(vtkChart::BAR);
+        bar->SetInputData(table, 0, 1);
+        bar->SetColor(31, 119, 180, 255);
+        chart->SetTitle(info.name);
+        chart->GetAxis(vtkAxis::BOTTOM)->SetTitle(info.name);
+        chart->GetAxis(vtkAxis::LEFT)->SetTitle("Count");
+        m_qualityChartView->GetRenderWindow()->Render();
+    }
+
+    if (m_qualitySummary) {
+        QString worstText;
+        for (int i = 0; i < std::min(worstCount, 5); ++i) {
+            worstText += QString("%1#%2=%3").arg(i ? ", " : "").arg(order[i] + 1).arg(v[order[i]], 0, 'g', 4);
+        }
+        m_qualitySummary->setText(QString("%1 个单元  最小 %2  平均 %3  最大 %4\n超出界限 %5 的单元: %6 (%7%)\n最差: %8")
+                                      .arg(numCells)
+                                      .arg(stats.lo, 0, 'g', 4)
+                                      .arg(stats.sum / std::max<vtkIdType>(1, numCells), 0, 'g', 4)
+                                      .arg(stats.hi, 0, 'g', 4)
+                                      .arg(limit)
+                                      .arg(stats.bad)
+                                      .arg(100.0 * stats.bad / std::max<vtkIdType>(1, numCells), 0, 'f', 2)
+                                      .arg(worstText));
+    }
+}
+
+//网格质量面板：选择网格和指标，指标数据只在切换网格时重算
+void MainWindow::onMeshQualityClicked()
+{
+    const bool hasSurface = !m_meshedShape.IsNull();
+    const bool hasHex = !m_tubeHexMesh.cells.empty();
+    if (!hasSurface && !hasHex) {
+        QMessageBox::warning(this, "警告", "请先划分网格！");
+        return;
+    }
+
+    if (m_qualityPanel) m_qualityPanel->close();
+    QDialog* panel = new QDialog(this);
+    m_qualityPanel = panel;
+    panel->setWindowTitle("网格质量");
+    panel->setAttribute(Qt::WA_DeleteOnClose);
+    panel->resize(560, 480);
+    QVBoxLayout* layout = new QVBoxLayout(panel);
+    QFormLayout* form = new QFormLayout();
+    layout->addLayout(form);
+    QComboBox* sourceCombo = new QComboBox(panel);
+    if (hasSurface) sourceCombo->addItem("表面三角网格", false);
+    if (hasHex) sourceCombo->addItem("六面体扫掠网格", true);
+    // 默认评估当前网格类型对应的网格
+    const int preferred = sourceCombo->findData(ui->comboBox_MeshType->currentIndex() == 1);
+    if (preferred >= 0) sourceCombo->setCurrentIndex(preferred);
+    QComboBox* metricCombo = new QComboBox(panel);
+    QSpinBox* worstSpin = new QSpinBox(panel);
+    worstSpin->setRange(1, 10000);
+    worstSpin->setValue(m_qualityWorstCount);
+    form->addRow("网格:", sourceCombo);
+    form->addRow("指标:", metricCombo);
+    form->addRow("高亮最差单元数:", worstSpin);
+    m_qualitySummary = new QLabel(panel);
+    layout->addWidget(m_qualitySummary);
+
+    QVTKOpenGLNativeWidget* vtkWidget = new QVTKOpenGLNativeWidget(panel);
+    vtkWidget->setMinimumHeight(280);
+    layout->addWidget(vtkWidget, 1);
+    vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow = vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
+    vtkWidget->setRenderWindow(renderWindow);
+    m_qualityChartView = vtkSmartPointer<vtkContextView>::New();
+    m_qualityChartView->SetRenderWindow(renderWindow);
+    m_qualityChartView->GetRenderer()->SetBackground(1, 1, 1);
+    connect(panel, &QObject::destroyed, this, [this]() { m_qualityChartView = nullptr; });
+
+    auto update = [this, metricCombo, worstSpin]() {
+        if (metricCombo->currentIndex() < 0) return;
+        m_qualityWorstCount = worstSpin->value();
+        ShowMeshQuality(metricCombo->currentData().toInt(), m_qualityWorstCount);
+    };
+    auto rebuild = [this, panel, sourceCombo, metricCombo, update]() {
+        const bool hex = sourceCombo->currentData().toBool();
+        if (!BuildMeshQuality(hex)) {
+            QMessageBox::warning(panel, "警告", "网格中没有可评估的单元！");
+            return;
+        }
+        const int previous = metricCombo->currentIndex() >= 0 ? metricCombo->currentData().toInt() : 0;
+        QSignalBlocker blocker(metricCombo);
+        metricCombo->clear();
+        for (int m = 0; m < static_cast<int>(sizeof(kMeshQualityMetrics) / sizeof(kMeshQualityMetrics[0])); ++m) {
+            if (m == kMeshQualityJacobian && !hex) continue;
+            metricCombo->addItem(kMeshQualityMetrics[m].label, m);
+        }
+        metricCombo->setCurrentIndex(std::max(0, metricCombo->findData(previous)));
+        update();
+    };
+    connect(sourceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), panel, rebuild);
+    connect(metricCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), panel, update);
+    connect(worstSpin, QOverload<int>::of(&QSpinBox::valueChanged), panel, update);
+
+    panel->show();
+    rebuild();
+}
+
+//----------过程可视化----------|
+//原始模型（图层已存在时只切换显示，不重新三角化和上传）
+void MainWindow::init_model(){
+    if (HasSceneLayer("original")) {
+        ShowSceneLayers({"original"});
+    } else if (!m_currentShape.IsNull()) {
+        DisplayShape(m_currentShape, "original");
+    } else {
+        QMessageBox::warning(this, "错误", "没有可用模型！");
+    }
+}
+//网格模型
+void MainWindow::mesh_model(){
+    if (HasSceneLayer("mesh")) {
+        ShowSceneLayers({"mesh"});
+    } else if (!m_meshedShape.IsNull()) {
+        DisplayMeshedShape(m_meshedShape);
+    } else if (!m_tubeHexMesh.cells.empty()) {
+        DisplayTubeHexMesh(m_tubeHexMesh);
+    } else {
+        QMessageBox::warning(this, "错误", "没有可用模型！");
+    }
+}
+//表面模型
+void MainWindow::surface_model(){
+    if (HasSceneLayer("surface")) {
+        ShowSceneLayers({"surface"});
+    } else if (!m_extractedOuterSurface.IsNull()) {
+        DisplayShape(m_extractedOuterSurface, "surface");
+    } else {
+        QMessageBox::warning(this, "错误", "没有可用模型！");
+    }
+}
+//中线模型
+void MainWindow::centerline_model(){
+    if (HasSceneLayer("centerline")) {
+        ShowSceneLayers({"centerline"});
+    } else if (!m_extractedOuterSurface.IsNull() && !m_extractedCenterline.IsNull()) {
+        DisplayOuterSurfaceAndCenterline(m_extractedOuterSurface, m_extractedCenterline);
+    } else {
+        QMessageBox::warning(this, "错误", "没有可用模型！");
+    }
+}
+
+
+//----------结果可视化----------|
+#include <vtkTextProperty.h>
+#include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <QStatusBar>
+#include <QCollator>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QXmlStreamReader>
+#include <vtkXMLUnstructuredGridReader.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnsignedShortArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkSMPTools.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtk_hdf5.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// 双精度 -> 单精度（SSE2 每次转换 4 个值）
+static void ConvertDoubleToFloat(const double* src, float* dst, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+        __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+        __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = static_cast<float>(src[i]);
+    }
+}
+
+// 交错存储的多分量数据按分量范围量化为 16 位：q = round((v - min) * inv)
+// 以 4 * numComponents 个值为一块，块内各通道对应的分量是固定的，可直接向量化
+static void QuantizeDoubleToU16(const double* src, uint16_t* dst, size_t n, int numComponents,
+                                const double* compMin, const double* compInv)
+{
+    if (numComponents <= 0) return;
+    const size_t block = 4 * static_cast<size_t>(numComponents);
+    std::vector<double> pMin(block), pInv(block);
+    for (size_t k = 0; k < block; ++k) {
+        pMin[k] = compMin[k % numComponents];
+        pInv[k] = compInv[k % numComponents];
+    }
+
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d qmax = _mm_set1_pd(65535.0);
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (; i + block <= n; i += block) {
+        for (size_t k = 0; k < block; k += 4) {
+            __m128d a = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(src + i + k), _mm_loadu_pd(&pMin[k])), _mm_loadu_pd(&pInv[k]));
+            __m128d b = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(src + i + k + 2), _mm_loadu_pd(&pMin[k + 2])), _mm_loadu_pd(&pInv[k + 2]));
+            a = _mm_min_pd(_mm_max_pd(a, zero), qmax);
+            b = _mm_min_pd(_mm_max_pd(b, zero), qmax);
+            // 4 个 int32，平移到有符号范围后饱和打包，再翻转符号位得到无符号 16 位
+            __m128i q = _mm_unpacklo_epi64(_mm_cvtpd_epi32(a), _mm_cvtpd_epi32(b));
+            q = _mm_sub_epi32(q, bias32);
+            q = _mm_xor_si128(_mm_packs_epi32(q, q), bias16);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i + k), q);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const size_t c = i % numComponents;
+        double q = (src[i] - compMin[c]) * compInv[c];
+        q = std::min(std::max(q, 0.0), 65535.0);
+        dst[i] = static_cast<uint16_t>(std::lrint(q));
+    }
+}
+
+double ResultField::Value(vtkIdType tuple, int comp) const
+{
+    const size_t idx = static_cast<size_t>(tuple) * numComponents + comp;
+    switch (precision) {
+    case ResultPrecision::Float32:
+        return f32[idx];
+    case ResultPrecision::Quantized16:
+        return compMin[comp] + q16[idx] * compScale[comp];
+    default:
+        return f64[idx];
+    }
+}
+
+void ResultField::Tuple(vtkIdType tuple, double* out) const
+{
+    for (int c = 0; c < numComponents; ++c) {
+        out[c] = Value(tuple, c);
+    }
 }
 
+vtkSmartPointer<vtkDataArray> ResultField::ToVTKArray() const
+{
+    vtkSmartPointer<vtkDoubleArray> array = vtkSmartPointer<vtkDoubleArray>::New();
+    array->SetName(name.c_str());
+    array->SetNumberOfComponents(numComponents);
+    array->SetNumberOfTuples(numTuples);
+    double* out = array->GetPointer(0);
+    const size_t n = static_cast<size_t>(numTuples) * numComponents;
+    switch (precision) {
+    case ResultPrecision::Float32:
+        std::copy(f32.begin(), f32.end(), out);
+        break;
+    case ResultPrecision::Quantized16:
+        for (size_t i = 0; i < n; ++i) {
+            const size_t c = i % numComponents;
+            out[i] = compMin[c] + q16[i] * compScale[c];
+        }
+        break;
+    default:
+        std::copy(f64.begin(), f64.end(), out);
+        break;
+    }
+    return array;
+}
+
+size_t ResultField::ByteSize() const
+{
+    return f64.size() * sizeof(double) + f32.size() * sizeof(float) + q16.size() * sizeof(uint16_t);
+}
+
+const ResultField* ResultFrame::Field(const std::string& name) const
+{
+    for (const auto& field : fields) {
+        if (field.name == name) return &field;
+    }
+    return nullptr;
+}
+
+//网格只计拓扑和坐标：绑定着色的数组多数直接引用场存储，不能再按网格重复计入
+size_t ResultFrame::ByteSize() const
+{
+    size_t bytes = boundBytes;
+    if (grid) {
+        const unsigned long gridKiB = grid->GetActualMemorySize();
+        const unsigned long pointDataKiB = grid->GetPointData()->GetActualMemorySize();
+        bytes += static_cast<size_t>(gridKiB > pointDataKiB ? gridKiB - pointDataKiB : 0) * 1024;
+    }
+    for (const auto& field : fields) {
+        bytes += field.ByteSize();
+    }
+    return bytes;
+}
+
+void BoundResultField::ValueRange(double range[2]) const
+{
+    array->GetRange(range, array->GetNumberOfComponents() > 1 ? -1 : 0);
+    range[0] = offset + range[0] * scale;
+    range[1] = offset + range[1] * scale;
+}
+
+void BoundResultField::ArrayRange(const double valueRange[2], double out[2]) const
+{
+    if (scale <= 0.0) {
+        out[0] = 0.0;
+        out[1] = 1.0;
+        return;
+    }
+    out[0] = (valueRange[0] - offset) / scale;
+    out[1] = (valueRange[1] - offset) / scale;
+}
+
+// 结果文件格式，按文件头识别（不依赖扩展名）
+enum class ResultFileFormat { Unknown, LegacyVTK, XMLUnstructuredGrid, PVDCollection, VTKHDF };
+
+static ResultFileFormat DetectResultFileFormat(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return ResultFileFormat::Unknown;
+    const QByteArray head = file.read(512);
+    if (head.startsWith("\x89HDF\r\n\x1a\n")) return ResultFileFormat::VTKHDF;
+    if (head.startsWith("# vtk DataFile")) return ResultFileFormat::LegacyVTK;
+    const int tag = head.indexOf("<VTKFile");
+    if (tag >= 0) {
+        const QByteArray rest = head.mid(tag);
+        if (rest.contains("type=\"Collection\"")) return ResultFileFormat::PVDCollection;
+        if (rest.contains("type=\"UnstructuredGrid\"")) return ResultFileFormat::XMLUnstructuredGrid;
+    }
+    return ResultFileFormat::Unknown;
+}
+
+// VTKHDF 中的一步用 "文件#步号" 作为帧路径
+static bool SplitHDFFramePath(const QString& framePath, QString& file, int& step)
+{
+    const int hash = framePath.lastIndexOf('#');
+    if (hash < 0) return false;
+    bool ok = false;
+    step = framePath.mid(hash + 1).toInt(&ok);
+    file = framePath.left(hash);
+    return ok;
+}
+
+// 帧的版本戳：文件大小和修改时间；VTKHDF 的步取所在文件的戳，文件被改写后各步都会重新读取
+static void ResultFrameStamp(const QString& framePath, qint64& size, qint64& mtime)
+{
+    QString file;
+    int step = 0;
+    const QFileInfo info(SplitHDFFramePath(framePath, file, step) ? file : framePath);
+    size = info.size();
+    mtime = info.lastModified().toMSecsSinceEpoch();
+}
+
+// PVD 集合中的数据文件（只取 part 0），按 timestep 排序，路径相对 PVD 所在目录
+static QStringList ReadPVDCollection(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+    std::vector<std::pair<double, QString>> entries;
+    const QDir dir = QFileInfo(path).absoluteDir();
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != QLatin1String("DataSet")) continue;
+        const QXmlStreamAttributes attrs = xml.attributes();
+        if (attrs.hasAttribute("part") && attrs.value("part").toInt() != 0) continue;
+        const QString fileName = attrs.value("file").toString();
+        if (fileName.isEmpty()) continue;
+        entries.emplace_back(attrs.value("timestep").toDouble(), QDir::cleanPath(dir.absoluteFilePath(fileName)));
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    QStringList files;
+    for (const auto& e : entries) files << e.second;
+    return files;
+}
+
+// 随 VTK 编译的 HDF5 不是线程安全版本，所有 HDF5 调用（以及 VTKHDF 拓扑缓存）串行执行；
+// 结果帧会在 vtkSMPTools 工作线程中流式读取
+static std::mutex& HDF5Mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// 读取 HDF5 数据集第 [first, first+count) 行（count < 0 表示到末尾），返回列数
+template <typename T>
+static bool ReadHDFRows(hid_t file, const char* name, hid_t memType, hsize_t first, hssize_t count,
+                        std::vector<T>& out, hsize_t& cols)
+{
+    if (H5Lexists(file, name, H5P_DEFAULT) <= 0) return false;
+    const hid_t dset = H5Dopen(file, name, H5P_DEFAULT);
+    if (dset < 0) return false;
+    const hid_t space = H5Dget_space(dset);
+    const int rank = H5Sget_simple_extent_ndims(space);
+    hsize_t dims[2] = {0, 1};
+    H5Sget_simple_extent_dims(space, dims, nullptr);
+    cols = rank > 1 ? dims[1] : 1;
+    const hsize_t rows = count < 0 ? (first < dims[0] ? dims[0] - first : 0) : static_cast<hsize_t>(count);
+    bool ok = rank >= 1 && rank <= 2 && first + rows <= dims[0];
+    if (ok) {
+        out.resize(rows * cols);
+        hsize_t start[2] = {first, 0}, extent[2] = {rows, cols};
+        H5Sselect_hyperslab(space, H5S_SELECT_SET, start, nullptr, extent, nullptr);
+        const hid_t mem = H5Screate_simple(rank, extent, nullptr);
+        ok = rows == 0 || H5Dread(dset, memType, mem, space, H5P_DEFAULT, out.data()) >= 0;
+        H5Sclose(mem);
+    }
+    H5Sclose(space);
+    H5Dclose(dset);
+    return ok;
+}
+
+// 读取一个整数标量：数据集 name 的第 index 个值，不存在时返回 fallback
+static long long ReadHDFInteger(hid_t file, const char* name, hsize_t index, long long fallback)
+{
+    std::vector<long long> v;
+    hsize_t cols = 1;
+    return ReadHDFRows(file, name, H5T_NATIVE_LLONG, index, 1, v, cols) && !v.empty() ? v[0] : fallback;
+}
+
+// VTKHDF 的步数：有 Steps 组时取其 NSteps 属性，否则为单步静态数据
+static int VTKHDFNumberOfSteps(const QString& path)
+{
+    std::lock_guard<std::mutex> lock(HDF5Mutex());
+    H5Eset_auto(H5E_DEFAULT, nullptr, nullptr); // 可选数据集缺失属正常情况，不打印 HDF5 错误栈
+    const hid_t file = H5Fopen(QFile::encodeName(path).constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0) return 0;
+    int steps = 0;
+    if (H5Lexists(file, "/VTKHDF", H5P_DEFAULT) > 0) {
+        steps = 1;
+        if (H5Lexists(file, "/VTKHDF/Steps", H5P_DEFAULT) > 0 &&
+            H5Aexists_by_name(file, "/VTKHDF/Steps", "NSteps", H5P_DEFAULT) > 0) {
+            const hid_t attr = H5Aopen_by_name(file, "/VTKHDF/Steps", "NSteps", H5P_DEFAULT, H5P_DEFAULT);
+            long long n = 0;
+            if (H5Aread(attr, H5T_NATIVE_LLONG, &n) >= 0) steps = static_cast<int>(n);
+            H5Aclose(attr);
+        }
+    }
+    H5Fclose(file);
+    return steps;
+}
+
+// 一个结果文件展开为帧路径列表：PVD 展开为其数据文件，VTKHDF 展开为各步
+static QStringList ExpandResultSeries(const QString& path)
+{
+    switch (DetectResultFileFormat(path)) {
+    case ResultFileFormat::PVDCollection:
+        return ReadPVDCollection(path);
+    case ResultFileFormat::VTKHDF: {
+        QStringList frames;
+        const int steps = VTKHDFNumberOfSteps(path);
+        for (int s = 0; s < steps; ++s) frames << QString("%1#%2").arg(path).arg(s);
+        return frames;
+    }
+    case ResultFileFormat::LegacyVTK:
+    case ResultFileFormat::XMLUnstructuredGrid:
+        return {path};
+    default:
+        return {};
+    }
+}
+
+//读取 VTKHDF 非结构网格的一步。拓扑按 Steps 中的偏移定位，与上一次相同（所有步共用拓扑）时直接复用，
+//每步只按 PointDataOffsets 读取各点数据场对应的一段，不接触其他步的数据。
+//可在工作线程中调用：整个读取持有 HDF5Mutex，拓扑缓存只在锁内访问
+vtkSmartPointer<vtkUnstructuredGrid> ResultFrameReader::ReadVTKHDFStep(const QString& path, int step)
+{
+    std::lock_guard<std::mutex> lock(HDF5Mutex());
+    H5Eset_auto(H5E_DEFAULT, nullptr, nullptr); // 可选数据集缺失属正常情况，不打印 HDF5 错误栈
+    const hid_t file = H5Fopen(QFile::encodeName(path).constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0) return nullptr;
+    vtkSmartPointer<vtkUnstructuredGrid> result;
+
+    const bool transient = H5Lexists(file, "/VTKHDF/Steps", H5P_DEFAULT) > 0;
+    const long long partOffset = transient ? ReadHDFInteger(file, "/VTKHDF/Steps/PartOffsets", step, 0) : 0;
+    const long long pointOffset = transient ? ReadHDFInteger(file, "/VTKHDF/Steps/PointOffsets", step, 0) : 0;
+    const long long cellOffset = transient ? ReadHDFInteger(file, "/VTKHDF/Steps/CellOffsets", step, 0) : 0;
+    const long long connOffset = transient ? ReadHDFInteger(file, "/VTKHDF/Steps/ConnectivityIdOffsets", step, 0) : 0;
+    const long long numPoints = ReadHDFInteger(file, "/VTKHDF/NumberOfPoints", partOffset, -1);
+    const long long numCells = ReadHDFInteger(file, "/VTKHDF/NumberOfCells", partOffset, -1);
+    const long long numConn = ReadHDFInteger(file, "/VTKHDF/NumberOfConnectivityIds", partOffset, -1);
+
+    do {
+        if (numPoints <= 0 || numCells < 0 || numConn < 0) break;
+
+        // 1. 拓扑和坐标：键相同则复用缓存
+        const QFileInfo info(path);
+        const QString key = QString("%1|%2|%3|%4|%5|%6|%7").arg(path).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch())
+                                .arg(pointOffset).arg(cellOffset).arg(connOffset).arg(partOffset);
+        if (key != m_hdfTopologyKey || !m_hdfTopology) {
+            std::vector<double> coords;
+            std::vector<long long> offsets, conn;
+            std::vector<unsigned char> types;
+            hsize_t cols = 0;
+            if (!ReadHDFRows(file, "/VTKHDF/Points", H5T_NATIVE_DOUBLE, pointOffset, numPoints, coords, cols) || cols != 3) break;
+            if (!ReadHDFRows(file, "/VTKHDF/Offsets", H5T_NATIVE_LLONG, cellOffset + partOffset, numCells + 1, offsets, cols)) break;
+            if (!ReadHDFRows(file, "/VTKHDF/Connectivity", H5T_NATIVE_LLONG, connOffset, numConn, conn, cols)) break;
+            if (!ReadHDFRows(file, "/VTKHDF/Types", H5T_NATIVE_UCHAR, cellOffset, numCells, types, cols)) break;
+
+            vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+            points->SetDataTypeToDouble();
+            points->SetNumberOfPoints(numPoints);
+            std::copy(coords.begin(), coords.end(), static_cast<double*>(points->GetVoidPointer(0)));
+
+            vtkSmartPointer<vtkIdTypeArray> offsetArray = vtkSmartPointer<vtkIdTypeArray>::New();
+            offsetArray->SetNumberOfValues(numCells + 1);
+            std::copy(offsets.begin(), offsets.end(), offsetArray->GetPointer(0));
+            vtkSmartPointer<vtkIdTypeArray> connArray = vtkSmartPointer<vtkIdTypeArray>::New();
+            connArray->SetNumberOfValues(numConn);
+            std::copy(conn.begin(), conn.end(), connArray->GetPointer(0));
+            vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+            cells->SetData(offsetArray, connArray);
+            vtkSmartPointer<vtkUnsignedCharArray> typeArray = vtkSmartPointer<vtkUnsignedCharArray>::New();
+            typeArray->SetNumberOfValues(numCells);
+            std::copy(types.begin(), types.end(), typeArray->GetPointer(0));
+
+            m_hdfTopology = vtkSmartPointer<vtkUnstructuredGrid>::New();
+            m_hdfTopology->SetPoints(points);
+            m_hdfTopology->SetCells(typeArray, cells);
+            m_hdfTopologyKey = key;
+        }
+
+        // 2. 本步的点数据场
+        result = vtkSmartPointer<vtkUnstructuredGrid>::New();
+        result->ShallowCopy(m_hdfTopology);
+        const hid_t group = H5Lexists(file, "/VTKHDF/PointData", H5P_DEFAULT) > 0
+                                ? H5Gopen(file, "/VTKHDF/PointData", H5P_DEFAULT) : -1;
+        H5G_info_t groupInfo;
+        if (group >= 0 && H5Gget_info(group, &groupInfo) >= 0) {
+            for (hsize_t i = 0; i < groupInfo.nlinks; ++i) {
+                char name[256] = {0};
+                if (H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, i, name, sizeof(name), H5P_DEFAULT) < 0) continue;
+                const std::string dataPath = std::string("/VTKHDF/PointData/") + name;
+                const std::string offsetPath = std::string("/VTKHDF/Steps/PointDataOffsets/") + name;
+                const long long first = transient ? ReadHDFInteger(file, offsetPath.c_str(), step, pointOffset) : 0;
+                std::vector<double> values;
+                hsize_t cols = 0;
+                if (!ReadHDFRows(file, dataPath.c_str(), H5T_NATIVE_DOUBLE, first, numPoints, values, cols)) continue;
+                vtkSmartPointer<vtkDoubleArray> array = vtkSmartPointer<vtkDoubleArray>::New();
+                array->SetName(name);
+                array->SetNumberOfComponents(static_cast<int>(cols));
+                array->SetNumberOfTuples(numPoints);
+                std::copy(values.begin(), values.end(), array->GetPointer(0));
+                result->GetPointData()->AddArray(array);
+            }
+        }
+        if (group >= 0) H5Gclose(group);
+    } while (false);
+
+    H5Fclose(file);
+    return result;
+}
+
+//按格式读取一帧网格和点数据场
+vtkSmartPointer<vtkUnstructuredGrid> ResultFrameReader::ReadResultGrid(const QString& framePath)
+{
+    QString hdfFile;
+    int step = 0;
+    if (SplitHDFFramePath(framePath, hdfFile, step)) {
+        return ReadVTKHDFStep(hdfFile, step);
+    }
+
+    vtkSmartPointer<vtkUnstructuredGrid> grid;
+    switch (DetectResultFileFormat(framePath)) {
+    case ResultFileFormat::LegacyVTK: {
+        vtkSmartPointer<vtkUnstructuredGridReader> frameReader = vtkSmartPointer<vtkUnstructuredGridReader>::New();
+        frameReader->SetFileName(framePath.toStdString().c_str());
+        frameReader->ReadAllScalarsOn();
+        frameReader->ReadAllVectorsOn();
+        frameReader->ReadAllTensorsOn();
+        frameReader->ReadAllFieldsOn();
+        frameReader->Update();
+        grid = frameReader->GetOutput();
+        break;
+    }
+    case ResultFileFormat::XMLUnstructuredGrid: {
+        // 二进制/压缩（zlib、lz4）的 appended 数据由读取器直接解码
+        vtkSmartPointer<vtkXMLUnstructuredGridReader> xmlReader = vtkSmartPointer<vtkXMLUnstructuredGridReader>::New();
+        xmlReader->SetFileName(framePath.toStdString().c_str());
+        xmlReader->Update();
+        grid = xmlReader->GetOutput();
+        break;
+    }
+    case ResultFileFormat::VTKHDF:
+        return ReadVTKHDFStep(framePath, 0);
+    default:
+        break;
+    }
+    return grid;
+}
+
+//读取一个结果帧，并按 precision 压缩点数据场。
+//只读取，不记录内存使用，可在工作线程中调用；放入 m_resultFrames 的帧由调用方在 GUI 线程 TouchMemory
+bool ResultFrameReader::LoadResultFrame(const QString& fileName, ResultFrame& frame)
+{
+    vtkSmartPointer<vtkUnstructuredGrid> output = ReadResultGrid(fileName);
+    if (!output || output->GetNumberOfPoints() == 0) {
+        qWarning() << "结果文件读取失败:" << fileName;
+        return false;
+    }
+
+    frame.filePath = fileName;
+    ResultFrameStamp(fileName, frame.fileSize, frame.fileTime);
+    frame.precision = precision;
+    frame.grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    frame.grid->ShallowCopy(output);
+    frame.fields.clear();
+    frame.boundBytes = 0;
+
+    vtkPointData* pd = output->GetPointData();
+    for (int a = 0; a < pd->GetNumberOfArrays(); ++a) {
+        vtkDataArray* src = pd->GetArray(a);
+        if (!src || !src->GetName()) continue;
+
+        ResultField field;
+        field.name = src->GetName();
+        field.numComponents = src->GetNumberOfComponents();
+        field.numTuples = src->GetNumberOfTuples();
+        field.precision = precision;
+        const size_t n = static_cast<size_t>(field.numTuples) * field.numComponents;
+
+        // 结果文件中的场均为 double，其他类型先转换一次
+        vtkSmartPointer<vtkDoubleArray> asDouble = vtkDoubleArray::SafeDownCast(src);
+        if (!asDouble) {
+            asDouble = vtkSmartPointer<vtkDoubleArray>::New();
+            asDouble->DeepCopy(src);
+        }
+        const double* values = asDouble->GetPointer(0);
+
+        switch (precision) {
+        case ResultPrecision::Float32:
+            field.f32.resize(n);
+            ConvertDoubleToFloat(values, field.f32.data(), n);
+            break;
+        case ResultPrecision::Quantized16: {
+            field.compMin.assign(field.numComponents, 0.0);
+            field.compScale.assign(field.numComponents, 0.0);
+            std::vector<double> compInv(field.numComponents, 0.0);
+            for (int c = 0; c < field.numComponents; ++c) {
+                double range[2];
+                src->GetRange(range, c);
+                field.compMin[c] = range[0];
+                if (range[1] > range[0]) {
+                    field.compScale[c] = (range[1] - range[0]) / 65535.0;
+                    compInv[c] = 65535.0 / (range[1] - range[0]);
+                }
+            }
+            field.q16.resize(n);
+            QuantizeDoubleToU16(values, field.q16.data(), n, field.numComponents,
+                                field.compMin.data(), compInv.data());
+            break;
+        }
+        default:
+            field.f64.assign(values, values + n);
+            break;
+        }
+        frame.fields.push_back(std::move(field));
+    }
+
+    // 原始双精度场已转存，网格中不再保留
+    frame.grid->GetPointData()->Initialize();
+
+    // 压缩模式下坐标也存为单精度；VTKHDF 的各步共用缓存中的坐标，不逐帧复制
+    QString hdfFile;
+    int hdfStep = 0;
+    if (precision != ResultPrecision::Double && !SplitHDFFramePath(fileName, hdfFile, hdfStep)) {
+        vtkDoubleArray* coords = vtkDoubleArray::SafeDownCast(output->GetPoints()->GetData());
+        if (coords) {
+            vtkSmartPointer<vtkPoints> floatPoints = vtkSmartPointer<vtkPoints>::New();
+            floatPoints->SetDataTypeToFloat();
+            floatPoints->SetNumberOfPoints(output->GetNumberOfPoints());
+            float* dst = static_cast<float*>(floatPoints->GetVoidPointer(0));
+            ConvertDoubleToFloat(coords->GetPointer(0), dst, static_cast<size_t>(output->GetNumberOfPoints()) * 3);
+            frame.grid->SetPoints(floatPoints);
+        }
+    }
+    return true;
+}
+
+//把指定场绑定到帧网格上用于着色。单精度/双精度直接引用存储；量化场不反量化：
+//单分量场直接引用 16 位存储，多分量场按模量化为一个 16 位数组（只有它另占内存），着色时按 offset/scale 换算范围
+BoundResultField ResultFrameReader::BindResultField(ResultFrame& frame, const std::string& name)
+{
+    BoundResultField bound;
+    const ResultField* field = frame.Field(name);
+    if (!field) return bound;
+
+    size_t ownedBytes = 0;
+    const vtkIdType n = field->numTuples * field->numComponents;
+    if (field->precision == ResultPrecision::Float32) {
+        vtkSmartPointer<vtkFloatArray> f = vtkSmartPointer<vtkFloatArray>::New();
+        f->SetNumberOfComponents(field->numComponents);
+        f->SetArray(const_cast<float*>(field->f32.data()), n, 1); // save=1：不接管内存
+        bound.array = f;
+    } else if (field->precision == ResultPrecision::Double) {
+        vtkSmartPointer<vtkDoubleArray> d = vtkSmartPointer<vtkDoubleArray>::New();
+        d->SetNumberOfComponents(field->numComponents);
+        d->SetArray(const_cast<double*>(field->f64.data()), n, 1);
+        bound.array = d;
+    } else if (field->numComponents == 1) {
+        vtkSmartPointer<vtkUnsignedShortArray> u = vtkSmartPointer<vtkUnsignedShortArray>::New();
+        u->SetArray(const_cast<uint16_t*>(field->q16.data()), n, 1);
+        bound.array = u;
+        bound.offset = field->compMin[0];
+        bound.scale = field->compScale[0];
+    } else {
+        // 模的范围，再按范围量化
+        struct MinMax {
+            double lo = std::numeric_limits<double>::max();
+            double hi = 0.0;
+        };
+        auto magnitude = [field](vtkIdType t) {
+            double sq = 0.0;
+            for (int c = 0; c < field->numComponents; ++c) {
+                const double v = field->Value(t, c);
+                sq += v * v;
+            }
+            return std::sqrt(sq);
+        };
+        vtkSMPThreadLocal<MinMax> local;
+        vtkSMPTools::For(0, field->numTuples, [&](vtkIdType begin, vtkIdType end) {
+            MinMax& m = local.Local();
+            for (vtkIdType t = begin; t < end; ++t) {
+                const double v = magnitude(t);
+                m.lo = std::min(m.lo, v);
+                m.hi = std::max(m.hi, v);
+            }
+        });
+        MinMax range;
+        for (const MinMax& m : local) {
+            range.lo = std::min(range.lo, m.lo);
+            range.hi = std::max(range.hi, m.hi);
+        }
+        if (range.lo > range.hi) range.lo = range.hi = 0.0;
+        const double inv = range.hi > range.lo ? 65535.0 / (range.hi - range.lo) : 0.0;
+
+        vtkSmartPointer<vtkUnsignedShortArray> u = vtkSmartPointer<vtkUnsignedShortArray>::New();
+        u->SetNumberOfTuples(field->numTuples);
+        uint16_t* out = u->GetPointer(0);
+        vtkSMPTools::For(0, field->numTuples, [&](vtkIdType begin, vtkIdType end) {
+            for (vtkIdType t = begin; t < end; ++t) {
+                const double q = std::min(std::max((magnitude(t) - range.lo) * inv, 0.0), 65535.0);
+                out[t] = static_cast<uint16_t>(std::lrint(q));
+            }
+        });
+        bound.array = u;
+        bound.offset = range.lo;
+        bound.scale = inv > 0.0 ? 1.0 / inv : 0.0;
+        ownedBytes = static_cast<size_t>(field->numTuples) * sizeof(uint16_t);
+    }
+    bound.array->SetName(field->name.c_str());
+
+    frame.grid->GetPointData()->Initialize();
+    frame.grid->GetPointData()->AddArray(bound.array);
+    frame.boundBytes = ownedBytes;
+    return bound;
+}
+
+//在状态栏显示结果帧占用的内存
+void MainWindow::ReportResultMemory()
+{
+    size_t bytes = 0;
+    for (const auto& frame : m_resultFrames) {
+        bytes += frame.ByteSize();
+    }
+    const QString mode = ui->comboBox_ResultPrecision->currentText();
+    const QString msg = QString("结果帧: %1 个, 占用内存 %2 MB (%3)")
+                            .arg(m_resultFrames.size())
+                            .arg(bytes / (1024.0 * 1024.0), 0, 'f', 1)
+                            .arg(mode);
+    statusBar()->showMessage(msg);
+    qDebug() << msg;
+}
+
+//切换结果索引目录：清空索引并改为监视新目录
+void MainWindow::SetResultIndexDir(const QString& dirPath)
+{
+    if (!m_resultIndexDir.isEmpty()) {
+        m_resultsWatcher->removePath(m_resultIndexDir);
+    }
+    m_resultIndexDir = dirPath;
+    m_resultIndex.clear();
+    if (QDir(dirPath).exists()) {
+        m_resultsWatcher->addPath(dirPath);
+    }
+    RefreshResultIndex();
+}
+
+int MainWindow::FindResultFrame(const QString& path) const
+{
+    for (size_t i = 0; i < m_resultFrames.size(); ++i) {
+        if (m_resultFrames[i].filePath == path) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+//重新扫描结果目录：按帧号自然排序，比较大小和修改时间得到新增、变化和删除的帧。
+//已有帧读入内存时只读取新增/变化的帧，否则只更新路径列表，等显示时再读取
+void MainWindow::RefreshResultIndex()
+{
+    QDir resultsDir(m_resultIndexDir);
+    if (!resultsDir.exists()) {
+        qWarning() << "Results directory does not exist: " << m_resultIndexDir;
+        return;
+    }
+    if (!m_resultsWatcher->directories().contains(m_resultIndexDir)) {
+        m_resultsWatcher->addPath(m_resultIndexDir);
+    }
+
+    // 帧序列：目录中有 PVD 集合或 VTKHDF 文件时取第一个展开，否则取各个 .vtk/.vtu 文件
+    QFileInfoList fileInfoList = resultsDir.entryInfoList(QStringList() << "*.vtk" << "*.vtu" << "*.pvd" << "*.vtkhdf" << "*.hdf",
+                                                          QDir::Files | QDir::NoDotAndDotDot);
+    QCollator collator;
+    collator.setNumericMode(true);
+    std::sort(fileInfoList.begin(), fileInfoList.end(), [&](const QFileInfo& a, const QFileInfo& b) {
+        return collator.compare(a.fileName(), b.fileName()) < 0;
+    });
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QStringList framePaths;
+    bool deferred = false;
+    for (const QString& suffix : {QString("pvd"), QString("vtkhdf"), QString("hdf")}) {
+        auto series = std::find_if(fileInfoList.begin(), fileInfoList.end(),
+                                   [&](const QFileInfo& info) { return info.suffix().compare(suffix, Qt::CaseInsensitive) == 0; });
+        if (series == fileInfoList.end()) continue;
+        if (now - series->lastModified().toMSecsSinceEpoch() < 1000) {
+            deferred = true; // 仍在写入，保持原索引
+            for (const auto& e : m_resultIndex) framePaths << e.path;
+        } else {
+            framePaths = ExpandResultSeries(series->absoluteFilePath());
+        }
+        break;
+    }
+    if (framePaths.isEmpty() && !deferred) {
+        for (const QFileInfo& info : fileInfoList) {
+            const QString suffix = info.suffix().toLower();
+            if (suffix == "vtk" || suffix == "vtu") framePaths << info.absoluteFilePath();
+        }
+    }
+
+    std::vector<ResultIndexEntry> index;
+    QStringList changed;
+    for (const QString& framePath : framePaths) {
+        ResultIndexEntry entry;
+        entry.path = framePath;
+        ResultFrameStamp(framePath, entry.size, entry.mtime);
+
+        auto old = std::find_if(m_resultIndex.begin(), m_resultIndex.end(),
+                                [&](const ResultIndexEntry& e) { return e.path == entry.path; });
+        const bool isNew = old == m_resultIndex.end();
+        if (isNew || old->size != entry.size || old->mtime != entry.mtime) {
+            // 刚写入的文件可能还不完整，稍后再检查（VTKHDF 的步在上面按整个文件判断）
+            if (entry.size == 0 || (entry.mtime > 0 && now - entry.mtime < 1000)) {
+                deferred = true;
+                if (!isNew) index.push_back(*old);
+                continue;
+            }
+            changed << entry.path;
+        }
+        index.push_back(entry);
+    }
+
+    int removed = 0;
+    for (const auto& e : m_resultIndex) {
+        if (std::none_of(index.begin(), index.end(), [&](const ResultIndexEntry& n) { return n.path == e.path; })) {
+            removed++;
+        }
+    }
+    m_resultIndex = std::move(index);
+    vtkFilePaths.clear();
+    for (const auto& e : m_resultIndex) {
+        vtkFilePaths << e.path;
+    }
+    if (deferred) {
+        m_resultIndexTimer->start();
+    }
+
+    qDebug() << "Found " << vtkFilePaths.size() << " result frames in " << m_resultIndexDir
+             << "(新增/变化" << changed.size() << ", 删除" << removed << ")";
+    if (m_resultFrames.empty() || (changed.isEmpty() && removed == 0)) {
+        return;
+    }
+
+    // 同步内存中的帧：丢弃已删除的帧，读取新增/变化的帧，按索引顺序排列
+    std::vector<ResultFrame> frames;
+    frames.reserve(m_resultIndex.size());
+    for (const auto& e : m_resultIndex) {
+        const int i = FindResultFrame(e.path);
+        if (i >= 0 && !changed.contains(e.path)) {
+            frames.push_back(std::move(m_resultFrames[i]));
+            continue;
+        }
+        ResultFrame frame;
+        if (m_resultReader.LoadResultFrame(e.path, frame)) {
+            TouchMemory(kMemResultFrames, e.path);
+            frames.push_back(std::move(frame));
+        }
+    }
+    m_resultFrames = std::move(frames);
+    RebuildResultActors();
+    ReportResultMemory();
+}
+
+//结果视图仍存在时按当前帧重建 Actor（不重新读取文件）
+void MainWindow::RebuildResultActors()
+{
+    if (!m_sceneLayers.count("results")) {
+        return;
+    }
+    SetSceneLayer("results", {});
+    m_resultScalarBar = nullptr;
+    m_resultLut = nullptr;
+    for (auto& frame : m_resultFrames) {
+        AddResultFrameActor(frame);
+    }
+    m_viewWindow->Render();
+}
+
+//tab栏读取VTK文件
+void MainWindow::onTabInitClicked(int index)
+{
+    // 获取被点击的tab的文本
+    QString tabText = ui->tabWidget->tabText(index);
+
+    // 根据点击的tab索引执行不同的逻辑
+    switch (index) {
+    case 0:
+        qDebug() << "第一个标签页被点击了! 索引:" << index << ", 文本:" << tabText;
+        // 在这里添加第一个tab的点击处理逻辑
+        break;
+    case 1:
+        qDebug() << "第二个标签页被点击了! 索引:" << index << ", 文本:" << tabText;
+        // 在这里添加第二个tab的点击处理逻辑
+        break;
+    case 2:
+        qDebug() << "第三个标签页被点击了! 索引:" << index << ", 文本:" << tabText;
+        // 在这里添加第三个tab的点击处理逻辑
+        break;
+    case 3:
+        qDebug() << "第四个标签页被点击了! 索引:" << index << ", 文本:" << tabText;
+        // 首次打开时索引 results 目录，之后只增量更新（目录变化由 m_resultsWatcher 触发）
+        if (m_resultIndexDir.isEmpty()) {
+            SetResultIndexDir(QDir::currentPath() + "/results");
+        } else {
+            RefreshResultIndex();
+        }
+        break;
+    default:
+        qDebug() << "未知的标签页被点击! 索引:" << index;
+        break;
+    }
+}
+
+//为一帧结果创建着色 Actor 并加入结果渲染器，LUT 和标量条在首个有效帧时创建
+vtkSmartPointer<vtkActor> MainWindow::AddResultFrameActor(ResultFrame& frame)
+{
+    if (!EnsureResultFrameLoaded(frame)) {
+        return nullptr;
+    }
+    const QString& fileName = frame.filePath;
+
+    QString color_name = "Solid";
+    bool useScalar = true;
+
+    std::string typeStr = m_resultScalarType.toStdString();
+    const BoundResultField bound = ResultFrameReader::BindResultField(frame, typeStr);
+    vtkDataArray* selectedScalar = bound.array;
+    color_name = m_resultScalarType.toStdString().c_str();
+
+    if (!selectedScalar) {
+        qWarning() << "标量数组 " << m_resultScalarType << " 不存在 in file " << fileName << "!";
+        return nullptr;
+    }
+
+    vtkSmartPointer<vtkDataSetMapper> mapper = vtkSmartPointer<vtkDataSetMapper>::New();
+    mapper->SetInputData(frame.grid);
+
+    if (useScalar && selectedScalar) {
+        int numComponents = selectedScalar->GetNumberOfComponents();
+        mapper->SetScalarVisibility(true);
+        mapper->SelectColorArray(selectedScalar->GetName());
+        mapper->SetColorModeToMapScalars(); // 16 位的量化数组也经 LUT 着色
+
+        if (numComponents == 1) {
+            mapper->SetScalarModeToUsePointFieldData();
+        } else {
+            mapper->SetScalarModeToUsePointFieldData();
+        }
+
+        double range[2];
+        bound.ValueRange(range);
+        if (range[0] >= range[1]) {
+            range[0] = 0;
+            range[1] = 1;
+        }
+        double arrayRange[2];
+        bound.ArrayRange(range, arrayRange);
+        mapper->SetScalarRange(arrayRange[0], arrayRange[1]);
+
+        // --- 在这里创建LUT和scalarBar（如果还没有） ---
+        if (!m_resultLut) { // 只在第一次找到有效的scalar时创建LUT
+            m_resultLut = vtkSmartPointer<vtkLookupTable>::New();
+            m_resultLut->SetHueRange(0.666667, 0.0); // Blue to Red
+            m_resultLut->SetVectorModeToMagnitude();
+            m_resultLut->Build();
+        }
+        if (bound.Mapped()) {
+            // 量化场的数组值不是场值：本帧用自己的 LUT 按数组值着色，标量条仍用 m_resultLut 显示场值
+            vtkSmartPointer<vtkLookupTable> frameLut = vtkSmartPointer<vtkLookupTable>::New();
+            frameLut->DeepCopy(m_resultLut);
+            mapper->SetLookupTable(frameLut);
+            m_resultLut->SetRange(range);
+        } else {
+            mapper->SetLookupTable(m_resultLut);
+        }
+
+        // 在这里创建scalarBar
+        if (!m_resultScalarBar) { // 只在第一次找到有效的scalar时创建scalarBar
+            m_resultScalarBar = vtkSmartPointer<vtkScalarBarActor>::New();
+            m_resultScalarBar->SetLookupTable(m_resultLut); // 使用刚创建或已存在的LUT
+            m_resultScalarBar->SetTitle(color_name.toStdString().c_str());
+            m_resultScalarBar->SetNumberOfLabels(10);
+            m_resultScalarBar->SetDragable(true);
+
+            // --- 设置标量条文字颜色和固定字体大小 ---
+            m_resultScalarBar->GetLabelTextProperty()->SetColor(0.0, 0.0, 0.0); // 黑色
+            m_resultScalarBar->GetLabelTextProperty()->SetFontSize(18); // 固定字体大小
+            m_resultScalarBar->GetTitleTextProperty()->SetColor(0.0, 0.0, 0.0); // 黑色
+            m_resultScalarBar->GetTitleTextProperty()->SetFontSize(20); // 固定字体大小
+
+            // 保持颜色条大小固定 (相对窗口大小的比例)
+            m_resultScalarBar->SetWidth(0.1);
+            m_resultScalarBar->SetHeight(0.8);
+
+            // 只添加一次scalarBar到结果图层
+            AddToSceneLayer("results", m_resultScalarBar);
+        }
+
+    } else {
+        mapper->SetScalarVisibility(false);
+    }
+
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper(mapper);
+    actor->GetProperty()->EdgeVisibilityOn();
+    actor->GetProperty()->SetAmbient(0.25);
+    if (!useScalar) {
+        actor->GetProperty()->SetColor(0.8, 0.8, 0.8);
+    }
+
+    AddToSceneLayer("results", actor);
+    return actor;
+}
+
+void MainWindow::VisualVTKGroupFile(const QStringList& fileNames, const QString& scalarType)
+{
+    // 检查是否有文件需要处理
+    if (fileNames.isEmpty()) {
+        qDebug() << "No files provided to VisualVTKGroupFile.";
+        return; // 如果没有文件，直接返回
+    }
+
+    // --- 1. 清空场景中的结果图层 ---
+    // 结果视图状态：scalarBar 和 LUT 在首个有效帧时创建，后续增量加入的帧共用
+    SetSceneLayer("results", {});
+    m_resultScalarType = scalarType;
+    m_resultScalarBar = nullptr;
+    m_resultLut = nullptr;
+
+    // --- 2. 执行 VTK 可视化逻辑 ---
+    // 按当前存储模式读取所有帧，点数据场以紧凑形式保存在 m_resultFrames 中
+    // 已读取且文件和存储模式都未变化的帧直接复用
+    m_resultReader.precision = static_cast<ResultPrecision>(ui->comboBox_ResultPrecision->currentIndex());
+    std::vector<ResultFrame> frames;
+    frames.reserve(fileNames.size());
+    for (const auto& fileName : fileNames) {
+        const int i = FindResultFrame(fileName);
+        if (i >= 0) {
+            qint64 size = 0, mtime = 0;
+            ResultFrameStamp(fileName, size, mtime);
+            ResultFrame& cached = m_resultFrames[i];
+            if (cached.precision == m_resultReader.precision && cached.fileSize == size && cached.fileTime == mtime) {
+                frames.push_back(std::move(cached));
+                continue;
+            }
+        }
+        ResultFrame frame;
+        if (m_resultReader.LoadResultFrame(fileName, frame)) {
+            TouchMemory(kMemResultFrames, fileName);
+            frames.push_back(std::move(frame));
+        }
+    }
+    m_resultFrames = std::move(frames);
+
+    for (auto& frame : m_resultFrames) {
+        AddResultFrameActor(frame);
+    }
+
+    // 检查是否成功添加了任何带有标量的Actor（即是否创建了LUT和scalarBar）
+    if (!m_resultLut) {
+        qDebug() << "警告: 没有找到有效的标量数组用于任何输入文件，scalarBar 未创建。";
+    }
+
+    // 探针用的节点主序时程数据随结果一起生成
+    if (!m_resultFrames.empty()) {
+        BuildNodeHistory();
+    }
+    ReportResultMemory();
+
+    // --- 3. 只显示结果图层并让相机适配模型 ---
+    ShowSceneLayers({"results"});
+}
+
+//显示S
+void MainWindow::onButtonSClicked()
+{
+    // vtkFilePaths是之前获取的VTK文件路径列表
+    VisualVTKGroupFile(vtkFilePaths, "S");
+}
+//显示S_Mises
+void MainWindow::onButtonSMisesClicked()
+{
+    VisualVTKGroupFile(vtkFilePaths, "S_Mises");
+}
+//显示S_Principal
+void MainWindow::onButtonSPrincipalClicked()
+{
+    VisualVTKGroupFile(vtkFilePaths, "S_Principal");
+}
+//显示U
+void MainWindow::onButtonUClicked()
+{
+    VisualVTKGroupFile(vtkFilePaths, "U");
+}
+
+//----------多视口对比----------|
+//最多四个同步视口对比不同帧或不同场。各视口引用同一份表面拓扑和坐标数组，只绑定不同的标量数组；
+//VTK 在同一渲染窗口内按数据数组缓存顶点缓冲，坐标只上传一次，多一个视口只多一份表面点上的标量
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkIdTypeArray.h>
+#include <vtkTextActor.h>
+#include <vtkCamera.h>
+#include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QSpinBox>
+
+//退出对比模式，恢复场景渲染器
+void MainWindow::ClearCompareView()
+{
+    if (m_compareRenderers.empty()) return;
+    for (const auto& r : m_compareRenderers) {
+        m_viewWindow->RemoveRenderer(r);
+    }
+    m_compareRenderers.clear();
+    m_viewWindow->AddRenderer(m_viewRenderer);
+}
+
+//按视口设置显示对比视图，几何取第一个视口的帧
+void MainWindow::ShowCompareView(const std::vector<CompareViewport>& viewports)
+{
+    if (viewports.empty()) return;
+    for (const auto& vp : viewports) {
+        if (!EnsureResultFrameLoaded(m_resultFrames[vp.frame])) {
+            QMessageBox::warning(this, "警告", QString("第 %1 帧读取失败！").arg(vp.frame + 1));
+            return;
+        }
+    }
+    ResultFrame& base = m_resultFrames[viewports.front().frame];
+    const vtkIdType numPoints = base.grid->GetNumberOfPoints();
+
+    // 1. 公共表面：只提取一次，保留到原网格节点号的映射
+    vtkSmartPointer<vtkUnstructuredGrid> structure = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    structure->CopyStructure(base.grid);
+    vtkSmartPointer<vtkDataSetSurfaceFilter> surfaceFilter = vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+    surfaceFilter->SetInputData(structure);
+    surfaceFilter->PassThroughPointIdsOn();
+    surfaceFilter->Update();
+    vtkSmartPointer<vtkPolyData> surface = surfaceFilter->GetOutput();
+    vtkIdTypeArray* originalIds = vtkIdTypeArray::SafeDownCast(
+        surface->GetPointData()->GetArray(surfaceFilter->GetOriginalPointIdsName()));
+    if (!originalIds) {
+        QMessageBox::warning(this, "警告", "无法提取结果网格表面！");
+        return;
+    }
+    const vtkIdType numSurfacePoints = surface->GetNumberOfPoints();
+
+    // 2. 各视口的标量：从压缩存储中只取表面节点；同名场使用相同色标范围
+    std::vector<vtkSmartPointer<vtkFloatArray>> scalars;
+    std::map<QString, std::pair<double, double>> fieldRanges;
+    for (const auto& vp : viewports) {
+        const ResultField* field = m_resultFrames[vp.frame].Field(vp.field.toStdString());
+        if (!field || field->numTuples != numPoints) {
+            QMessageBox::warning(this, "警告", QString("第 %1 帧没有与参考帧节点一致的场 %2！").arg(vp.frame + 1).arg(vp.field));
+            return;
+        }
+        const int numComponents = field->numComponents;
+        vtkSmartPointer<vtkFloatArray> array = vtkSmartPointer<vtkFloatArray>::New();
+        array->SetName(field->name.c_str());
+        array->SetNumberOfComponents(numComponents);
+        array->SetNumberOfTuples(numSurfacePoints);
+        float* out = array->GetPointer(0);
+        vtkSMPTools::For(0, numSurfacePoints, [&](vtkIdType begin, vtkIdType end) {
+            std::vector<double> tuple(numComponents);
+            for (vtkIdType p = begin; p < end; ++p) {
+                field->Tuple(originalIds->GetValue(p), tuple.data());
+                for (int c = 0; c < numComponents; ++c) {
+                    out[p * numComponents + c] = static_cast<float>(tuple[c]);
+                }
+            }
+        });
+        double range[2];
+        array->GetRange(range, numComponents == 1 ? 0 : -1);
+        auto it = fieldRanges.find(vp.field);
+        if (it == fieldRanges.end()) {
+            fieldRanges[vp.field] = {range[0], range[1]};
+        } else {
+            it->second.first = std::min(it->second.first, range[0]);
+            it->second.second = std::max(it->second.second, range[1]);
+        }
+        scalars.push_back(array);
+    }
+
+    // 3. 替换场景渲染器为对比视口，所有视口共用一个相机
+    EnsureSceneView();
+    ShowInViewArea(m_viewWidget);
+    ClearCompareView();
+    m_viewWindow->RemoveRenderer(m_viewRenderer);
+
+    vtkSmartPointer<vtkCamera> camera = vtkSmartPointer<vtkCamera>::New();
+    const int count = static_cast<int>(viewports.size());
+    const int cols = count == 1 ? 1 : 2;
+    const int rows = count <= 2 ? 1 : 2;
+    for (int i = 0; i < count; ++i) {
+        const CompareViewport& vp = viewports[i];
+        const int col = i % cols, row = i / cols;
+
+        vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+        renderer->SetBackground(1, 1, 1);
+        renderer->SetViewport(double(col) / cols, 1.0 - double(row + 1) / rows,
+                              double(col + 1) / cols, 1.0 - double(row) / rows);
+        renderer->SetActiveCamera(camera);
+
+        // 共享点和单元数组，只换标量
+        vtkSmartPointer<vtkPolyData> view = vtkSmartPointer<vtkPolyData>::New();
+        view->CopyStructure(surface);
+        view->GetPointData()->SetScalars(scalars[i]);
+
+        double range[2] = {fieldRanges[vp.field].first, fieldRanges[vp.field].second};
+        if (range[0] >= range[1]) {
+            range[1] = range[0] + 1.0;
+        }
+        vtkSmartPointer<vtkLookupTable> lut = vtkSmartPointer<vtkLookupTable>::New();
+        lut->SetHueRange(0.666667, 0.0);
+        lut->SetVectorModeToMagnitude();
+        lut->SetTableRange(range);
+        lut->Build();
+
+        vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        mapper->SetInputData(view);
+        mapper->SetLookupTable(lut);
+        mapper->SetScalarModeToUsePointData();
+        mapper->SetScalarRange(range);
+        mapper->ScalarVisibilityOn();
+
+        vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+        actor->SetMapper(mapper);
+        actor->GetProperty()->EdgeVisibilityOn();
+        actor->GetProperty()->SetAmbient(0.25);
+        renderer->AddActor(actor);
+
+        vtkSmartPointer<vtkScalarBarActor> bar = vtkSmartPointer<vtkScalarBarActor>::New();
+        bar->SetLookupTable(lut);
+        bar->SetTitle(vp.field.toStdString().c_str());
+        bar->SetNumberOfLabels(8);
+        bar->GetLabelTextProperty()->SetColor(0.0, 0.0, 0.0);
+        bar->GetTitleTextProperty()->SetColor(0.0, 0.0, 0.0);
+        bar->SetWidth(0.1);
+        bar->SetHeight(0.7);
+        renderer->AddActor2D(bar);
+
+        vtkSmartPointer<vtkTextActor> label = vtkSmartPointer<vtkTextActor>::New();
+        label->SetInput(QString("%1 - Step %2").arg(vp.field).arg(vp.frame + 1).toStdString().c_str());
+        label->GetTextProperty()->SetColor(0.0, 0.0, 0.0);
+        label->GetTextProperty()->SetFontSize(16);
+        label->SetDisplayPosition(10, 10);
+        renderer->AddActor2D(label);
+
+        m_viewWindow->AddRenderer(renderer);
+        m_compareRenderers.push_back(renderer);
+    }
+
+    m_compareRenderers.front()->ResetCamera();
+    m_viewWindow->Render();
+}
+
+//对比视图：选择视口数和各视口的帧、场
+void MainWindow::onCompareClicked()
+{
+    if (!EnsureResultFramesLoaded()) return;
+
+    const int numFrames = static_cast<int>(m_resultFrames.size());
+    if (!EnsureResultFrameLoaded(m_resultFrames.front())) {
+        QMessageBox::warning(this, "警告", "结果文件读取失败！");
+        return;
+    }
+    QStringList fieldNames;
+    for (const auto& field : m_resultFrames.front().fields) {
+        fieldNames << QString::fromStdString(field.name);
+    }
+    if (fieldNames.isEmpty()) {
+        QMessageBox::warning(this, "警告", "结果文件中没有点数据场！");
+        return;
+    }
+
+    // 默认：上次的设置；否则同一场的首帧和末帧
+    std::vector<CompareViewport> defaults = m_compareViewports;
+    if (defaults.empty()) {
+        const QString field = fieldNames.contains(m_resultScalarType) ? m_resultScalarType : fieldNames.front();
+        defaults = {{0, field}, {numFrames - 1, field}};
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("对比视图");
+    QFormLayout* form = new QFormLayout(&dialog);
+    QSpinBox* countSpin = new QSpinBox(&dialog);
+    countSpin->setRange(1, 4);
+    countSpin->setValue(static_cast<int>(defaults.size()));
+    form->addRow("视口数:", countSpin);
+
+    QComboBox* frameCombos[4];
+    QComboBox* fieldCombos[4];
+    for (int i = 0; i < 4; ++i) {
+        QWidget* row = new QWidget(&dialog);
+        QHBoxLayout* rowLayout = new QHBoxLayout(row);
+        rowLayout->setContentsMargins(0, 0, 0, 0);
+        frameCombos[i] = new QComboBox(row);
+        for (int f = 0; f < numFrames; ++f) {
+            frameCombos[i]->addItem(QString("Step %1 (%2)").arg(f + 1).arg(QFileInfo(m_resultFrames[f].filePath).fileName()));
+        }
+        fieldCombos[i] = new QComboBox(row);
+        fieldCombos[i]->addItems(fieldNames);
+        if (i < static_cast<int>(defaults.size())) {
+            frameCombos[i]->setCurrentIndex(std::min(defaults[i].frame, numFrames - 1));
+            fieldCombos[i]->setCurrentText(defaults[i].field);
+        } else {
+            frameCombos[i]->setCurrentIndex(numFrames - 1);
+            fieldCombos[i]->setCurrentText(defaults.front().field);
+        }
+        rowLayout->addWidget(frameCombos[i]);
+        rowLayout->addWidget(fieldCombos[i]);
+        row->setEnabled(i < countSpin->value());
+        connect(countSpin, QOverload<int>::of(&QSpinBox::valueChanged), row, [row, i](int n) { row->setEnabled(i < n); });
+        form->addRow(QString("视口 %1:").arg(i + 1), row);
+    }
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    std::vector<CompareViewport> viewports;
+    for (int i = 0; i < countSpin->value(); ++i) {
+        viewports.push_back({frameCombos[i]->currentIndex(), fieldCombos[i]->currentText()});
+    }
+    m_compareViewports = viewports;
+    ShowCompareView(viewports);
+}
+
+//----------离屏出图----------|
+//报告用图：每帧 × 场 × 视角渲染为 PNG，可再用 ffmpeg 把每个场和视角的图片序列编码为视频。
+//渲染在本程序以 --render-worker 启动的工作进程中进行：不创建界面，VTK 窗口设为离屏渲染。离屏渲染窗口仍是 VTK
+//编译时选定的实现，发行版的 VTK 只带 X11 的 OpenGL 窗口（没有 OSMesa/EGL），仍要连接 X 显示；没有显示时主进程
+//在 PATH 中查找 xvfb-run，用它为每个工作进程启动虚拟显示。每个进程渲染一帧的全部组合，多个进程并行；
+//色标范围由主进程按全部帧统一给出，各帧图片可直接对比
+#include <vtkWindowToImageFilter.h>
+#include <vtkPNGWriter.h>
+#include <vtkTextActor.h>
+#include <vtkTextProperty.h>
+#include <vtkCamera.h>
+#include <vtkRenderWindow.h>
+#include <vtkSMPTools.h>
+#include <vtkSMPThreadLocal.h>
+#include <QCheckBox>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QStandardPaths>
+#include <QThread>
+#include <limits>
+
+static const char* const kRenderFields[] = {"S", "S_Mises", "S_Principal", "U"};
+
+// 固定视角：视线方向（相机指向模型）和上方向
+struct RenderCameraPreset {
+    const char* name;
+    const char* label;
+    double direction[3];
+    double viewUp[3];
+};
+static const RenderCameraPreset kRenderCameraPresets[] = {
+    {"iso", "等轴测", {-1, -1, -1}, {0, 0, 1}},
+    {"front", "前视", {0, 1, 0}, {0, 0, 1}},
+    {"top", "俯视", {0, 0, -1}, {0, 1, 0}},
+    {"right", "右视", {-1, 0, 0}, {0, 0, 1}},
+};
+
+static const RenderCameraPreset* FindRenderCameraPreset(const QString& name)
+{
+    for (const auto& preset : kRenderCameraPresets) {
+        if (name == preset.name) return &preset;
+    }
+    return nullptr;
+}
+
+// VTK 渲染窗口需要而当前环境缺少的显示，返回错误说明；可以渲染时返回空串
+static QString RenderDisplayError(vtkRenderWindow* window)
+{
+    if (window->IsA("vtkXOpenGLRenderWindow") && qEnvironmentVariableIsEmpty("DISPLAY")) {
+        return "VTK 使用 X11 OpenGL 窗口，离屏出图也需要 X 显示，但 DISPLAY 未设置";
+    }
+    return QString();
+}
+
+// 图片序列文件名（ffmpeg 输入模式与之一致）
+static QString RenderImagePath(const QString& dir, const QString& field, const QString& view, int frame)
+{
+    return QString("%1/%2/%3/%2_%3_%4.png").arg(dir, field, view).arg(frame, 4, 10, QChar('0'));
+}
+
+//场在一帧上的范围：单分量取值，多分量取模（与 VTK 按模着色一致）
+static void ResultFieldRange(const ResultField& field, double range[2])
+{
+    struct MinMax {
+        double lo = std::numeric_limits<double>::max();
+        double hi = -std::numeric_limits<double>::max();
+    };
+    vtkSMPThreadLocal<MinMax> local;
+    vtkSMPTools::For(0, field.numTuples, [&](vtkIdType begin, vtkIdType end) {
+        MinMax& m = local.Local();
+        std::vector<double> tuple(field.numComponents);
+        for (vtkIdType t = begin; t < end; ++t) {
+            field.Tuple(t, tuple.data());
+            double value = tuple[0];
+            if (field.numComponents > 1) {
+                double sq = 0.0;
+                for (double c : tuple) sq += c * c;
+                value = std::sqrt(sq);
+            }
+            m.lo = std::min(m.lo, value);
+            m.hi = std::max(m.hi, value);
+        }
+    });
+    range[0] = std::numeric_limits<double>::max();
+    range[1] = -std::numeric_limits<double>::max();
+    for (const MinMax& m : local) {
+        range[0] = std::min(range[0], m.lo);
+        range[1] = std::max(range[1], m.hi);
+    }
+}
+
+//离屏出图工作进程入口（main 中检测到 --render-worker 时调用，不创建主窗口，只用 ResultFrameReader 读取结果帧）。
+//返回值：0 全部写出，1 参数错误，2 读取失败，3 部分场缺失或写出失败，4 没有可用的显示
+int MainWindow::RunRenderWorker(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    QCommandLineOption workerOption("render-worker");
+    QCommandLineOption frameOption("frame", "结果帧文件", "path");
+    QCommandLineOption indexOption("index", "帧号（图片序号）", "n");
+    QCommandLineOption outOption("out", "输出目录", "dir");
+    QCommandLineOption sizeOption("size", "图片尺寸 WxH", "size", "1600x1000");
+    QCommandLineOption fieldOption("field", "场及色标范围 name:min:max，可重复", "spec");
+    QCommandLineOption viewOption("view", "视角，可重复", "name");
+    parser.addOptions({workerOption, frameOption, indexOption, outOption, sizeOption, fieldOption, viewOption});
+    if (!parser.parse(arguments) || !parser.isSet(frameOption) || !parser.isSet(outOption)) {
+        qWarning() << "离屏出图参数错误:" << parser.errorText();
+        return 1;
+    }
+    const QString framePath = parser.value(frameOption);
+    const int frameIndex = parser.value(indexOption).toInt();
+    const QString outDir = parser.value(outOption);
+    const QStringList size = parser.value(sizeOption).split('x');
+    const int width = size.value(0).toInt() > 0 ? size.value(0).toInt() : 1600;
+    const int height = size.value(1).toInt() > 0 ? size.value(1).toInt() : 1000;
+
+    // 离屏渲染窗口：具体实现由 VTK 编译时决定，X11 的窗口没有显示时在 Render 中直接中止进程，须先检查
+    vtkSmartPointer<vtkRenderWindow> window = vtkSmartPointer<vtkRenderWindow>::New();
+    const QString displayError = RenderDisplayError(window);
+    if (!displayError.isEmpty()) {
+        qWarning() << "离屏出图失败:" << displayError;
+        return 4;
+    }
+
+    ResultFrameReader reader;
+    ResultFrame frame;
+    if (!reader.LoadResultFrame(framePath, frame)) {
+        return 2;
+    }
+
+    window->SetOffScreenRendering(1);
+    window->SetSize(width, height);
+    window->SetMultiSamples(0);
+    vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+    renderer->SetBackground(1, 1, 1);
+    window->AddRenderer(renderer);
+
+    vtkSmartPointer<vtkLookupTable> lut = vtkSmartPointer<vtkLookupTable>::New();
+    lut->SetHueRange(0.666667, 0.0);
+    lut->SetVectorModeToMagnitude();
+    lut->Build();
+    vtkSmartPointer<vtkDataSetMapper> mapper = vtkSmartPointer<vtkDataSetMapper>::New();
+    mapper->SetInputData(frame.grid);
+    mapper->SetLookupTable(lut);
+    mapper->SetScalarModeToUsePointFieldData();
+    mapper->SetColorModeToMapScalars(); // 16 位的量化数组也经 LUT 着色
+    mapper->ScalarVisibilityOn();
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper(mapper);
+    actor->GetProperty()->EdgeVisibilityOn();
+    actor->GetProperty()->SetAmbient(0.25);
+    renderer->AddActor(actor);
+
+    // 标量条按场值标注；量化场的 mapper 按数组值着色，两者的范围不同，标量条用单独的 LUT
+    vtkSmartPointer<vtkLookupTable> barLut = vtkSmartPointer<vtkLookupTable>::New();
+    barLut->DeepCopy(lut);
+    vtkSmartPointer<vtkScalarBarActor> scalarBar = vtkSmartPointer<vtkScalarBarActor>::New();
+    scalarBar->SetLookupTable(barLut);
+    scalarBar->SetNumberOfLabels(10);
+    scalarBar->GetLabelTextProperty()->SetColor(0.0, 0.0, 0.0);
+    scalarBar->GetLabelTextProperty()->SetFontSize(18);
+    scalarBar->GetTitleTextProperty()->SetColor(0.0, 0.0, 0.0);
+    scalarBar->GetTitleTextProperty()->SetFontSize(20);
+    scalarBar->SetWidth(0.1);
+    scalarBar->SetHeight(0.8);
+    renderer->AddViewProp(scalarBar);
+
+    vtkSmartPointer<vtkTextActor> caption = vtkSmartPointer<vtkTextActor>::New();
+    caption->GetTextProperty()->SetColor(0.0, 0.0, 0.0);
+    caption->GetTextProperty()->SetFontSize(20);
+    caption->SetDisplayPosition(10, 10);
+    renderer->AddViewProp(caption);
+
+    QStringList views = parser.values(viewOption);
+    if (views.isEmpty()) views << kRenderCameraPresets[0].name;
+
+    int failures = 0;
+    for (const QString& spec : parser.values(fieldOption)) {
+        const QStringList parts = spec.split(':');
+        const QString name = parts.value(0);
+        const BoundResultField bound = ResultFrameReader::BindResultField(frame, name.toStdString());
+        if (!bound.array) {
+            qWarning() << "结果帧" << framePath << "中没有场" << name;
+            failures++;
+            continue;
+        }
+        double range[2] = {parts.value(1).toDouble(), parts.value(2).toDouble()};
+        if (parts.size() < 3 || range[0] >= range[1]) {
+            bound.ValueRange(range);
+            if (range[0] >= range[1]) range[1] = range[0] + 1;
+        }
+        double arrayRange[2];
+        bound.ArrayRange(range, arrayRange);
+        mapper->SelectColorArray(name.toStdString().c_str());
+        mapper->SetScalarRange(arrayRange);
+        barLut->SetRange(range);
+        scalarBar->SetTitle(name.toStdString().c_str());
+        caption->SetInput(QString("%1    Step %2").arg(name).arg(frameIndex).toStdString().c_str());
+
+        for (const QString& view : views) {
+            const RenderCameraPreset* preset = FindRenderCameraPreset(view);
+            if (!preset) {
+                failures++;
+                continue;
+            }
+            vtkCamera* camera = renderer->GetActiveCamera();
+            camera->SetFocalPoint(0, 0, 0);
+            camera->SetPosition(-preset->direction[0], -preset->direction[1], -preset->direction[2]);
+            camera->SetViewUp(preset->viewUp);
+            renderer->ResetCamera();
+            window->Render();
+
+            vtkSmartPointer<vtkWindowToImageFilter> capture = vtkSmartPointer<vtkWindowToImageFilter>::New();
+            capture->SetInput(window);
+            capture->ReadFrontBufferOff();
+            capture->Update();
+
+            const QString path = RenderImagePath(outDir, name, view, frameIndex);
+            QDir().mkpath(QFileInfo(path).absolutePath());
+            vtkSmartPointer<vtkPNGWriter> writer = vtkSmartPointer<vtkPNGWriter>::New();
+            writer->SetFileName(QFile::encodeName(path).constData());
+            writer->SetInputConnection(capture->GetOutputPort());
+            writer->Write();
+            if (!QFileInfo::exists(path)) {
+                qWarning() << "写出图片失败:" << path;
+                failures++;
+            }
+        }
+    }
+    return failures > 0 ? 3 : 0;
+}
+
+//离屏出图：按帧排队工作进程，全部帧写完后再排队视频编码
+void MainWindow::onRenderReportClicked()
+{
+    for (const auto& job : m_renderJobs) {
+        if (job.state == RenderJob::Queued || job.state == RenderJob::Running) {
+            QMessageBox::warning(this, "警告", "上一批出图任务仍在运行！");
+            return;
+        }
+    }
+    if (!EnsureResultFramesLoaded()) {
+        QMessageBox::warning(this, "警告", "请先读取结果文件！");
+        return;
+    }
+    // 工作进程继承本进程的环境。没有可用的显示时用 xvfb-run 启动工作进程（与 ffmpeg 一样在 PATH 中查找），找不到则无法出图
+    const QString displayError = RenderDisplayError(vtkSmartPointer<vtkRenderWindow>::New());
+    const QString xvfbRun = displayError.isEmpty() ? QString() : QStandardPaths::findExecutable("xvfb-run");
+    if (!displayError.isEmpty() && xvfbRun.isEmpty()) {
+        QMessageBox::warning(this, "警告", displayError + "，且 PATH 中没有 xvfb-run。\n请安装 Xvfb（xvfb-run），或在有显示的环境中出图。");
+        return;
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("离屏出图");
+    QFormLayout* form = new QFormLayout(&dialog);
+    QLineEdit* dirEdit = new QLineEdit(m_renderOutputDir.isEmpty() ? QDir::currentPath() + "/report" : m_renderOutputDir, &dialog);
+    dirEdit->setMinimumWidth(360);
+    QPushButton* browseButton = new QPushButton("浏览...", &dialog);
+    connect(browseButton, &QPushButton::clicked, &dialog, [&dialog, dirEdit]() {
+        const QString dir = QFileDialog::getExistingDirectory(&dialog, "输出目录", dirEdit->text());
+        if (!dir.isEmpty()) dirEdit->setText(dir);
+    });
+    QHBoxLayout* dirLayout = new QHBoxLayout();
+    dirLayout->addWidget(dirEdit);
+    dirLayout->addWidget(browseButton);
+    form->addRow("输出目录:", dirLayout);
+
+    QHBoxLayout* fieldLayout = new QHBoxLayout();
+    std::vector<QCheckBox*> fieldChecks;
+    for (const char* field : kRenderFields) {
+        QCheckBox* check = new QCheckBox(field, &dialog);
+        check->setChecked(true);
+        fieldLayout->addWidget(check);
+        fieldChecks.push_back(check);
+    }
+    form->addRow("场:", fieldLayout);
+
+    QHBoxLayout* viewLayout = new QHBoxLayout();
+    std::vector<QCheckBox*> viewChecks;
+    for (const auto& preset : kRenderCameraPresets) {
+        QCheckBox* check = new QCheckBox(preset.label, &dialog);
+        check->setChecked(&preset == &kRenderCameraPresets[0]);
+        viewLayout->addWidget(check);
+        viewChecks.push_back(check);
+    }
+    form->addRow("视角:", viewLayout);
+
+    QSpinBox* widthSpin = new QSpinBox(&dialog);
+    widthSpin->setRange(320, 7680);
+    widthSpin->setValue(1600);
+    QSpinBox* heightSpin = new QSpinBox(&dialog);
+    heightSpin->setRange(240, 4320);
+    heightSpin->setValue(1000);
+    QHBoxLayout* sizeLayout = new QHBoxLayout();
+    sizeLayout->addWidget(widthSpin);
+    sizeLayout->addWidget(heightSpin);
+    form->addRow("图片尺寸:", sizeLayout);
+
+    QSpinBox* workerSpin = new QSpinBox(&dialog);
+    workerSpin->setRange(1, std::max(1, QThread::idealThreadCount()));
+    workerSpin->setValue(m_maxRenderWorkers);
+    form->addRow("并行进程数:", workerSpin);
+
+    const QString ffmpeg = QStandardPaths::findExecutable("ffmpeg");
+    QCheckBox* videoCheck = new QCheckBox("每个场和视角编码为 MP4", &dialog);
+    videoCheck->setEnabled(!ffmpeg.isEmpty());
+    if (ffmpeg.isEmpty()) videoCheck->setToolTip("未找到 ffmpeg，只输出 PNG 序列");
+    QSpinBox* fpsSpin = new QSpinBox(&dialog);
+    fpsSpin->setRange(1, 60);
+    fpsSpin->setValue(10);
+    form->addRow("视频:", videoCheck);
+    form->addRow("帧率:", fpsSpin);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    m_renderOutputDir = dirEdit->text().trimmed();
+    m_maxRenderWorkers = workerSpin->value();
+    QStringList fields, views;
+    for (size_t i = 0; i < fieldChecks.size(); ++i) {
+        if (fieldChecks[i]->isChecked()) fields << kRenderFields[i];
+    }
+    for (size_t i = 0; i < viewChecks.size(); ++i) {
+        if (viewChecks[i]->isChecked()) views << kRenderCameraPresets[i].name;
+    }
+    if (fields.isEmpty() || views.isEmpty() || m_renderOutputDir.isEmpty()) {
+        QMessageBox::warning(this, "警告", "请选择输出目录、至少一个场和一个视角！");
+        return;
+    }
+    if (!QDir().mkpath(m_renderOutputDir)) {
+        QMessageBox::warning(this, "警告", QString("无法创建输出目录: %1").arg(m_renderOutputDir));
+        return;
+    }
+
+    // 1. 各场在全部帧上的统一色标范围（被内存预算淘汰的帧逐帧流式读取）
+    std::vector<std::array<double, 2>> ranges(fields.size(),
+        {std::numeric_limits<double>::max(), -std::numeric_limits<double>::max()});
+    for (size_t f = 0; f < m_resultFrames.size(); ++f) {
+        ResultFrame streamed;
+        const ResultFrame* frame = AcquireResultFrame(f, streamed);
+        if (!frame) continue;
+        for (int i = 0; i < fields.size(); ++i) {
+            const ResultField* data = frame->Field(fields[i].toStdString());
+            if (!data) continue;
+            double r[2];
+            ResultFieldRange(*data, r);
+            ranges[i][0] = std::min(ranges[i][0], r[0]);
+            ranges[i][1] = std::max(ranges[i][1], r[1]);
+        }
+    }
+    TouchResidentResultFrames();
+    QStringList fieldSpecs;
+    for (int i = 0; i < fields.size(); ++i) {
+        const QString& field = fields[i];
+        double* range = ranges[i].data();
+        if (range[0] > range[1]) {
+            qWarning() << "结果中没有场" << field << "，跳过";
+            continue;
+        }
+        if (range[0] == range[1]) range[1] = range[0] + 1;
+        fieldSpecs << QString("%1:%2:%3").arg(field).arg(range[0], 0, 'g', 17).arg(range[1], 0, 'g', 17);
+    }
+    if (fieldSpecs.isEmpty()) {
+        QMessageBox::warning(this, "警告", "结果中没有所选的场！");
+        return;
+    }
+
+    // 2. 每帧一个工作进程。经 xvfb-run 启动时各进程从不同的显示号开始查找空闲显示，避免同时启动时抢同一个号
+    m_renderJobs.clear();
+    const QString program = QCoreApplication::applicationFilePath();
+    for (size_t f = 0; f < m_resultFrames.size(); ++f) {
+        RenderJob job;
+        job.program = program;
+        if (!xvfbRun.isEmpty()) {
+            job.program = xvfbRun;
+            job.arguments << "-a" << "-n" << QString::number(100 + f) << "-s" << "-screen 0 1280x1024x24" << program;
+        }
+        job.arguments << "--render-worker" << "--frame" << m_resultFrames[f].filePath << "--index" << QString::number(f + 1)
+                      << "--out" << m_renderOutputDir << "--size" << QString("%1x%2").arg(widthSpin->value()).arg(heightSpin->value());
+        for (const QString& spec : fieldSpecs) job.arguments << "--field" << spec;
+        for (const QString& view : views) job.arguments << "--view" << view;
+        job.description = QString("Step %1").arg(f + 1);
+        m_renderJobs.push_back(job);
+    }
+
+    // 3. 视频编码（宽高补齐为偶数，兼容 yuv420p）
+    if (videoCheck->isChecked()) {
+        for (const QString& spec : fieldSpecs) {
+            const QString field = spec.section(':', 0, 0);
+            for (const QString& view : views) {
+                RenderJob job;
+                job.encode = true;
+                job.program = ffmpeg;
+                job.arguments << "-y" << "-loglevel" << "error" << "-framerate" << QString::number(fpsSpin->value())
+                              << "-i" << QString("%1/%2/%3/%2_%3_").arg(m_renderOutputDir, field, view) + "%04d.png"
+                              << "-vf" << "pad=ceil(iw/2)*2:ceil(ih/2)*2" << "-c:v" << "libx264" << "-pix_fmt" << "yuv420p"
+                              << QString("%1/%2_%3.mp4").arg(m_renderOutputDir, field, view);
+                job.description = QString("%1_%2.mp4").arg(field, view);
+                m_renderJobs.push_back(job);
+            }
+        }
+    }
+
+    qDebug() << "离屏出图:" << m_resultFrames.size() << "帧," << fieldSpecs.size() << "个场," << views.size() << "个视角, 输出"
+             << m_renderOutputDir << (xvfbRun.isEmpty() ? "" : "（经 xvfb-run 启动）");
+    StartQueuedRenderJobs();
+    ReportRenderJobs();
+}
+
+//启动排队任务直到达到并行上限；编码任务等全部帧写完后才启动
+void MainWindow::StartQueuedRenderJobs()
+{
+    int running = 0;
+    bool framesPending = false;
+    for (const auto& job : m_renderJobs) {
+        if (job.state == RenderJob::Running) running++;
+        if (!job.encode && (job.state == RenderJob::Queued || job.state == RenderJob::Running)) framesPending = true;
+    }
+
+    for (size_t i = 0; i < m_renderJobs.size() && running < m_maxRenderWorkers; ++i) {
+        RenderJob& job = m_renderJobs[i];
+        if (job.state != RenderJob::Queued) continue;
+        if (job.encode && framesPending) break;
+
+        QProcess* process = new QProcess(this);
+        process->setProcessChannelMode(QProcess::ForwardedChannels);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+                [this, i](int exitCode, QProcess::ExitStatus status) {
+            onRenderJobFinished(i, status == QProcess::NormalExit && exitCode == 0);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, i](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) onRenderJobFinished(i, false);
+        });
+        job.process = process;
+        job.state = RenderJob::Running;
+        running++;
+        process->start(job.program, job.arguments);
+    }
+}
+
+void MainWindow::onRenderJobFinished(size_t index, bool success)
+{
+    if (index >= m_renderJobs.size()) return;
+    RenderJob& job = m_renderJobs[index];
+    if (job.state != RenderJob::Running) return;
+    job.state = success ? RenderJob::Finished : RenderJob::Failed;
+    job.process->deleteLater();
+    job.process = nullptr;
+    if (!success) qWarning() << "出图任务失败:" << job.description;
+
+    StartQueuedRenderJobs();
+    ReportRenderJobs();
+
+    int failed = 0;
+    for (const auto& j : m_renderJobs) {
+        if (j.state == RenderJob::Queued || j.state == RenderJob::Running) return;
+        if (j.state == RenderJob::Failed) failed++;
+    }
+    QString message = QString("离屏出图完成，输出目录:\n%1").arg(m_renderOutputDir);
+    if (failed > 0) message += QString("\n%1 个任务失败，详见控制台输出").arg(failed);
+    QMessageBox::information(this, "离屏出图", message);
+}
+
+void MainWindow::ReportRenderJobs()
+{
+    int done = 0, failed = 0;
+    for (const auto& job : m_renderJobs) {
+        if (job.state == RenderJob::Finished) done++;
+        if (job.state == RenderJob::Failed) failed++;
+    }
+    statusBar()->showMessage(QString("出图: 完成 %1/%2, 失败 %3").arg(done).arg(m_renderJobs.size()).arg(failed));
+}
+
+//----------截面分析（椭圆度/壁厚）----------|
+#include <vtkSMPTools.h>
+#include <vtkContextView.h>
+#include <vtkContextScene.h>
+#include <vtkChartXY.h>
+#include <vtkChartMatrix.h>
+#include <vtkPlot.h>
+#include <vtkTable.h>
+#include <vtkAxis.h>
+#include <vtkVector.h>
+#include <vtkTextProperty.h>
+#include <vtkIdList.h>
+#include <QElapsedTimer>
+#include <numeric>
+
+// 管体截面划分：按未变形坐标把节点分到 (弧长站位, 周向扇区, 内/外壁) 中
+// 结果文件中的坐标是未变形坐标，位移场 U 单独保存，因此同一拓扑只需划分一次
+struct TubeSectionLayout {
+    int numStations = 0;
+    int numSectors = 36;
+    double s0 = 0.0, ds = 1.0;    // 站位起点和间距
+    double axis[3] = {1, 0, 0};   // 未变形管轴
+    double center[3] = {0, 0, 0};
+    double e1[3] = {0, 1, 0}, e2[3] = {0, 0, 1};
+    double rOut = 0.0, rIn = 0.0; // 未变形外/内半径
+    std::vector<int> station;     // 每个节点的站位，-1 表示不参与
+    std::vector<uint8_t> sector;
+    std::vector<uint8_t> outer;   // 1 = 外壁节点，0 = 内壁节点
+    std::vector<vtkIdType> tubeNodes; // 管体区域的节点（不含套筒和模具）
+};
+
+// 单帧的截面统计，按站位存储
+struct TubeSectionStats {
+    std::vector<double> ovality;  // 椭圆度 (Dmax - Dmin) / D0 * 100
+    std::vector<double> thinning; // 最大减薄率 (t0 - t) / t0 * 100
+    std::vector<double> thickness; // 各扇区壁厚（站位 * 扇区）
+    std::vector<double> outerRadius; // 各扇区外壁平均半径（站位 * 扇区），无节点时为 -1
+    std::vector<double> outerDir;  // 各扇区外壁在截面内的平均方向（站位 * 扇区 * 3）
+    std::vector<double> centroid; // 截面形心（站位 * 3）
+    std::vector<double> tangent;  // 中心线切向（站位 * 3）
+};
+
+static inline double Dot3(const double* a, const double* b) { return a[0]*b[0] + a[1]*b[1] + a[2]*b[2]; }
+
+static inline void Normalize3(double* v)
+{
+    const double len = std::sqrt(Dot3(v, v));
+    if (len > 1e-12) { v[0] /= len; v[1] /= len; v[2] /= len; }
+}
+
+static inline void Cross3(const double* a, const double* b, double* out)
+{
+    out[0] = a[1]*b[2] - a[2]*b[1];
+    out[1] = a[2]*b[0] - a[0]*b[2];
+    out[2] = a[0]*b[1] - a[1]*b[0];
+}
+
+// 结果网格中管体、旋转套筒、固定套筒和模具是互不相连的网格区域。
+// 按单元连通性（并查集）划分区域，节点最多的区域即管体；没有单元时全部节点视为管体
+static std::vector<vtkIdType> TubeBodyNodes(vtkUnstructuredGrid* grid)
+{
+    const vtkIdType n = grid->GetNumberOfPoints();
+    std::vector<vtkIdType> nodes;
+    if (grid->GetNumberOfCells() == 0) {
+        nodes.resize(n);
+        std::iota(nodes.begin(), nodes.end(), 0);
+        return nodes;
+    }
+
+    std::vector<vtkIdType> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](vtkIdType a) {
+        while (parent[a] != a) {
+            parent[a] = parent[parent[a]];
+            a = parent[a];
+        }
+        return a;
+    };
+    vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+    for (vtkIdType c = 0; c < grid->GetNumberOfCells(); ++c) {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        grid->GetCellPoints(c, npts, pts, ids);
+        for (vtkIdType i = 1; i < npts; ++i) {
+            const vtkIdType a = find(pts[0]), b = find(pts[i]);
+            if (a != b) parent[a] = b;
+        }
+    }
+
+    // 孤立节点（不属于任何单元）自成一个区域，不会被选为管体
+    std::vector<vtkIdType> size(n, 0);
+    for (vtkIdType i = 0; i < n; ++i) size[find(i)]++;
+    const vtkIdType tube = static_cast<vtkIdType>(std::max_element(size.begin(), size.end()) - size.begin());
+    nodes.reserve(size[tube]);
+    for (vtkIdType i = 0; i < n; ++i) {
+        if (find(i) == tube) nodes.push_back(i);
+    }
+    return nodes;
+}
+
+// 由未变形坐标建立截面划分：只取管体区域的节点，主方向作为管轴，节点半径区分内外壁
+static bool BuildTubeSectionLayout(vtkUnstructuredGrid* grid, int numSectors, int maxStations, TubeSectionLayout& layout)
+{
+    vtkPoints* points = grid ? grid->GetPoints() : nullptr;
+    if (!points) return false;
+    const std::vector<vtkIdType> tubeNodes = TubeBodyNodes(grid);
+    const vtkIdType m = static_cast<vtkIdType>(tubeNodes.size());
+    if (m < 8) return false;
+
+    // 1. 形心和协方差矩阵，幂迭代求最长主方向
+    double c[3] = {0, 0, 0}, p[3];
+    for (vtkIdType i : tubeNodes) {
+        points->GetPoint(i, p);
+        c[0] += p[0]; c[1] += p[1]; c[2] += p[2];
+    }
+    c[0] /= m; c[1] /= m; c[2] /= m;
+
+    double cov[3][3] = {{0}};
+    for (vtkIdType i : tubeNodes) {
+        points->GetPoint(i, p);
+        const double d[3] = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+        for (int r = 0; r < 3; ++r)
+            for (int k = 0; k < 3; ++k)
+                cov[r][k] += d[r] * d[k];
+    }
+    double axis[3] = {1, 0, 0};
+    for (int it = 0; it < 50; ++it) {
+        double next[3];
+        for (int r = 0; r < 3; ++r) next[r] = Dot3(cov[r], axis);
+        Normalize3(next);
+        std::copy(next, next + 3, axis);
+    }
+
+    // 截面内的参考方向，用于周向扇区编号
+    double ref[3] = {0, 0, 1};
+    if (std::fabs(Dot3(ref, axis)) > 0.9) { ref[0] = 0; ref[1] = 1; ref[2] = 0; }
+    double e2[3], e1[3];
+    Cross3(axis, ref, e1);
+    Normalize3(e1);
+    Cross3(axis, e1, e2);
+
+    // 2. 轴向范围和径向范围（管体节点）
+    double sMin = 1e300, sMax = -1e300, rMin = 1e300, rMax = -1e300;
+    std::vector<double> s(m), r(m), theta(m);
+    for (vtkIdType j = 0; j < m; ++j) {
+        points->GetPoint(tubeNodes[j], p);
+        const double d[3] = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+        const double a = Dot3(d, axis), x = Dot3(d, e1), y = Dot3(d, e2);
+        s[j] = a;
+        r[j] = std::sqrt(x * x + y * y);
+        theta[j] = std::atan2(y, x);
+        sMin = std::min(sMin, a); sMax = std::max(sMax, a);
+        rMin = std::min(rMin, r[j]); rMax = std::max(rMax, r[j]);
+    }
+    if (sMax - sMin < 1e-9 || rMax - rMin < 1e-9) return false;
+
+    layout.numSectors = numSectors;
+    layout.numStations = maxStations;
+    layout.s0 = sMin;
+    layout.ds = (sMax - sMin) / maxStations;
+    layout.rOut = rMax;
+    layout.rIn = rMin;
+    std::copy(axis, axis + 3, layout.axis);
+    std::copy(c, c + 3, layout.center);
+    std::copy(e1, e1 + 3, layout.e1);
+    std::copy(e2, e2 + 3, layout.e2);
+
+    // 3. 节点分配，半径位于壁厚中面以外的为外壁节点；模具和套筒节点站位为 -1
+    const double rMid = 0.5 * (rMin + rMax);
+    const double twoPi = 2.0 * M_PI;
+    const vtkIdType n = points->GetNumberOfPoints();
+    layout.station.assign(n, -1);
+    layout.sector.assign(n, 0);
+    layout.outer.assign(n, 0);
+    for (vtkIdType j = 0; j < m; ++j) {
+        const vtkIdType i = tubeNodes[j];
+        const int st = std::min(static_cast<int>((s[j] - sMin) / layout.ds), maxStations - 1);
+        const double t = theta[j] < 0 ? theta[j] + twoPi : theta[j];
+        layout.station[i] = st;
+        layout.sector[i] = static_cast<uint8_t>(std::min(static_cast<int>(t / twoPi * numSectors), numSectors - 1));
+        layout.outer[i] = r[j] >= rMid ? 1 : 0;
+    }
+    layout.tubeNodes = std::move(tubeNodes);
+    return true;
+}
+
+// 单帧统计：先求各站位形心和切向，再在垂直于切向的截面内计算各扇区半径
+// U 为空时使用未变形坐标（用于求基准壁厚）
+static void ComputeTubeSectionStats(const TubeSectionLayout& layout, vtkPoints* points,
+                                    const ResultField* U, const TubeSectionStats* baseline,
+                                    TubeSectionStats& stats)
+{
+    const int ns = layout.numStations, nk = layout.numSectors;
+    auto deformed = [&](vtkIdType i, double* p) {
+        points->GetPoint(i, p);
+        if (U && U->numComponents >= 3 && i < U->numTuples) {
+            p[0] += U->Value(i, 0); p[1] += U->Value(i, 1); p[2] += U->Value(i, 2);
+        }
+    };
+
+    // 1. 截面形心
+    std::vector<double> sum(ns * 3, 0.0);
+    std::vector<int> count(ns, 0);
+    double p[3];
+    for (vtkIdType i : layout.tubeNodes) {
+        const int st = layout.station[i];
+        deformed(i, p);
+        sum[st*3] += p[0]; sum[st*3+1] += p[1]; sum[st*3+2] += p[2];
+        count[st]++;
+    }
+    stats.centroid.assign(ns * 3, 0.0);
+    for (int st = 0; st < ns; ++st) {
+        if (count[st] == 0) continue;
+        for (int k = 0; k < 3; ++k) stats.centroid[st*3+k] = sum[st*3+k] / count[st];
+    }
+
+    // 2. 切向：相邻站位形心的中心差分
+    stats.tangent.assign(ns * 3, 0.0);
+    for (int st = 0; st < ns; ++st) {
+        int a = st - 1, b = st + 1;
+        while (a >= 0 && count[a] == 0) --a;
+        while (b < ns && count[b] == 0) ++b;
+        if (a < 0) a = st;
+        if (b >= ns) b = st;
+        double t[3] = {stats.centroid[b*3] - stats.centroid[a*3],
+                       stats.centroid[b*3+1] - stats.centroid[a*3+1],
+                       stats.centroid[b*3+2] - stats.centroid[a*3+2]};
+        if (a == b || Dot3(t, t) < 1e-24) std::copy(layout.axis, layout.axis + 3, t);
+        Normalize3(t);
+        std::copy(t, t + 3, &stats.tangent[st*3]);
+    }
+
+    // 3. 各扇区内外壁平均半径
+    std::vector<double> rSum(ns * nk * 2, 0.0);
+    std::vector<int> rCount(ns * nk * 2, 0);
+    stats.outerDir.assign(ns * nk * 3, 0.0);
+    for (vtkIdType i : layout.tubeNodes) {
+        const int st = layout.station[i];
+        if (count[st] == 0) continue;
+        deformed(i, p);
+        const double* c = &stats.centroid[st*3];
+        const double* t = &stats.tangent[st*3];
+        double d[3] = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+        const double a = Dot3(d, t);
+        d[0] -= a * t[0]; d[1] -= a * t[1]; d[2] -= a * t[2];
+        const int slot = (st * nk + layout.sector[i]) * 2 + layout.outer[i];
+        rSum[slot] += std::sqrt(Dot3(d, d));
+        rCount[slot]++;
+        if (layout.outer[i]) {
+            double* dir = &stats.outerDir[(st * nk + layout.sector[i]) * 3];
+            dir[0] += d[0]; dir[1] += d[1]; dir[2] += d[2];
+        }
+    }
+
+    // 4. 椭圆度和壁厚
+    stats.ovality.assign(ns, 0.0);
+    stats.thinning.assign(ns, 0.0);
+    stats.thickness.assign(ns * nk, 0.0);
+    stats.outerRadius.assign(ns * nk, -1.0);
+    const double d0 = 2.0 * layout.rOut;
+    for (int st = 0; st < ns; ++st) {
+        std::vector<double> rOuter(nk, -1.0);
+        for (int k = 0; k < nk; ++k) {
+            const int so = (st * nk + k) * 2 + 1, si = (st * nk + k) * 2;
+            if (rCount[so] > 0) rOuter[k] = rSum[so] / rCount[so];
+            stats.outerRadius[st*nk+k] = rOuter[k];
+            Normalize3(&stats.outerDir[(st * nk + k) * 3]);
+            if (rCount[so] > 0 && rCount[si] > 0) {
+                stats.thickness[st*nk+k] = rSum[so] / rCount[so] - rSum[si] / rCount[si];
+            }
+        }
+
+        double dMax = 0.0, dMin = 1e300;
+        for (int k = 0; k < nk / 2; ++k) {
+            const double ra = rOuter[k], rb = rOuter[k + nk / 2];
+            if (ra < 0 || rb < 0) continue;
+            dMax = std::max(dMax, ra + rb);
+            dMin = std::min(dMin, ra + rb);
+        }
+        if (dMax > 0 && d0 > 0) stats.ovality[st] = (dMax - dMin) / d0 * 100.0;
+
+        if (baseline) {
+            double worst = 0.0;
+            for (int k = 0; k < nk; ++k) {
+                const double t0 = baseline->thickness[st*nk+k], t = stats.thickness[st*nk+k];
+                if (t0 > 1e-9 && t > 0) worst = std::max(worst, (t0 - t) / t0 * 100.0);
+            }
+            stats.thinning[st] = worst;
+        }
+    }
+}
+
+//确保结果帧列表已建立（用于分析功能）。被内存预算淘汰的帧不在这里读回，
+//分析时用 AcquireResultFrame 逐帧流式读取，否则每次分析都会把全部帧重新装入内存
+bool MainWindow::EnsureResultFramesLoaded()
+{
+    if (!m_resultFrames.empty()) {
+        return true;
+    }
+    if (vtkFilePaths.isEmpty()) {
+        QMessageBox::warning(this, "警告", "没有可用的结果文件，请先打开结果页！");
+        return false;
+    }
+    m_resultReader.precision = static_cast<ResultPrecision>(ui->comboBox_ResultPrecision->currentIndex());
+    for (const auto& fileName : vtkFilePaths) {
+        ResultFrame frame;
+        if (m_resultReader.LoadResultFrame(fileName, frame)) {
+            TouchMemory(kMemResultFrames, fileName);
+            m_resultFrames.push_back(std::move(frame));
+        }
+    }
+    ReportResultMemory();
+    if (m_resultFrames.empty()) {
+        QMessageBox::warning(this, "警告", "结果文件读取失败！");
+        return false;
+    }
+    return true;
+}
+
+//只读地取一帧：在内存中的帧直接返回，被淘汰的帧读到 streamed 中（不放回帧列表，不计入内存预算）。
+//不修改成员状态，可在工作线程中并发调用；streamed 的生存期由调用方控制，同一时刻每个线程只持有一帧
+const ResultFrame* MainWindow::AcquireResultFrame(size_t index, ResultFrame& streamed)
+{
+    const ResultFrame& frame = m_resultFrames[index];
+    if (frame.grid) return &frame;
+    return m_resultReader.LoadResultFrame(frame.filePath, streamed) ? &streamed : nullptr;
+}
+
+//分析用过的常驻帧记为最近使用（GUI 线程，在并行循环之后调用）
+void MainWindow::TouchResidentResultFrames()
+{
+    for (const auto& frame : m_resultFrames) {
+        if (frame.grid) TouchMemory(kMemResultFrames, frame.filePath);
+    }
+}
+
+//所有帧并行计算截面统计
+void MainWindow::RunSectionAnalysis(bool thickness)
+{
+    if (!EnsureResultFramesLoaded() || !EnsureResultFrameLoaded(m_resultFrames.front())) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int numSectors = m_sectionSectors;
+    const int numStations = m_sectionStations;
+    TubeSectionLayout layout;
+    vtkPoints* refPoints = m_resultFrames.front().grid->GetPoints();
+    if (!BuildTubeSectionLayout(m_resultFrames.front().grid, numSectors, numStations, layout)) {
+        QMessageBox::warning(this, "警告", "结果网格无法识别为管体，截面分析失败！");
+        return;
+    }
+
+    // 未变形状态作为壁厚基准
+    TubeSectionStats baseline;
+    ComputeTubeSectionStats(layout, refPoints, nullptr, nullptr, baseline);
+
+    const vtkIdType numFrames = static_cast<vtkIdType>(m_resultFrames.size());
+    std::vector<TubeSectionStats> stats(numFrames);
+    vtkSMPTools::For(0, numFrames, 1, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType f = begin; f < end; ++f) {
+            ResultFrame streamed; // 被内存预算淘汰的帧流式读取，用完即释放
+            const ResultFrame* frame = AcquireResultFrame(f, streamed);
+            if (!frame || frame->grid->GetNumberOfPoints() != refPoints->GetNumberOfPoints()) continue;
+            ComputeTubeSectionStats(layout, frame->grid->GetPoints(), frame->Field("U"), &baseline, stats[f]);
+        }
+    });
+    TouchResidentResultFrames();
+
+    qDebug() << "截面分析完成:" << numFrames << "帧," << layout.tubeNodes.size() << "/" << refPoints->GetNumberOfPoints()
+             << "管体节点, 耗时" << timer.elapsed() << "ms";
+
+    std::vector<std::vector<double>> values(numFrames);
+    for (vtkIdType f = 0; f < numFrames; ++f) {
+        values[f] = thickness ? stats[f].thinning : stats[f].ovality;
+        values[f].resize(numStations, 0.0);
+    }
+    std::vector<double> stations(numStations);
+    for (int st = 0; st < numStations; ++st) {
+        stations[st] = (st + 0.5) * layout.ds;
+    }
+    ShowStationStepCharts(thickness ? "Wall thinning (%)" : "Ovality (%)", stations, values);
+}
+
+//绘制 “站位-数值” 与 “步-最大值” 两幅曲线图
+void MainWindow::ShowStationStepCharts(const QString& title, const std::vector<double>& stations,
+                                       const std::vector<std::vector<double>>& values)
+{
+    if (values.empty()) return;
+
+    QVTKOpenGLNativeWidget *vtkWidget = new QVTKOpenGLNativeWidget(ui->mdiArea);
+    vtkWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow =
+        vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
+    vtkWidget->setRenderWindow(renderWindow);
+
+    m_chartView = vtkSmartPointer<vtkContextView>::New();
+    vtkContextView* view = m_chartView;
+    view->SetRenderWindow(renderWindow);
+    view->GetRenderer()->SetBackground(1, 1, 1);
+
+    vtkSmartPointer<vtkChartMatrix> matrix = vtkSmartPointer<vtkChartMatrix>::New();
+    matrix->SetSize(vtkVector2i(2, 1));
+    view->GetScene()->AddItem(matrix);
+
+    // 左图：若干代表帧沿站位的分布（最多 8 条曲线）
+    const size_t numFrames = values.size();
+    const size_t numCurves = std::min<size_t>(8, numFrames);
+    vtkSmartPointer<vtkTable> stationTable = vtkSmartPointer<vtkTable>::New();
+    vtkSmartPointer<vtkDoubleArray> stationCol = vtkSmartPointer<vtkDoubleArray>::New();
+    stationCol->SetName("Station (mm)");
+    stationTable->AddColumn(stationCol);
+    std::vector<size_t> curveFrames;
+    for (size_t k = 0; k < numCurves; ++k) {
+        const size_t f = numCurves == 1 ? numFrames - 1 : k * (numFrames - 1) / (numCurves - 1);
+        curveFrames.push_back(f);
+        vtkSmartPointer<vtkDoubleArray> col = vtkSmartPointer<vtkDoubleArray>::New();
+        col->SetName(QString("Step %1").arg(f + 1).toStdString().c_str());
+        stationTable->AddColumn(col);
+    }
+    stationTable->SetNumberOfRows(static_cast<vtkIdType>(stations.size()));
+    for (size_t st = 0; st < stations.size(); ++st) {
+        stationTable->SetValue(st, 0, stations[st]);
+        for (size_t k = 0; k < curveFrames.size(); ++k) {
+            stationTable->SetValue(st, k + 1, values[curveFrames[k]][st]);
+        }
+    }
+
+    vtkChart* stationChart = matrix->GetChart(vtkVector2i(0, 0));
+    stationChart->SetTitle(title.toStdString());
+    stationChart->SetShowLegend(true);
+    for (size_t k = 0; k < curveFrames.size(); ++k) {
+        vtkPlot* line = stationChart->AddPlot(vtkChart::LINE);
+        line->SetInputData(stationTable, 0, static_cast<vtkIdType>(k + 1));
+        const double w = curveFrames.size() > 1 ? double(k) / (curveFrames.size() - 1) : 1.0;
+        line->SetColor(static_cast<unsigned char>(255 * w), 0, static_cast<unsigned char>(255 * (1 - w)), 255);
+        line->SetWidth(2.0);
+    }
+    stationChart->GetAxis(vtkAxis::BOTTOM)->SetTitle("Station (mm)");
+    stationChart->GetAxis(vtkAxis::LEFT)->SetTitle(title.toStdString());
+
+    // 右图：每一步沿管长的最大值
+    vtkSmartPointer<vtkTable> stepTable = vtkSmartPointer<vtkTable>::New();
+    vtkSmartPointer<vtkDoubleArray> stepCol = vtkSmartPointer<vtkDoubleArray>::New();
+    stepCol->SetName("Step");
+    vtkSmartPointer<vtkDoubleArray> maxCol = vtkSmartPointer<vtkDoubleArray>::New();
+    maxCol->SetName("Max");
+    stepTable->AddColumn(stepCol);
+    stepTable->AddColumn(maxCol);
+    stepTable->SetNumberOfRows(static_cast<vtkIdType>(numFrames));
+    for (size_t f = 0; f < numFrames; ++f) {
+        const double maxValue = values[f].empty() ? 0.0 : *std::max_element(values[f].begin(), values[f].end());
+        stepTable->SetValue(f, 0, static_cast<double>(f + 1));
+        stepTable->SetValue(f, 1, maxValue);
+    }
+
+    vtkChart* stepChart = matrix->GetChart(vtkVector2i(1, 0));
+    stepChart->SetTitle((title + " max").toStdString());
+    vtkPlot* maxLine = stepChart->AddPlot(vtkChart::LINE);
+    maxLine->SetInputData(stepTable, 0, 1);
+    maxLine->SetColor(0, 0, 0, 255);
+    maxLine->SetWidth(2.0);
+    stepChart->GetAxis(vtkAxis::BOTTOM)->SetTitle("Step");
+    stepChart->GetAxis(vtkAxis::LEFT)->SetTitle(title.toStdString());
+
+    ShowInViewArea(vtkWidget);
+    renderWindow->Render();
+}
+
+//截面划分设置：站位数和周向扇区数
+void MainWindow::onSectionOptionClicked()
+{
+    bool ok = false;
+    const int stations = QInputDialog::getInt(this, "截面分析", "沿管长的站位数:", m_sectionStations, 10, 2000, 10, &ok);
+    if (!ok) return;
+    // 椭圆度按相对扇区求直径，扇区数取偶数
+    const int sectors = QInputDialog::getInt(this, "截面分析", "周向扇区数:", m_sectionSectors, 8, 180, 2, &ok);
+    if (!ok) return;
+    m_sectionStations = stations;
+    m_sectionSectors = sectors + sectors % 2;
+}
+
+//椭圆度（全部帧）
+void MainWindow::onOvalityAllClicked()
+{
+    RunSectionAnalysis(false);
+}
+
+//壁厚减薄（全部帧）
+void MainWindow::onThicknessAllClicked()
+{
+    RunSectionAnalysis(true);
+}
+
+//----------节点探针----------|
+//在结果视图中单击拾取节点，立即绘制该节点 S_Mises、U 和主应力随帧的变化。
+//结果坐标是未变形坐标，同一拓扑的各帧共用一个静态点定位器；
+//时程数据在读取结果后并行转置为节点主序，绘图时每个场只读一段连续内存，不再遍历每一帧
+#include <vtkSMPTools.h>
+#include <vtkContextScene.h>
+#include <vtkChartXY.h>
+#include <vtkChartMatrix.h>
+#include <vtkPlot.h>
+#include <vtkTable.h>
+#include <vtkAxis.h>
+#include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <QVBoxLayout>
+#include <QElapsedTimer>
+#include <limits>
+
+static const char* const kProbeFields[] = {"S_Mises", "U", "S_Principal"};
+
+//按当前各帧生成节点主序的时程数据，帧列表未变化时直接复用
+bool MainWindow::BuildNodeHistory()
+{
+    if (!EnsureResultFramesLoaded()) return false;
+
+    QString key;
+    for (const auto& frame : m_resultFrames) {
+        key += QString("%1:%2:%3;").arg(frame.filePath).arg(frame.fileSize).arg(frame.fileTime);
+    }
+    if (key == m_nodeHistoryKey && !m_nodeHistory.empty()) {
+        TouchMemory(kMemNodeHistory, "探针");
+        return true;
+    }
+
+    if (!EnsureResultFrameLoaded(m_resultFrames.front())) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    const int numFrames = static_cast<int>(m_resultFrames.size());
+    const ResultFrame& first = m_resultFrames.front();
+    const vtkIdType numNodes = first.grid->GetNumberOfPoints();
+
+    // 各场的分量数取自首帧，缺该场或分量数、节点数不一致的帧保持 NaN
+    std::vector<NodeHistoryField> history;
+    for (const char* name : kProbeFields) {
+        const ResultField* field = first.Field(name);
+        if (!field || field->numTuples != numNodes) continue;
+        NodeHistoryField out;
+        out.name = name;
+        out.numComponents = field->numComponents;
+        out.numFrames = numFrames;
+        out.numNodes = numNodes;
+        out.values.assign(static_cast<size_t>(numNodes) * numFrames * out.numComponents,
+                          std::numeric_limits<float>::quiet_NaN());
+        history.push_back(std::move(out));
+    }
+
+    // 逐帧转置：被内存预算淘汰的帧流式读取，同一时刻只多持有一帧；每帧内按节点块并行写入
+    for (int f = 0; f < numFrames; ++f) {
+        ResultFrame streamed;
+        const ResultFrame* frame = AcquireResultFrame(f, streamed);
+        if (!frame) continue;
+        for (NodeHistoryField& out : history) {
+            const ResultField* src = frame->Field(out.name);
+            if (!src || src->numTuples != numNodes || src->numComponents != out.numComponents) continue;
+            const int nc = out.numComponents;
+            float* dst = out.values.data();
+            vtkSMPTools::For(0, numNodes, [&](vtkIdType begin, vtkIdType end) {
+                for (vtkIdType node = begin; node < end; ++node) {
+                    float* v = dst + (static_cast<size_t>(node) * numFrames + f) * nc;
+                    for (int c = 0; c < nc; ++c) {
+                        v[c] = static_cast<float>(src->Value(node, c));
+                    }
+                }
+            });
+        }
+    }
+    TouchResidentResultFrames();
+
+    m_nodeHistory = std::move(history);
+    m_nodeHistoryKey = key;
+    TouchMemory(kMemNodeHistory, "探针");
+    qDebug() << "节点时程数据:" << numNodes << "节点 x" << numFrames << "帧，用时" << timer.elapsed() << "ms";
+    return !m_nodeHistory.empty();
+}
+
+//拾取位置最近的节点，定位器只在拓扑变化时重建
+void MainWindow::ProbeResultNode(const double position[3])
+{
+    if (m_resultFrames.empty() || !EnsureResultFrameLoaded(m_resultFrames.front())) return;
+    vtkUnstructuredGrid* grid = m_resultFrames.front().grid;
+
+    double bounds[6];
+    grid->GetBounds(bounds);
+    const QString topologyKey = QString("%1/%2/%3,%4,%5,%6,%7,%8")
+                                    .arg(grid->GetNumberOfPoints()).arg(grid->GetNumberOfCells())
+                                    .arg(bounds[0]).arg(bounds[1]).arg(bounds[2])
+                                    .arg(bounds[3]).arg(bounds[4]).arg(bounds[5]);
+    if (!m_probeLocator || topologyKey != m_probeTopologyKey) {
+        // 定位器只引用坐标数组，帧被内存预算淘汰后仍可使用
+        vtkSmartPointer<vtkPolyData> nodes = vtkSmartPointer<vtkPolyData>::New();
+        nodes->SetPoints(grid->GetPoints());
+        m_probeLocator = vtkSmartPointer<vtkStaticPointLocator>::New();
+        m_probeLocator->SetDataSet(nodes);
+        m_probeLocator->BuildLocator();
+        m_probeTopologyKey = topologyKey;
+    }
+
+    const vtkIdType node = m_probeLocator->FindClosestPoint(position);
+    if (node < 0) return;
+    if (!BuildNodeHistory()) {
+        QMessageBox::warning(this, "警告", "结果中没有 S_Mises、U 或 S_Principal 场！");
+        return;
+    }
+    double nodePosition[3];
+    grid->GetPoint(node, nodePosition);
+    ShowNodeHistory(node, nodePosition);
+}
+
+//探针窗口：每个场一幅“步-数值”曲线图，多分量场另画各分量
+void MainWindow::ShowNodeHistory(vtkIdType node, const double position[3])
+{
+    if (!m_probePanel) {
+        m_probePanel = new QDialog(this);
+        m_probePanel->setAttribute(Qt::WA_DeleteOnClose);
+        m_probePanel->resize(1000, 360);
+        QVBoxLayout* layout = new QVBoxLayout(m_probePanel);
+        layout->setContentsMargins(0, 0, 0, 0);
+        QVTKOpenGLNativeWidget* vtkWidget = new QVTKOpenGLNativeWidget(m_probePanel);
+        layout->addWidget(vtkWidget);
+        vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow =
+            vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
+        vtkWidget->setRenderWindow(renderWindow);
+        m_probeChartView = vtkSmartPointer<vtkContextView>::New();
+        m_probeChartView->SetRenderWindow(renderWindow);
+        m_probeChartView->GetRenderer()->SetBackground(1, 1, 1);
+        connect(m_probePanel, &QObject::destroyed, this, [this]() { m_probeChartView = nullptr; });
+    }
+    m_probePanel->setWindowTitle(QString("节点探针 - 节点 %1 (%2, %3, %4)")
+                                     .arg(node + 1)
+                                     .arg(position[0], 0, 'f', 3)
+                                     .arg(position[1], 0, 'f', 3)
+                                     .arg(position[2], 0, 'f', 3));
+
+    vtkContextScene* scene = m_probeChartView->GetScene();
+    scene->ClearItems();
+    vtkSmartPointer<vtkChartMatrix> matrix = vtkSmartPointer<vtkChartMatrix>::New();
+    matrix->SetSize(vtkVector2i(static_cast<int>(m_nodeHistory.size()), 1));
+    scene->AddItem(matrix);
+
+    static const unsigned char kColors[][3] = {{0, 0, 0}, {214, 39, 40}, {44, 160, 44}, {31, 119, 180}};
+    for (size_t k = 0; k < m_nodeHistory.size(); ++k) {
+        const NodeHistoryField& field = m_nodeHistory[k];
+        const float* values = field.Node(node);
+        const int nc = field.numComponents;
+
+        // 列：步、(多分量时) 模、各分量
+        vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+        vtkSmartPointer<vtkDoubleArray> stepCol = vtkSmartPointer<vtkDoubleArray>::New();
+        stepCol->SetName("Step");
+        table->AddColumn(stepCol);
+        const bool isVector = field.name == "U" && nc > 1;
+        QStringList names;
+        if (isVector) names << QString("|%1|").arg(field.name.c_str());
+        for (int c = 0; c < nc; ++c) {
+            names << (nc == 1 ? QString(field.name.c_str()) : QString("%1%2").arg(field.name.c_str()).arg(c + 1));
+        }
+        for (const QString& name : names) {
+            vtkSmartPointer<vtkFloatArray> col = vtkSmartPointer<vtkFloatArray>::New();
+            col->SetName(name.toStdString().c_str());
+            table->AddColumn(col);
+        }
+        table->SetNumberOfRows(field.numFrames);
+        for (int f = 0; f < field.numFrames; ++f) {
+            const float* v = values + static_cast<size_t>(f) * nc;
+            int col = 0;
+            table->SetValue(f, col++, static_cast<double>(f + 1));
+            if (isVector) {
+                double sq = 0.0;
+                for (int c = 0; c < nc; ++c) sq += double(v[c]) * v[c];
+                table->SetValue(f, col++, std::sqrt(sq));
+            }
+            for (int c = 0; c < nc; ++c) {
+                table->SetValue(f, col++, v[c]);
+            }
+        }
+
+        vtkChart* chart = matrix->GetChart(vtkVector2i(static_cast<int>(k), 0));
+        chart->SetTitle(field.name);
+        chart->SetShowLegend(names.size() > 1);
+        for (int col = 1; col <= names.size(); ++col) {
+            vtkPlot* line = chart->AddPlot(vtkChart::LINE);
+            line->SetInputData(table, 0, col);
+            const unsigned char* rgb = kColors[(col - 1) % 4];
+            line->SetColor(rgb[0], rgb[1], rgb[2], 255);
+            line->SetWidth(col == 1 ? 2.0 : 1.5);
+        }
+        chart->GetAxis(vtkAxis::BOTTOM)->SetTitle("Step");
+        chart->GetAxis(vtkAxis::LEFT)->SetTitle(field.name);
+    }
+
+    m_probePanel->show();
+    m_probePanel->raise();
+    m_probeChartView->GetRenderWindow()->Render();
+    statusBar()->showMessage(QString("探针: 节点 %1，%2 帧").arg(node + 1).arg(m_resultFrames.size()));
+}
+
+//----------剖切面----------|
+//切片（平面上的精确截面）和剖切（保留平面正侧的整单元）。结果坐标是未变形坐标，各帧共用拓扑，
+//切面几何只在平面移动时并行重算一次，记下每个输出点所在的边和插值权重；
+//切换帧或场时只按权重插值，拖动位置滑块时也只重算几何，因此可以交互拖动
+#include <vtkSMPTools.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkCellArray.h>
+#include <vtkCellType.h>
+#include <vtkExtractCells.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkPolyDataMapper.h>
+#include <QComboBox>
+#include <QSlider>
+#include <QLabel>
+
+// 线性单元（及二次单元的角点）的边表，每条边两个局部节点号
+static const int* CellEdgeTable(int cellType, int& numEdges)
+{
+    static const int kTriangle[] = {0, 1, 1, 2, 2, 0};
+    static const int kQuad[] = {0, 1, 1, 2, 2, 3, 3, 0};
+    static const int kTetra[] = {0, 1, 1, 2, 2, 0, 0, 3, 1, 3, 2, 3};
+    static const int kHexahedron[] = {0, 1, 1, 2, 3, 2, 0, 3, 4, 5, 5, 6, 7, 6, 4, 7, 0, 4, 1, 5, 3, 7, 2, 6};
+    static const int kWedge[] = {0, 1, 1, 2, 2, 0, 3, 4, 4, 5, 5, 3, 0, 3, 1, 4, 2, 5};
+    static const int kPyramid[] = {0, 1, 1, 2, 2, 3, 3, 0, 0, 4, 1, 4, 2, 4, 3, 4};
+    switch (cellType) {
+    case VTK_TRIANGLE: case VTK_QUADRATIC_TRIANGLE: numEdges = 3; return kTriangle;
+    case VTK_QUAD: case VTK_QUADRATIC_QUAD: numEdges = 4; return kQuad;
+    case VTK_TETRA: case VTK_QUADRATIC_TETRA: numEdges = 6; return kTetra;
+    case VTK_HEXAHEDRON: case VTK_QUADRATIC_HEXAHEDRON: numEdges = 12; return kHexahedron;
+    case VTK_WEDGE: case VTK_QUADRATIC_WEDGE: numEdges = 9; return kWedge;
+    case VTK_PYRAMID: case VTK_QUADRATIC_PYRAMID: numEdges = 8; return kPyramid;
+    default: numEdges = 0; return nullptr;
+    }
+}
+
+// 各节点到平面的有符号距离
+static void PlaneDistances(vtkPoints* points, const double origin[3], const double normal[3], std::vector<double>& dist)
+{
+    const vtkIdType n = points->GetNumberOfPoints();
+    dist.resize(n);
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+        double p[3];
+        for (vtkIdType i = begin; i < end; ++i) {
+            points->GetPoint(i, p);
+            dist[i] = (p[0] - origin[0]) * normal[0] + (p[1] - origin[1]) * normal[1] + (p[2] - origin[2]) * normal[2];
+        }
+    });
+}
+
+// 切片：每个单元与平面的交点按平面内极角排序成凸多边形（壳单元为线段）。
+// 两遍并行：先数每个单元的交点，前缀和定位后再填写，输出与线程数无关
+static void SliceGridByPlane(vtkUnstructuredGrid* grid, const double origin[3], const double normal[3], CutGeometry& cut)
+{
+    std::vector<double> dist;
+    PlaneDistances(grid->GetPoints(), origin, normal, dist);
+
+    const vtkIdType numCells = grid->GetNumberOfCells();
+    std::vector<vtkIdType> offsets(numCells + 1, 0);
+    vtkSMPThreadLocalObject<vtkIdList> localIds;
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        vtkIdList* ids = localIds.Local();
+        for (vtkIdType c = begin; c < end; ++c) {
+            int numEdges = 0;
+            const int* edges = CellEdgeTable(grid->GetCellType(c), numEdges);
+            if (!edges) continue;
+            vtkIdType npts;
+            const vtkIdType* pts;
+            grid->GetCellPoints(c, npts, pts, ids);
+            vtkIdType count = 0;
+            for (int e = 0; e < numEdges; ++e) {
+                if ((dist[pts[edges[2 * e]]] >= 0) != (dist[pts[edges[2 * e + 1]]] >= 0)) count++;
+            }
+            offsets[c + 1] = count >= 2 ? count : 0;
+        }
+    });
+    for (vtkIdType c = 0; c < numCells; ++c) offsets[c + 1] += offsets[c];
+
+    const vtkIdType total = offsets[numCells];
+    cut.pointA.resize(total);
+    cut.pointB.resize(total);
+    cut.weight.resize(total);
+    vtkSmartPointer<vtkPoints> outPoints = vtkSmartPointer<vtkPoints>::New();
+    outPoints->SetDataTypeToFloat();
+    outPoints->SetNumberOfPoints(total);
+    float* xyz = static_cast<float*>(outPoints->GetVoidPointer(0));
+
+    // 平面内的两个正交方向，用于交点排序
+    double u[3], v[3], ref[3] = {0, 0, 1};
+    if (std::fabs(Dot3(ref, normal)) > 0.9) { ref[1] = 1; ref[2] = 0; }
+    Cross3(normal, ref, u);
+    Normalize3(u);
+    Cross3(normal, u, v);
+
+    vtkPoints* points = grid->GetPoints();
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        vtkIdList* ids = localIds.Local();
+        struct Hit { vtkIdType a, b; double w, angle, p[3]; };
+        Hit hits[12];
+        for (vtkIdType c = begin; c < end; ++c) {
+            const vtkIdType first = offsets[c];
+            if (offsets[c + 1] == first) continue;
+            int numEdges = 0;
+            const int* edges = CellEdgeTable(grid->GetCellType(c), numEdges);
+            vtkIdType npts;
+            const vtkIdType* pts;
+            grid->GetCellPoints(c, npts, pts, ids);
+            int count = 0;
+            double centroid[3] = {0, 0, 0};
+            for (int e = 0; e < numEdges; ++e) {
+                const vtkIdType a = pts[edges[2 * e]], b = pts[edges[2 * e + 1]];
+                if ((dist[a] >= 0) == (dist[b] >= 0)) continue;
+                Hit& h = hits[count++];
+                h.a = a;
+                h.b = b;
+                h.w = dist[a] / (dist[a] - dist[b]);
+                double pa[3], pb[3];
+                points->GetPoint(a, pa);
+                points->GetPoint(b, pb);
+                for (int k = 0; k < 3; ++k) {
+                    h.p[k] = pa[k] + h.w * (pb[k] - pa[k]);
+                    centroid[k] += h.p[k];
+                }
+            }
+            for (int k = 0; k < 3; ++k) centroid[k] /= count;
+            for (int i = 0; i < count; ++i) {
+                const double d[3] = {hits[i].p[0] - centroid[0], hits[i].p[1] - centroid[1], hits[i].p[2] - centroid[2]};
+                hits[i].angle = std::atan2(Dot3(d, v), Dot3(d, u));
+            }
+            std::sort(hits, hits + count, [](const Hit& x, const Hit& y) { return x.angle < y.angle; });
+            for (int i = 0; i < count; ++i) {
+                const vtkIdType o = first + i;
+                cut.pointA[o] = hits[i].a;
+                cut.pointB[o] = hits[i].b;
+                cut.weight[o] = static_cast<float>(hits[i].w);
+                xyz[3 * o] = static_cast<float>(hits[i].p[0]);
+                xyz[3 * o + 1] = static_cast<float>(hits[i].p[1]);
+                xyz[3 * o + 2] = static_cast<float>(hits[i].p[2]);
+            }
+        }
+    });
+
+    // 每个单元的交点连续存放，多边形（线段）的连接关系就是顺序编号
+    vtkSmartPointer<vtkIdTypeArray> polyOffsets = vtkSmartPointer<vtkIdTypeArray>::New();
+    vtkSmartPointer<vtkIdTypeArray> polyConn = vtkSmartPointer<vtkIdTypeArray>::New();
+    vtkSmartPointer<vtkIdTypeArray> lineOffsets = vtkSmartPointer<vtkIdTypeArray>::New();
+    vtkSmartPointer<vtkIdTypeArray> lineConn = vtkSmartPointer<vtkIdTypeArray>::New();
+    polyOffsets->InsertNextValue(0);
+    lineOffsets->InsertNextValue(0);
+    for (vtkIdType c = 0; c < numCells; ++c) {
+        const vtkIdType count = offsets[c + 1] - offsets[c];
+        if (count == 0) continue;
+        vtkIdTypeArray* conn = count == 2 ? lineConn.Get() : polyConn.Get();
+        for (vtkIdType i = offsets[c]; i < offsets[c + 1]; ++i) conn->InsertNextValue(i);
+        (count == 2 ? lineOffsets : polyOffsets)->InsertNextValue(conn->GetNumberOfValues());
+    }
+    vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+    polys->SetData(polyOffsets, polyConn);
+    vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+    lines->SetData(lineOffsets, lineConn);
+
+    cut.polyData = vtkSmartPointer<vtkPolyData>::New();
+    cut.polyData->SetPoints(outPoints);
+    cut.polyData->SetPolys(polys);
+    cut.polyData->SetLines(lines);
+}
+
+// 剖切：保留至少一个节点位于平面正侧的整单元，取其外表面；输出点就是原节点
+static void ClipGridByPlane(vtkUnstructuredGrid* grid, const double origin[3], const double normal[3], CutGeometry& cut)
+{
+    std::vector<double> dist;
+    PlaneDistances(grid->GetPoints(), origin, normal, dist);
+
+    const vtkIdType numCells = grid->GetNumberOfCells();
+    std::vector<unsigned char> keep(numCells, 0);
+    vtkSMPThreadLocalObject<vtkIdList> localIds;
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        vtkIdList* ids = localIds.Local();
+        for (vtkIdType c = begin; c < end; ++c) {
+            vtkIdType npts;
+            const vtkIdType* pts;
+            grid->GetCellPoints(c, npts, pts, ids);
+            for (vtkIdType i = 0; i < npts && !keep[c]; ++i) {
+                keep[c] = dist[pts[i]] >= 0;
+            }
+        }
+    });
+    vtkSmartPointer<vtkIdList> kept = vtkSmartPointer<vtkIdList>::New();
+    for (vtkIdType c = 0; c < numCells; ++c) {
+        if (keep[c]) kept->InsertNextId(c);
+    }
+
+    // 只用拓扑和坐标，点数据场不参与
+    vtkSmartPointer<vtkUnstructuredGrid> topology = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    topology->ShallowCopy(grid);
+    topology->GetPointData()->Initialize();
+    topology->GetCellData()->Initialize();
+    vtkSmartPointer<vtkExtractCells> extract = vtkSmartPointer<vtkExtractCells>::New();
+    extract->SetInputData(topology);
+    extract->SetCellList(kept);
+    vtkSmartPointer<vtkDataSetSurfaceFilter> surface = vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+    surface->SetInputConnection(extract->GetOutputPort());
+    surface->PassThroughPointIdsOn();
+    surface->Update();
+
+    cut.polyData = vtkSmartPointer<vtkPolyData>::New();
+    cut.polyData->ShallowCopy(surface->GetOutput());
+    vtkIdTypeArray* originalIds = vtkIdTypeArray::SafeDownCast(cut.polyData->GetPointData()->GetArray("vtkOriginalPointIds"));
+    const vtkIdType n = cut.polyData->GetNumberOfPoints();
+    cut.pointA.resize(n);
+    cut.weight.assign(n, 0.0f);
+    for (vtkIdType i = 0; i < n; ++i) {
+        cut.pointA[i] = originalIds ? originalIds->GetValue(i) : i;
+    }
+    cut.pointB = cut.pointA;
+    cut.polyData->GetPointData()->Initialize();
+}
+
+//按平面重算切面几何（不插值场）
+bool MainWindow::UpdateCutGeometry(bool clip, const double origin[3], const double normal[3])
+{
+    if (m_resultFrames.empty() || !EnsureResultFrameLoaded(m_resultFrames.front())) return false;
+    vtkUnstructuredGrid* grid = m_resultFrames.front().grid;
+    if (clip) {
+        ClipGridByPlane(grid, origin, normal, m_cut);
+    } else {
+        SliceGridByPlane(grid, origin, normal, m_cut);
+    }
+    m_cut.numNodes = grid->GetNumberOfPoints();
+    vtkPolyDataMapper::SafeDownCast(m_cut.actor->GetMapper())->SetInputData(m_cut.polyData);
+    return true;
+}
+
+//按记录的边和权重插值一帧的一个场，几何不变
+void MainWindow::UpdateCutScalars(int frameIndex, const QString& fieldName)
+{
+    if (!m_cut.polyData || frameIndex < 0 || frameIndex >= static_cast<int>(m_resultFrames.size())) return;
+    ResultFrame& frame = m_resultFrames[frameIndex];
+    if (!EnsureResultFrameLoaded(frame)) return;
+    const ResultField* field = frame.Field(fieldName.toStdString());
+    vtkPolyDataMapper* mapper = vtkPolyDataMapper::SafeDownCast(m_cut.actor->GetMapper());
+    if (!field || field->numTuples != m_cut.numNodes) {
+        m_cut.polyData->GetPointData()->Initialize();
+        mapper->SetScalarVisibility(false);
+        return;
+    }
+
+    const int nc = field->numComponents;
+    const vtkIdType n = static_cast<vtkIdType>(m_cut.weight.size());
+    vtkSmartPointer<vtkFloatArray> values = vtkSmartPointer<vtkFloatArray>::New();
+    values->SetName(field->name.c_str());
+    values->SetNumberOfComponents(nc);
+    values->SetNumberOfTuples(n);
+    float* out = values->GetPointer(0);
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i) {
+            const double w = m_cut.weight[i];
+            for (int c = 0; c < nc; ++c) {
+                const double a = field->Value(m_cut.pointA[i], c);
+                const double b = w > 0 ? field->Value(m_cut.pointB[i], c) : a;
+                out[i * nc + c] = static_cast<float>(a + w * (b - a));
+            }
+        }
+    });
+
+    m_cut.polyData->GetPointData()->Initialize();
+    m_cut.polyData->GetPointData()->SetScalars(values);
+    double range[2];
+    values->GetRange(range, nc > 1 ? -1 : 0);
+    if (range[0] >= range[1]) {
+        range[0] = 0;
+        range[1] = 1;
+    }
+    mapper->SetScalarVisibility(true);
+    mapper->SetScalarRange(range);
+    m_cut.scalarBar->SetTitle(field->name.c_str());
+}
+
+//剖切面面板：模式、平面、位置滑块、帧和场，关闭面板后切面保留在 "cut" 图层
+void MainWindow::onCutPlaneClicked()
+{
+    if (!EnsureResultFramesLoaded() || !EnsureResultFrameLoaded(m_resultFrames.front())) return;
+    vtkUnstructuredGrid* grid = m_resultFrames.front().grid;
+    QStringList fieldNames;
+    for (const auto& field : m_resultFrames.front().fields) {
+        fieldNames << QString::fromStdString(field.name);
+    }
+    if (fieldNames.isEmpty()) {
+        QMessageBox::warning(this, "警告", "结果文件中没有点数据场！");
+        return;
+    }
+
+    // 管轴和弧长范围：未变形管体是直管，按弧长垂直中心线的平面就是垂直管轴的平面
+    TubeSectionLayout layout;
+    const bool hasAxis = BuildTubeSectionLayout(grid, 36, 1, layout);
+    double bounds[6];
+    grid->GetBounds(bounds);
+    const double tubeLength = hasAxis ? layout.ds * layout.numStations : 0.0;
+    double axis[3], axisStart[3];
+    for (int k = 0; k < 3; ++k) {
+        axis[k] = layout.axis[k];
+        axisStart[k] = layout.center[k] + layout.s0 * layout.axis[k];
+    }
+
+    if (m_cutPanel) m_cutPanel->close();
+    if (!m_cut.actor) {
+        m_cut.actor = vtkSmartPointer<vtkActor>::New();
+        vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        m_cut.lut = vtkSmartPointer<vtkLookupTable>::New();
+        m_cut.lut->SetHueRange(0.666667, 0.0);
+        m_cut.lut->Build();
+        mapper->SetLookupTable(m_cut.lut);
+        mapper->SetScalarModeToUsePointData();
+        m_cut.actor->SetMapper(mapper);
+        m_cut.actor->GetProperty()->EdgeVisibilityOn();
+        m_cut.actor->GetProperty()->SetLineWidth(2.0);
+        m_cut.scalarBar = vtkSmartPointer<vtkScalarBarActor>::New();
+        m_cut.scalarBar->SetLookupTable(m_cut.lut);
+        m_cut.scalarBar->SetNumberOfLabels(10);
+        m_cut.scalarBar->GetLabelTextProperty()->SetColor(0.0, 0.0, 0.0);
+        m_cut.scalarBar->GetTitleTextProperty()->SetColor(0.0, 0.0, 0.0);
+        m_cut.scalarBar->SetWidth(0.1);
+        m_cut.scalarBar->SetHeight(0.8);
+    }
+    SetSceneLayer("cut", {m_cut.actor, m_cut.scalarBar});
+
+    QDialog* panel = new QDialog(this);
+    m_cutPanel = panel;
+    panel->setWindowTitle("剖切面");
+    panel->setAttribute(Qt::WA_DeleteOnClose);
+    QFormLayout* form = new QFormLayout(panel);
+    QComboBox* modeCombo = new QComboBox(panel);
+    modeCombo->addItems({"切片", "剖切（保留正侧）"});
+    QComboBox* planeCombo = new QComboBox(panel);
+    if (hasAxis) planeCombo->addItem("垂直中心线（弧长）");
+    planeCombo->addItems({"垂直 X", "垂直 Y", "垂直 Z"});
+    QSlider* positionSlider = new QSlider(Qt::Horizontal, panel);
+    positionSlider->setRange(0, 1000);
+    positionSlider->setValue(500);
+    positionSlider->setMinimumWidth(320);
+    QLabel* positionLabel = new QLabel(panel);
+    QComboBox* frameCombo = new QComboBox(panel);
+    for (size_t f = 0; f < m_resultFrames.size(); ++f) {
+        frameCombo->addItem(QString("Step %1 (%2)").arg(f + 1).arg(QFileInfo(m_resultFrames[f].filePath).fileName()));
+    }
+    frameCombo->setCurrentIndex(frameCombo->count() - 1);
+    QComboBox* fieldCombo = new QComboBox(panel);
+    fieldCombo->addItems(fieldNames);
+    fieldCombo->setCurrentText(fieldNames.contains(m_resultScalarType) ? m_resultScalarType : fieldNames.front());
+    form->addRow("模式:", modeCombo);
+    form->addRow("平面:", planeCombo);
+    form->addRow("位置:", positionSlider);
+    form->addRow("", positionLabel);
+    form->addRow("帧:", frameCombo);
+    form->addRow("场:", fieldCombo);
+
+    // 只换帧或场：按已有几何重新插值
+    auto updateScalars = [this, frameCombo, fieldCombo]() {
+        UpdateCutScalars(frameCombo->currentIndex(), fieldCombo->currentText());
+        m_viewWindow->Render();
+    };
+    // 平面移动：重算几何后插值
+    auto updateGeometry = [=]() {
+        const double t = positionSlider->value() / 1000.0;
+        double origin[3] = {0.5 * (bounds[0] + bounds[1]), 0.5 * (bounds[2] + bounds[3]), 0.5 * (bounds[4] + bounds[5])};
+        double normal[3] = {0, 0, 0};
+        const int plane = planeCombo->currentIndex() - (hasAxis ? 1 : 0);
+        if (plane < 0) {
+            const double s = t * tubeLength;
+            for (int k = 0; k < 3; ++k) {
+                origin[k] = axisStart[k] + s * axis[k];
+                normal[k] = axis[k];
+            }
+            positionLabel->setText(QString("弧长 %1 / %2 mm").arg(s, 0, 'f', 2).arg(tubeLength, 0, 'f', 2));
+        } else {
+            origin[plane] = bounds[2 * plane] + t * (bounds[2 * plane + 1] - bounds[2 * plane]);
+            normal[plane] = 1.0;
+            positionLabel->setText(QString("%1 = %2 mm").arg(QString("XYZ").at(plane)).arg(origin[plane], 0, 'f', 2));
+        }
+        if (UpdateCutGeometry(modeCombo->currentIndex() == 1, origin, normal)) {
+            updateScalars();
+        }
+    };
+    connect(modeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), panel, updateGeometry);
+    connect(planeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), panel, updateGeometry);
+    connect(positionSlider, &QSlider::valueChanged, panel, updateGeometry);
+    connect(frameCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), panel, updateScalars);
+    connect(fieldCombo, &QComboBox::currentTextChanged, panel, updateScalars);
+
+    updateGeometry();
+    ShowSceneLayers({"cut"});
+    panel->show();
+}
+
+//----------褶皱检测----------|
+#include <QInputDialog>
+#include <QTextStream>
+#include <complex>
+
+// 单帧褶皱扫描结果
+struct WrinkleScanResult {
+    int intradosSector = -1;      // 内弧侧扇区
+    double amplitude = 0.0;       // 最大半波幅 (mm)
+    double wavelength = 0.0;      // 主波长 (mm)
+    double location = 0.0;        // 最大波幅所在站位 (mm)
+    std::vector<double> profile;  // 去趋势后的内弧线径向偏差，按站位
+};
+
+// 沿内弧线扫描褶皱：
+// 1. 由相邻站位切向的变化得到弯曲方向，扇区方向与弯曲方向最一致的即为内弧
+// 2. 取内弧两侧若干条平行于中心线的母线，外壁半径减去滑动平均得到波动量
+// 3. 峰谷分析给出波幅，离散傅里叶变换的主频给出波长
+static void ScanIntradosWrinkles(const TubeSectionLayout& layout, const TubeSectionStats& stats,
+                                 int lineHalfWidth, WrinkleScanResult& result)
+{
+    const int ns = layout.numStations, nk = layout.numSectors;
+    if (ns < 8 || stats.tangent.size() != static_cast<size_t>(ns) * 3) return;
+
+    // 1. 弯曲方向加权投票
+    std::vector<double> score(nk, 0.0);
+    for (int st = 1; st < ns - 1; ++st) {
+        const double* ta = &stats.tangent[(st - 1) * 3];
+        const double* tb = &stats.tangent[(st + 1) * 3];
+        double bend[3] = {tb[0] - ta[0], tb[1] - ta[1], tb[2] - ta[2]};
+        const double kappa = std::sqrt(Dot3(bend, bend));
+        if (kappa < 1e-9) continue;
+        for (int k = 0; k < nk; ++k) {
+            if (stats.outerRadius[st*nk+k] < 0) continue;
+            score[k] += Dot3(&stats.outerDir[(st * nk + k) * 3], bend);
+        }
+    }
+    result.intradosSector = static_cast<int>(std::max_element(score.begin(), score.end()) - score.begin());
+
+    // 2. 内弧母线的去趋势径向偏差
+    const int window = std::max(3, static_cast<int>(layout.rOut / layout.ds));
+    result.profile.assign(ns, 0.0);
+    std::vector<int> lines(ns, 0);
+    for (int dk = -lineHalfWidth; dk <= lineHalfWidth; ++dk) {
+        const int k = ((result.intradosSector + dk) % nk + nk) % nk;
+        for (int st = 0; st < ns; ++st) {
+            const double r = stats.outerRadius[st*nk+k];
+            if (r < 0) continue;
+            double trend = 0.0;
+            int count = 0;
+            for (int j = std::max(0, st - window); j <= std::min(ns - 1, st + window); ++j) {
+                const double rj = stats.outerRadius[j*nk+k];
+                if (rj < 0) continue;
+                trend += rj;
+                count++;
+            }
+            result.profile[st] += r - trend / count;
+            lines[st]++;
+        }
+    }
+    for (int st = 0; st < ns; ++st) {
+        if (lines[st] > 0) result.profile[st] /= lines[st];
+    }
+
+    // 3a. 峰谷分析：相邻极值之差的一半即为半波幅
+    const std::vector<double>& h = result.profile;
+    int lastExtremum = -1;
+    for (int st = 1; st < ns - 1; ++st) {
+        const bool isPeak = h[st] > h[st - 1] && h[st] >= h[st + 1];
+        const bool isTrough = h[st] < h[st - 1] && h[st] <= h[st + 1];
+        if (!isPeak && !isTrough) continue;
+        if (lastExtremum >= 0) {
+            const double amp = 0.5 * std::fabs(h[st] - h[lastExtremum]);
+            if (amp > result.amplitude) {
+                result.amplitude = amp;
+                result.location = (0.5 * (st + lastExtremum) + 0.5) * layout.ds;
+            }
+        }
+        lastExtremum = st;
+    }
+
+    // 3b. 主波长：跳过直流和趋势窗口以下的低频
+    const int minBin = std::max(1, ns / (2 * window));
+    double bestPower = 0.0;
+    for (int m = minBin; m <= ns / 2; ++m) {
+        std::complex<double> acc(0.0, 0.0);
+        for (int st = 0; st < ns; ++st) {
+            acc += h[st] * std::polar(1.0, -2.0 * M_PI * m * st / ns);
+        }
+        const double power = std::norm(acc);
+        if (power > bestPower) {
+            bestPower = power;
+            result.wavelength = ns * layout.ds / m;
+        }
+    }
+}
+
+//褶皱扫描：已加载的帧直接使用，否则逐帧流式读取，同一时刻每个线程只持有一帧
+void MainWindow::RunWrinkleScan(bool allFrames)
+{
+    const bool framesLoaded = !m_resultFrames.empty();
+    QStringList files;
+    if (framesLoaded) {
+        for (const auto& frame : m_resultFrames) files << frame.filePath;
+    } else {
+        files = vtkFilePaths;
+    }
+    if (files.isEmpty()) {
+        QMessageBox::warning(this, "警告", "没有可用的结果文件，请先打开结果页！");
+        return;
+    }
+    if (!allFrames) {
+        files = QStringList{files.last()};
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    m_resultReader.precision = static_cast<ResultPrecision>(ui->comboBox_ResultPrecision->currentIndex());
+
+    // 截面划分只依赖未变形坐标，取第一帧建立一次；只有管体区域的节点参与，
+    // 内弧扇区、截面形心和波幅都不受套筒和模具节点影响。站位取截面分析的两倍，以分辨褶皱波长
+    ResultFrame refFrame;
+    vtkUnstructuredGrid* refGrid = nullptr;
+    if (framesLoaded && m_resultFrames.front().grid) {
+        refGrid = m_resultFrames.front().grid;
+    } else if (m_resultReader.LoadResultFrame(files.front(), refFrame)) {
+        refGrid = refFrame.grid;
+    }
+    vtkPoints* refPoints = refGrid ? refGrid->GetPoints() : nullptr;
+    TubeSectionLayout layout;
+    if (!refPoints || !BuildTubeSectionLayout(refGrid, m_sectionSectors, 2 * m_sectionStations, layout)) {
+        QMessageBox::warning(this, "警告", "结果网格无法识别为管体，褶皱检测失败！");
+        return;
+    }
+    const vtkIdType numPoints = refPoints->GetNumberOfPoints();
+    const vtkIdType numCells = refGrid->GetNumberOfCells();
+    const int lineHalfWidth = 2;
+
+    const vtkIdType numFrames = files.size();
+    const vtkIdType frameOffset = framesLoaded ? static_cast<vtkIdType>(m_resultFrames.size()) - numFrames : 0;
+    std::vector<WrinkleScanResult> results(numFrames);
+    vtkSMPTools::For(0, numFrames, 1, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType f = begin; f < end; ++f) {
+            ResultFrame streamed;
+            const ResultFrame* frame = nullptr;
+            if (framesLoaded && m_resultFrames[frameOffset + f].grid) {
+                frame = &m_resultFrames[frameOffset + f];
+            } else if (m_resultReader.LoadResultFrame(files[f], streamed)) { // 未加载或已被内存预算淘汰的帧流式读取
+                frame = &streamed;
+            }
+            // 管体区域按参考帧划分，拓扑不同的帧不参与
+            if (!frame || frame->grid->GetNumberOfPoints() != numPoints || frame->grid->GetNumberOfCells() != numCells) continue;
+
+            TubeSectionStats stats;
+            ComputeTubeSectionStats(layout, frame->grid->GetPoints(), frame->Field("U"), nullptr, stats);
+            ScanIntradosWrinkles(layout, stats, lineHalfWidth, results[f]);
+        }
+    });
+
+    if (framesLoaded) TouchResidentResultFrames();
+
+    qDebug() << "褶皱检测完成:" << numFrames << "帧," << layout.tubeNodes.size() << "/" << numPoints
+             << "管体节点, 耗时" << timer.elapsed() << "ms";
+
+    // 筛查：超过阈值的帧
+    int firstWrinkled = -1;
+    double worstAmp = 0.0, worstLambda = 0.0, worstLoc = 0.0;
+    for (vtkIdType f = 0; f < numFrames; ++f) {
+        if (results[f].amplitude >= m_wrinkleThreshold && firstWrinkled < 0) firstWrinkled = static_cast<int>(f);
+        if (results[f].amplitude > worstAmp) {
+            worstAmp = results[f].amplitude;
+            worstLambda = results[f].wavelength;
+            worstLoc = results[f].location;
+        }
+    }
+
+    // 报告写到结果目录，便于批量筛查
+    const QString reportPath = QFileInfo(files.front()).absolutePath() + "/wrinkle_report.csv";
+    QFile report(reportPath);
+    if (report.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream out(&report);
+        out << "file,intrados_sector,amplitude_mm,wavelength_mm,location_mm,wrinkled\n";
+        for (vtkIdType f = 0; f < numFrames; ++f) {
+            const WrinkleScanResult& r = results[f];
+            out << QFileInfo(files[f]).fileName() << "," << r.intradosSector << "," << r.amplitude << ","
+                << r.wavelength << "," << r.location << "," << (r.amplitude >= m_wrinkleThreshold ? 1 : 0) << "\n";
+        }
+        report.close();
+    } else {
+        qDebug() << "无法写入褶皱报告:" << reportPath;
+    }
+
+    if (allFrames) {
+        std::vector<std::vector<double>> values(numFrames);
+        for (vtkIdType f = 0; f < numFrames; ++f) {
+            values[f] = results[f].profile;
+            values[f].resize(layout.numStations, 0.0);
+        }
+        std::vector<double> stations(layout.numStations);
+        for (int st = 0; st < layout.numStations; ++st) {
+            stations[st] = (st + 0.5) * layout.ds;
+        }
+        ShowStationStepCharts("Intrados wrinkle (mm)", stations, values);
+    }
+
+    const QString verdict = worstAmp >= m_wrinkleThreshold
+        ? QString("检测到褶皱（首次出现于第 %1 帧）").arg(firstWrinkled + 1)
+        : QString("未检测到褶皱");
+    QMessageBox::information(this, "褶皱检测",
+        QString("%1\n最大波幅: %2 mm\n波长: %3 mm\n位置: %4 mm\n阈值: %5 mm\n报告: %6")
+            .arg(verdict)
+            .arg(worstAmp, 0, 'f', 4)
+            .arg(worstLambda, 0, 'f', 2)
+            .arg(worstLoc, 0, 'f', 2)
+            .arg(m_wrinkleThreshold)
+            .arg(reportPath));
+}
+
+//褶皱（最终帧）
+void MainWindow::onWrinklesClicked()
+{
+    RunWrinkleScan(false);
+}
+
+//褶皱（全部帧）
+void MainWindow::onWrinklesAllClicked()
+{
+    RunWrinkleScan(true);
+}
+
+//褶皱判定阈值
+void MainWindow::onWrinklesOptionClicked()
+{
+    bool ok = false;
+    double value = QInputDialog::getDouble(this, "褶皱检测", "波幅阈值 (mm):", m_wrinkleThreshold, 0.0, 100.0, 4, &ok);
+    if (ok) {
+        m_wrinkleThreshold = value;
+    }
+}
+
+//----------回弹测量----------|
+#include <vtkExtractCells.h>
+#include <numeric>
+#include <limits>
+
+// 静态 k-d 树：点坐标按中位数原地划分，查询时不分配内存，可多线程并发查询
+class PointKdTree {
+public:
+    void Build(const std::vector<double>& xyz)
+    {
+        m_points = xyz;
+        m_index.resize(xyz.size() / 3);
+        std::iota(m_index.begin(), m_index.end(), 0);
+        Build(0, static_cast<int>(m_index.size()), 0);
+    }
+
+    // 返回最近点编号，d2 为距离平方
+    int Nearest(const double* q, double& d2) const
+    {
+        int best = -1;
+        d2 = std::numeric_limits<double>::max();
+        if (!m_index.empty()) Search(0, static_cast<int>(m_index.size()), 0, q, best, d2);
+        return best;
+    }
+
+    const double* Point(int id) const { return &m_points[id * 3]; }
+
+private:
+    std::vector<double> m_points;
+    std::vector<int> m_index;
+
+    void Build(int lo, int hi, int depth)
+    {
+        if (hi - lo <= 1) return;
+        const int axis = depth % 3, mid = (lo + hi) / 2;
+        std::nth_element(m_index.begin() + lo, m_index.begin() + mid, m_index.begin() + hi,
+                         [&](int a, int b) { return m_points[a*3+axis] < m_points[b*3+axis]; });
+        Build(lo, mid, depth + 1);
+        Build(mid + 1, hi, depth + 1);
+    }
+
+    void Search(int lo, int hi, int depth, const double* q, int& best, double& d2) const
+    {
+        if (hi <= lo) return;
+        const int axis = depth % 3, mid = (lo + hi) / 2;
+        const int id = m_index[mid];
+        const double* p = &m_points[id * 3];
+        const double dx = q[0] - p[0], dy = q[1] - p[1], dz = q[2] - p[2];
+        const double dist = dx*dx + dy*dy + dz*dz;
+        if (dist < d2) { d2 = dist; best = id; }
+
+        const double diff = q[axis] - p[axis];
+        if (diff < 0) {
+            Search(lo, mid, depth + 1, q, best, d2);
+            if (diff * diff < d2) Search(mid + 1, hi, depth + 1, q, best, d2);
+        } else {
+            Search(mid + 1, hi, depth + 1, q, best, d2);
+            if (diff * diff < d2) Search(lo, mid, depth + 1, q, best, d2);
+        }
+    }
+};
+
+// 对称 4x4 矩阵 Jacobi 特征分解，返回最大特征值对应的特征向量
+static void LargestEigenVector4(double a[4][4], double v[4])
+{
+    double e[4][4] = {{1,0,0,0},{0,1,0,0},{0,0,1,0},{0,0,0,1}};
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        double off = 0.0;
+        for (int p = 0; p < 4; ++p)
+            for (int q = p + 1; q < 4; ++q) off += a[p][q] * a[p][q];
+        if (off < 1e-24) break;
+        for (int p = 0; p < 4; ++p) {
+            for (int q = p + 1; q < 4; ++q) {
+                if (std::fabs(a[p][q]) < 1e-30) continue;
+                const double theta = 0.5 * (a[q][q] - a[p][p]) / a[p][q];
+                const double t = (theta >= 0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+                for (int k = 0; k < 4; ++k) {
+                    const double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 4; ++k) {
+                    const double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 4; ++k) {
+                    const double ekp = e[k][p], ekq = e[k][q];
+                    e[k][p] = c * ekp - s * ekq;
+                    e[k][q] = s * ekp + c * ekq;
+                }
+            }
+        }
+    }
+    int best = 0;
+    for (int k = 1; k < 4; ++k) if (a[k][k] > a[best][best]) best = k;
+    for (int k = 0; k < 4; ++k) v[k] = e[k][best];
+}
+
+// Horn 四元数法求刚体变换 R, t，使 sum |R*src + t - dst|^2 最小
+static void BestFitRigidTransform(const std::vector<double>& src, const std::vector<double>& dst,
+                                  double R[3][3], double t[3])
+{
+    const size_t n = src.size() / 3;
+    double cs[3] = {0, 0, 0}, cd[3] = {0, 0, 0};
+    for (size_t i = 0; i < n; ++i)
+        for (int k = 0; k < 3; ++k) { cs[k] += src[i*3+k]; cd[k] += dst[i*3+k]; }
+    for (int k = 0; k < 3; ++k) { cs[k] /= n; cd[k] /= n; }
+
+    double S[3][3] = {{0}};
+    for (size_t i = 0; i < n; ++i)
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                S[r][c] += (src[i*3+r] - cs[r]) * (dst[i*3+c] - cd[c]);
+
+    double N[4][4] = {
+        {S[0][0] + S[1][1] + S[2][2], S[1][2] - S[2][1], S[2][0] - S[0][2], S[0][1] - S[1][0]},
+        {S[1][2] - S[2][1], S[0][0] - S[1][1] - S[2][2], S[0][1] + S[1][0], S[2][0] + S[0][2]},
+        {S[2][0] - S[0][2], S[0][1] + S[1][0], -S[0][0] + S[1][1] - S[2][2], S[1][2] + S[2][1]},
+        {S[0][1] - S[1][0], S[2][0] + S[0][2], S[1][2] + S[2][1], -S[0][0] - S[1][1] + S[2][2]}};
+    double q[4];
+    LargestEigenVector4(N, q);
+    const double w = q[0], x = q[1], y = q[2], z = q[3];
+    R[0][0] = w*w + x*x - y*y - z*z; R[0][1] = 2*(x*y - w*z);         R[0][2] = 2*(x*z + w*y);
+    R[1][0] = 2*(x*y + w*z);         R[1][1] = w*w - x*x + y*y - z*z; R[1][2] = 2*(y*z - w*x);
+    R[2][0] = 2*(x*z - w*y);         R[2][1] = 2*(y*z + w*x);         R[2][2] = w*w - x*x - y*y + z*z;
+    for (int r = 0; r < 3; ++r) {
+        t[r] = cd[r] - (R[r][0] * cs[0] + R[r][1] * cs[1] + R[r][2] * cs[2]);
+    }
+}
+
+static inline void ApplyRigid(const double R[3][3], const double t[3], const double* p, double* out)
+{
+    for (int r = 0; r < 3; ++r) out[r] = R[r][0] * p[0] + R[r][1] * p[1] + R[r][2] * p[2] + t[r];
+}
+
+// 点到点 ICP：src 配准到 dst。节点编号一致时先用编号对应求初值，
+// 迭代中对下采样点并行查询最近点；R, t 返回累计变换
+static void RegisterPointsICP(const std::vector<double>& src, const PointKdTree& tree,
+                              const std::vector<double>* sameIndexTarget,
+                              double R[3][3], double t[3], int maxIterations = 30)
+{
+    const vtkIdType n = static_cast<vtkIdType>(src.size() / 3);
+    for (int r = 0; r < 3; ++r) { t[r] = 0.0; for (int c = 0; c < 3; ++c) R[r][c] = (r == c) ? 1.0 : 0.0; }
+    if (n == 0) return;
+
+    if (sameIndexTarget && sameIndexTarget->size() == src.size()) {
+        BestFitRigidTransform(src, *sameIndexTarget, R, t);
+    }
+
+    const vtkIdType stride = std::max<vtkIdType>(1, n / 50000);
+    const vtkIdType m = (n + stride - 1) / stride;
+    std::vector<double> moved(m * 3), matched(m * 3);
+    double lastRms = std::numeric_limits<double>::max();
+    for (int it = 0; it < maxIterations; ++it) {
+        std::vector<double> d2(m);
+        vtkSMPTools::For(0, m, [&](vtkIdType begin, vtkIdType end) {
+            for (vtkIdType j = begin; j < end; ++j) {
+                ApplyRigid(R, t, &src[j * stride * 3], &moved[j * 3]);
+                const int id = tree.Nearest(&moved[j * 3], d2[j]);
+                std::copy(tree.Point(id), tree.Point(id) + 3, &matched[j * 3]);
+            }
+        });
+        const double rms = std::sqrt(std::accumulate(d2.begin(), d2.end(), 0.0) / m);
+        if (std::fabs(lastRms - rms) < 1e-7 * (1.0 + rms)) break;
+        lastRms = rms;
+
+        // 增量变换叠加到累计变换上
+        double dR[3][3], dt[3];
+        BestFitRigidTransform(moved, matched, dR, dt);
+        double nR[3][3], nt[3];
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) nR[r][c] = dR[r][0] * R[0][c] + dR[r][1] * R[1][c] + dR[r][2] * R[2][c];
+            nt[r] = dR[r][0] * t[0] + dR[r][1] * t[1] + dR[r][2] * t[2] + dt[r];
+        }
+        std::copy(&nR[0][0], &nR[0][0] + 9, &R[0][0]);
+        std::copy(nt, nt + 3, t);
+    }
+}
+
+// 由截面形心曲线计算弯曲角和弯曲半径：角度为相邻切向夹角之和，
+// 半径为弯曲段（转角明显的站位）弧长与其转角之比
+static void MeasureBend(const TubeSectionLayout& layout, const TubeSectionStats& stats, double& angle, double& radius)
+{
+    const int ns = layout.numStations;
+    std::vector<double> dTheta(ns, 0.0), dLen(ns, 0.0);
+    double maxDTheta = 0.0;
+    for (int st = 0; st + 1 < ns; ++st) {
+        const double* ta = &stats.tangent[st * 3];
+        const double* tb = &stats.tangent[(st + 1) * 3];
+        dTheta[st] = std::acos(std::min(1.0, std::max(-1.0, Dot3(ta, tb))));
+        const double d[3] = {stats.centroid[(st+1)*3] - stats.centroid[st*3],
+                             stats.centroid[(st+1)*3+1] - stats.centroid[st*3+1],
+                             stats.centroid[(st+1)*3+2] - stats.centroid[st*3+2]};
+        dLen[st] = std::sqrt(Dot3(d, d));
+        maxDTheta = std::max(maxDTheta, dTheta[st]);
+    }
+    angle = 0.0;
+    double bendLen = 0.0, bendAngle = 0.0;
+    for (int st = 0; st + 1 < ns; ++st) {
+        angle += dTheta[st];
+        if (dTheta[st] > 0.2 * maxDTheta) {
+            bendLen += dLen[st];
+            bendAngle += dTheta[st];
+        }
+    }
+    radius = bendAngle > 1e-9 ? bendLen / bendAngle : 0.0;
+}
+
+// 帧中给定节点的变形坐标 = 坐标 + U
+static void DeformedPositions(const ResultFrame& frame, const std::vector<vtkIdType>& nodes, std::vector<double>& xyz)
+{
+    vtkPoints* points = frame.grid->GetPoints();
+    const ResultField* U = frame.Field("U");
+    const vtkIdType n = static_cast<vtkIdType>(nodes.size());
+    xyz.resize(n * 3);
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType j = begin; j < end; ++j) {
+            const vtkIdType i = nodes[j];
+            points->GetPoint(i, &xyz[j * 3]);
+            if (U && U->numComponents >= 3 && i < U->numTuples) {
+                for (int k = 0; k < 3; ++k) xyz[j*3+k] += U->Value(i, k);
+            }
+        }
+    });
+}
+
+// 由区域节点（管体）取出网格中属于该区域的单元；区域按连通性划分，单元的首节点即可判定
+static vtkSmartPointer<vtkUnstructuredGrid> ExtractNodeRegion(vtkUnstructuredGrid* grid, const std::vector<vtkIdType>& nodes)
+{
+    std::vector<uint8_t> inRegion(grid->GetNumberOfPoints(), 0);
+    for (vtkIdType i : nodes) inRegion[i] = 1;
+    vtkSmartPointer<vtkIdList> cells = vtkSmartPointer<vtkIdList>::New();
+    vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+    for (vtkIdType c = 0; c < grid->GetNumberOfCells(); ++c) {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        grid->GetCellPoints(c, npts, pts, ids);
+        if (npts > 0 && inRegion[pts[0]]) cells->InsertNextId(c);
+    }
+    vtkSmartPointer<vtkExtractCells> extract = vtkSmartPointer<vtkExtractCells>::New();
+    extract->SetInputData(grid);
+    extract->SetCellList(cells);
+    extract->Update();
+    return extract->GetOutput();
+}
+
+//回弹测量：最终（卸载）帧刚体配准到最后加载帧，报告弯曲角/半径变化并按偏差着色
+void MainWindow::onSpringbackClicked()
+{
+    if (!EnsureResultFramesLoaded()) return;
+    const int numFrames = static_cast<int>(m_resultFrames.size());
+    if (numFrames < 2) {
+        QMessageBox::warning(this, "警告", "回弹测量至少需要两个结果帧（加载帧和卸载帧）！");
+        return;
+    }
+    const int loadedIndex = (m_springbackLoadedFrame >= 0 && m_springbackLoadedFrame < numFrames - 1)
+                                ? m_springbackLoadedFrame : numFrames - 2;
+    if (!EnsureResultFrameLoaded(m_resultFrames[loadedIndex]) || !EnsureResultFrameLoaded(m_resultFrames.back())) {
+        QMessageBox::warning(this, "警告", "结果文件读取失败！");
+        return;
+    }
+    const ResultFrame& loaded = m_resultFrames[loadedIndex];
+    const ResultFrame& unloaded = m_resultFrames.back();
+
+    // 套筒和模具随管体一起运动，会主导配准和弯曲测量，只取管体区域的节点
+    TubeSectionLayout layout, loadedLayout;
+    if (!BuildTubeSectionLayout(unloaded.grid, 36, 200, layout)) {
+        QMessageBox::warning(this, "警告", "结果网格无法识别为管体，回弹测量失败！");
+        return;
+    }
+    const bool sameTopology = loaded.grid->GetNumberOfPoints() == unloaded.grid->GetNumberOfPoints() &&
+                              loaded.grid->GetNumberOfCells() == unloaded.grid->GetNumberOfCells();
+    if (!sameTopology && !BuildTubeSectionLayout(loaded.grid, 36, 200, loadedLayout)) {
+        QMessageBox::warning(this, "警告", "加载帧无法识别为管体，回弹测量失败！");
+        return;
+    }
+    const TubeSectionLayout& loadedTube = sameTopology ? layout : loadedLayout;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<double> loadedXYZ, unloadedXYZ;
+    DeformedPositions(loaded, loadedTube.tubeNodes, loadedXYZ);
+    DeformedPositions(unloaded, layout.tubeNodes, unloadedXYZ);
+
+    PointKdTree tree;
+    tree.Build(loadedXYZ);
+    double R[3][3], t[3];
+    RegisterPointsICP(unloadedXYZ, tree, sameTopology ? &loadedXYZ : nullptr, R, t);
+
+    // 管体节点的配准偏差，写回到整个网格的节点编号上
+    const vtkIdType n = unloaded.grid->GetNumberOfPoints();
+    const vtkIdType numTube = static_cast<vtkIdType>(layout.tubeNodes.size());
+    std::vector<double> registered(numTube * 3);
+    vtkSmartPointer<vtkFloatArray> deviation = vtkSmartPointer<vtkFloatArray>::New();
+    deviation->SetName("Springback");
+    deviation->SetNumberOfTuples(n);
+    deviation->FillValue(0.0f);
+    vtkSMPTools::For(0, numTube, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType j = begin; j < end; ++j) {
+            ApplyRigid(R, t, &unloadedXYZ[j * 3], &registered[j * 3]);
+            double d2;
+            tree.Nearest(&registered[j * 3], d2);
+            deviation->SetValue(layout.tubeNodes[j], static_cast<float>(std::sqrt(d2)));
+        }
+    });
+    const qint64 registrationMs = timer.elapsed();
+
+    double sumSq = 0.0, maxDev = 0.0;
+    for (vtkIdType i : layout.tubeNodes) {
+        const double d = deviation->GetValue(i);
+        sumSq += d * d;
+        maxDev = std::max(maxDev, d);
+    }
+
+    // 弯曲角和弯曲半径
+    SpringbackResult result;
+    TubeSectionStats loadedStats, unloadedStats;
+    ComputeTubeSectionStats(loadedTube, loaded.grid->GetPoints(), loaded.Field("U"), nullptr, loadedStats);
+    ComputeTubeSectionStats(layout, unloaded.grid->GetPoints(), unloaded.Field("U"), nullptr, unloadedStats);
+    MeasureBend(loadedTube, loadedStats, result.loadedAngle, result.loadedRadius);
+    MeasureBend(layout, unloadedStats, result.unloadedAngle, result.unloadedRadius);
+    result.rmsDeviation = numTube > 0 ? std::sqrt(sumSq / numTube) : 0.0;
+    result.maxDeviation = maxDev;
+    result.valid = true;
+    m_springback = result;
+
+    qDebug() << "回弹配准完成:" << numTube << "/" << n << "管体节点, 耗时" << registrationMs << "ms";
+
+    // 显示：卸载帧管体配准后按偏差着色，加载帧管体半透明
+    vtkSmartPointer<vtkPoints> registeredPoints = vtkSmartPointer<vtkPoints>::New();
+    registeredPoints->DeepCopy(unloaded.grid->GetPoints());
+    for (vtkIdType j = 0; j < numTube; ++j) registeredPoints->SetPoint(layout.tubeNodes[j], &registered[j * 3]);
+    vtkSmartPointer<vtkUnstructuredGrid> unloadedGrid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    unloadedGrid->CopyStructure(unloaded.grid);
+    unloadedGrid->SetPoints(registeredPoints);
+    unloadedGrid->GetPointData()->SetScalars(deviation);
+
+    vtkSmartPointer<vtkPoints> loadedPoints = vtkSmartPointer<vtkPoints>::New();
+    loadedPoints->DeepCopy(loaded.grid->GetPoints());
+    for (size_t j = 0; j < loadedTube.tubeNodes.size(); ++j) loadedPoints->SetPoint(loadedTube.tubeNodes[j], &loadedXYZ[j * 3]);
+    vtkSmartPointer<vtkUnstructuredGrid> loadedGrid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    loadedGrid->CopyStructure(loaded.grid);
+    loadedGrid->SetPoints(loadedPoints);
+
+    vtkSmartPointer<vtkLookupTable> lut = vtkSmartPointer<vtkLookupTable>::New();
+    lut->SetHueRange(0.666667, 0.0);
+    lut->Build();
+
+    vtkSmartPointer<vtkDataSetMapper> mapper = vtkSmartPointer<vtkDataSetMapper>::New();
+    mapper->SetInputData(ExtractNodeRegion(unloadedGrid, layout.tubeNodes));
+    mapper->SetLookupTable(lut);
+    mapper->SetScalarRange(0.0, maxDev > 0 ? maxDev : 1.0);
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper(mapper);
+
+    vtkSmartPointer<vtkDataSetMapper> loadedMapper = vtkSmartPointer<vtkDataSetMapper>::New();
+    loadedMapper->SetInputData(ExtractNodeRegion(loadedGrid, loadedTube.tubeNodes));
+    loadedMapper->ScalarVisibilityOff();
+    vtkSmartPointer<vtkActor> loadedActor = vtkSmartPointer<vtkActor>::New();
+    loadedActor->SetMapper(loadedMapper);
+    loadedActor->GetProperty()->SetColor(0.8, 0.8, 0.8);
+    loadedActor->GetProperty()->SetOpacity(0.25);
+
+    vtkSmartPointer<vtkScalarBarActor> bar = vtkSmartPointer<vtkScalarBarActor>::New();
+    bar->SetLookupTable(lut);
+    bar->SetTitle("Springback (mm)");
+    bar->SetNumberOfLabels(10);
+    bar->GetLabelTextProperty()->SetColor(0.0, 0.0, 0.0);
+    bar->GetTitleTextProperty()->SetColor(0.0, 0.0, 0.0);
+    bar->SetWidth(0.1);
+    bar->SetHeight(0.8);
+
+    SetSceneLayer("springback", {actor, loadedActor, bar});
+    ShowSceneLayers({"springback"});
+
+    const double rad2deg = 180.0 / M_PI;
+    QMessageBox::information(this, "回弹",
+        QString("加载帧: %1, 卸载帧: %2\n"
+                "弯曲角: %3° -> %4° (回弹 %5°)\n"
+                "弯曲半径: %6 -> %7 mm (变化 %8 mm)\n"
+                "配准偏差: RMS %9 mm, 最大 %10 mm")
+            .arg(loadedIndex + 1).arg(numFrames)
+            .arg(result.loadedAngle * rad2deg, 0, 'f', 3)
+            .arg(result.unloadedAngle * rad2deg, 0, 'f', 3)
+            .arg((result.loadedAngle - result.unloadedAngle) * rad2deg, 0, 'f', 3)
+            .arg(result.loadedRadius, 0, 'f', 3)
+            .arg(result.unloadedRadius, 0, 'f', 3)
+            .arg(result.unloadedRadius - result.loadedRadius, 0, 'f', 3)
+            .arg(result.rmsDeviation, 0, 'f', 4)
+            .arg(result.maxDeviation, 0, 'f', 4));
+}
+
+//选择作为“最后加载帧”的结果帧
+void MainWindow::onSpringbackOptionClicked()
+{
+    const int numFrames = static_cast<int>(std::max<size_t>(m_resultFrames.size(), vtkFilePaths.size()));
+    if (numFrames < 2) {
+        QMessageBox::warning(this, "警告", "回弹测量至少需要两个结果帧（加载帧和卸载帧）！");
+        return;
+    }
+    bool ok = false;
+    const int current = (m_springbackLoadedFrame >= 0) ? m_springbackLoadedFrame + 1 : numFrames - 1;
+    const int frame = QInputDialog::getInt(this, "回弹", "最后加载帧序号:", current, 1, numFrames - 1, 1, &ok);
+    if (ok) {
+        m_springbackLoadedFrame = frame - 1;
+    }
+}
+
+//----------回弹补偿----------|
+//按测得的回弹修正模具角度和弯曲半径：以回弹比（卸载结果/当前模具参数）预测成形结果，
+//回弹比在一次测量内是常数，满足目标的模具参数直接为 目标/回弹比。
+//回弹比随模具参数变化，松弛只作用在真实的“计算 -> 测量 -> 补偿”循环之间：
+//p += relaxation * (目标/回弹比 - p)。每次补偿只生成一次模具和 rigidbody.info
+void MainWindow::onCompensationClicked()
+{
+    if (m_elbowParameters.tube_length <= 0) {
+        QMessageBox::warning(this, "警告", "请先完成弯管建模！");
+        return;
+    }
+    if (!m_springback.valid) {
+        QMessageBox::warning(this, "警告", "请先使用当前模具的计算结果进行回弹测量！");
+        return;
+    }
+
+    ElbowParameters p = m_elbowParameters;
+    if (!m_compensationActive) {
+        // 第一次补偿时的模具参数即设计目标
+        m_compensationTargetAngle = p.arc_angle_rad;
+        m_compensationTargetRadius = p.arc_radius;
+        m_compensationCycle = 0;
+        m_compensationActive = true;
+    }
+
+    const double angleRatio = (m_springback.unloadedAngle > 0 && p.arc_angle_rad > 0)
+                                  ? m_springback.unloadedAngle / p.arc_angle_rad : 1.0;
+    const double radiusRatio = (m_springback.unloadedRadius > 0 && p.arc_radius > 0)
+                                   ? m_springback.unloadedRadius / p.arc_radius : 1.0;
+    const double fullAngle = m_compensationTargetAngle / angleRatio;
+    const double fullRadius = m_compensationTargetRadius / radiusRatio;
+    const double errAngle = m_compensationTargetAngle - m_springback.unloadedAngle;
+    const double errRadius = m_compensationTargetRadius - m_springback.unloadedRadius;
+    if (std::fabs(errAngle) < 1e-6 && std::fabs(errRadius) < 1e-4) {
+        QMessageBox::information(this, "补偿",
+            QString("第 %1 次补偿后已达到目标，无需修正").arg(m_compensationCycle));
+        return;
+    }
+
+    const double oldAngle = p.arc_angle_rad, oldRadius = p.arc_radius;
+    p.arc_angle_rad += m_compensationRelaxation * (fullAngle - p.arc_angle_rad);
+    p.arc_radius += m_compensationRelaxation * (fullRadius - p.arc_radius);
+    m_compensationCycle++;
+
+    // 写回参数并生成补偿后的模具（管体和套筒参数不变，命中缓存，只重建圆弧段）
+    QElapsedTimer timer;
+    timer.start();
+    ui->lineEdit_ArcAngle->setText(QString::number(p.arc_angle_rad, 'g', 10));
+    ui->lineEdit_ArcR->setText(QString::number(p.arc_radius, 'g', 10));
+    MakeElbowModel(
+        p.tube_outer_radius, p.tube_inner_radius, p.tube_length,
+        p.rotary_sleeve_thickness, p.rotary_sleeve_length, p.rotary_sleeve_pos,
+        p.fixed_sleeve_thickness, p.fixed_sleeve_length, p.fixed_sleeve_pos,
+        p.arc_radius, p.arc_thickness, p.arc_angle_rad
+        );
+
+    // 新模具需要新的计算结果和回弹测量才能继续补偿
+    m_springback.valid = false;
+
+    QMessageBox::information(this, "补偿",
+        QString("第 %1 次补偿\n回弹比: 角度 %2, 半径 %3\n目标: 角度 %4 rad, 半径 %5 mm\n"
+                "模具角度: %6 -> %7 rad\n模具半径: %8 -> %9 mm\n耗时 %10 ms")
+            .arg(m_compensationCycle)
+            .arg(angleRatio, 0, 'f', 5)
+            .arg(radiusRatio, 0, 'f', 5)
+            .arg(m_compensationTargetAngle, 0, 'f', 6)
+            .arg(m_compensationTargetRadius, 0, 'f', 4)
+            .arg(oldAngle, 0, 'f', 6)
+            .arg(p.arc_angle_rad, 0, 'f', 6)
+            .arg(oldRadius, 0, 'f', 4)
+            .arg(p.arc_radius, 0, 'f', 4)
+            .arg(timer.elapsed()));
+}
+
+//补偿设置：松弛因子、重置目标
+void MainWindow::onCompensationOptionClicked()
+{
+    bool ok = false;
+    double relaxation = QInputDialog::getDouble(this, "补偿", "松弛因子:", m_compensationRelaxation, 0.05, 2.0, 2, &ok);
+    if (!ok) return;
+    m_compensationRelaxation = relaxation;
+
+    if (m_compensationActive &&
+        QMessageBox::question(this, "补偿", "是否以当前模具参数重新设定补偿目标？") == QMessageBox::Yes) {
+        m_compensationActive = false;
+    }
+}
+
+//----------生成 inp 文件----------|
+#include <charconv>
+#include <cstdio>
+#include <vtkIdList.h>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QRegularExpression>
+
+// inp 文件中的一个部件：节点坐标 + 单元连接（局部 0 基编号）
+struct InpPart {
+    std::string name;             // ELSET 名称
+    std::string elementType;      // S3 / R3D3 / C3D8R ...
+    int nodesPerElement = 3;
+    std::vector<double> points;   // xyz
+    std::vector<vtkIdType> cells;   // nodesPerElement 个一组
+    int rigidBody = -1;           // m_rigidBodyRefs 中的刚体序号，-1 表示变形体
+    double shellThickness = 0.0;  // 变形壳单元（S3/S4...）的截面厚度
+};
+
+static inline void AppendInt(std::string& buf, vtkIdType v)
+{
+    char tmp[24];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    buf.append(tmp, res.ptr);
+}
+
+static inline void AppendDouble(std::string& buf, double v)
+{
+    char tmp[32];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    buf.append(tmp, res.ptr);
+}
+
+// 分块并行格式化、按顺序写出；同一时刻只持有一个窗口内各块的文本，不在内存中拼出整个文件
+template <typename Format>
+static bool WriteInpChunked(std::FILE* fp, vtkIdType count, Format format)
+{
+    const vtkIdType chunkSize = 65536;
+    const vtkIdType numChunks = (count + chunkSize - 1) / chunkSize;
+    const vtkIdType window = 2 * std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads());
+    std::vector<std::string> buffers(window);
+    for (vtkIdType first = 0; first < numChunks; first += window) {
+        const vtkIdType last = std::min(numChunks, first + window);
+        vtkSMPTools::For(first, last, 1, [&](vtkIdType begin, vtkIdType end) {
+            for (vtkIdType c = begin; c < end; ++c) {
+                std::string& buf = buffers[c - first];
+                buf.clear();
+                format(c * chunkSize, std::min(count, (c + 1) * chunkSize), buf);
+            }
+        });
+        for (vtkIdType c = first; c < last; ++c) {
+            const std::string& buf = buffers[c - first];
+            if (std::fwrite(buf.data(), 1, buf.size(), fp) != buf.size()) return false;
+        }
+    }
+    return true;
+}
+
+static bool WriteInpText(std::FILE* fp, const std::string& text)
+{
+    return std::fwrite(text.data(), 1, text.size(), fp) == text.size();
+}
+
+// 材料：密度、弹性和塑性硬化表
+static std::string InpMaterialText(const InpMaterial& material)
+{
+    std::string text = "*MATERIAL, NAME=" + material.name + "\n*DENSITY\n";
+    AppendDouble(text, material.density);
+    text += ",\n*ELASTIC\n";
+    AppendDouble(text, material.youngsModulus);
+    text += ", ";
+    AppendDouble(text, material.poissonRatio);
+    text += '\n';
+    if (!material.plastic.empty()) {
+        text += "*PLASTIC\n";
+        for (const auto& point : material.plastic) {
+            AppendDouble(text, point.first);
+            text += ", ";
+            AppendDouble(text, point.second);
+            text += '\n';
+        }
+    }
+    return text;
+}
+
+// 写出 Abaqus inp：节点、各部件单元及 ELSET/NSET、刚体参考点和 *RIGID BODY，
+// 变形体部件写材料和截面（实体单元 *SOLID SECTION，壳单元 *SHELL SECTION）
+static bool WriteAbaqusInp(const QString& fileName, const std::vector<InpPart>& parts,
+                           const std::vector<RigidBodyRef>& refs, const InpMaterial& material,
+                           vtkIdType& numNodes, vtkIdType& numElements)
+{
+    std::FILE* fp = std::fopen(QFile::encodeName(fileName).constData(), "wb");
+    if (!fp) return false;
+    std::vector<char> ioBuffer(8 << 20);
+    std::setvbuf(fp, ioBuffer.data(), _IOFBF, ioBuffer.size());
+
+    bool ok = WriteInpText(fp, "*HEADING\nTube elbow model\n** Generated by Tube\n");
+
+    // 1. 节点：各部件顺序编号
+    std::vector<vtkIdType> nodeOffset(parts.size() + 1, 0);
+    for (size_t i = 0; i < parts.size(); ++i) {
+        nodeOffset[i + 1] = nodeOffset[i] + static_cast<vtkIdType>(parts[i].points.size() / 3);
+    }
+    ok = ok && WriteInpText(fp, "*NODE\n");
+    for (size_t i = 0; i < parts.size() && ok; ++i) {
+        const InpPart& part = parts[i];
+        const vtkIdType base = nodeOffset[i];
+        ok = WriteInpChunked(fp, static_cast<vtkIdType>(part.points.size() / 3),
+                             [&](vtkIdType begin, vtkIdType end, std::string& buf) {
+            buf.reserve((end - begin) * 64);
+            for (vtkIdType n = begin; n < end; ++n) {
+                AppendInt(buf, base + n + 1);
+                for (int k = 0; k < 3; ++k) {
+                    buf += ", ";
+                    AppendDouble(buf, part.points[n * 3 + k]);
+                }
+                buf += '\n';
+            }
+        });
+    }
+
+    // 2. 刚体参考点（参考点和转动中心各一个节点）
+    vtkIdType nextNode = nodeOffset.back() + 1;
+    std::string refText;
+    std::vector<vtkIdType> refNode(refs.size());
+    for (size_t r = 0; r < refs.size(); ++r) {
+        refNode[r] = nextNode;
+        for (const double* p : {refs[r].ref, refs[r].rot}) {
+            AppendInt(refText, nextNode++);
+            for (int k = 0; k < 3; ++k) {
+                refText += ", ";
+                AppendDouble(refText, p[k]);
+            }
+            refText += '\n';
+        }
+    }
+    ok = ok && WriteInpText(fp, refText);
+
+    // 3. 单元
+    vtkIdType elementId = 1;
+    for (size_t i = 0; i < parts.size() && ok; ++i) {
+        const InpPart& part = parts[i];
+        const int npe = part.nodesPerElement;
+        const vtkIdType base = nodeOffset[i] + 1;
+        const vtkIdType firstId = elementId;
+        const vtkIdType count = static_cast<vtkIdType>(part.cells.size() / npe);
+        ok = WriteInpText(fp, "*ELEMENT, TYPE=" + part.elementType + ", ELSET=" + part.name + "\n");
+        ok = ok && WriteInpChunked(fp, count, [&](vtkIdType begin, vtkIdType end, std::string& buf) {
+            buf.reserve((end - begin) * (8 + npe * 10));
+            for (vtkIdType e = begin; e < end; ++e) {
+                AppendInt(buf, firstId + e);
+                for (int k = 0; k < npe; ++k) {
+                    buf += ", ";
+                    AppendInt(buf, base + part.cells[e * npe + k]);
+                }
+                buf += '\n';
+            }
+        });
+        elementId += count;
+    }
+
+    // 4. 节点集、参考点集和刚体定义
+    std::string sets;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (nodeOffset[i + 1] == nodeOffset[i]) continue;
+        sets += "*NSET, NSET=" + parts[i].name + "_NODES, GENERATE\n";
+        AppendInt(sets, nodeOffset[i] + 1);
+        sets += ", ";
+        AppendInt(sets, nodeOffset[i + 1]);
+        sets += ", 1\n";
+    }
+    for (size_t r = 0; r < refs.size(); ++r) {
+        sets += "*NSET, NSET=" + refs[r].name + "_REF\n";
+        AppendInt(sets, refNode[r]);
+        sets += "\n*NSET, NSET=" + refs[r].name + "_ROT\n";
+        AppendInt(sets, refNode[r] + 1);
+        sets += '\n';
+    }
+    for (const InpPart& part : parts) {
+        if (part.rigidBody < 0 || part.rigidBody >= static_cast<int>(refs.size())) continue;
+        sets += "*RIGID BODY, REF NODE=" + refs[part.rigidBody].name + "_REF, ELSET=" + part.name + "\n";
+    }
+
+    // 5. 变形体的截面和材料
+    bool hasDeformable = false;
+    for (const InpPart& part : parts) {
+        if (part.rigidBody >= 0 && part.rigidBody < static_cast<int>(refs.size())) continue;
+        hasDeformable = true;
+        if (!part.elementType.empty() && part.elementType[0] == 'S') {
+            sets += "*SHELL SECTION, ELSET=" + part.name + ", MATERIAL=" + material.name + "\n";
+            AppendDouble(sets, part.shellThickness);
+            sets += ", 5\n";
+        } else {
+            sets += "*SOLID SECTION, ELSET=" + part.name + ", MATERIAL=" + material.name + "\n,\n";
+        }
+    }
+    if (hasDeformable) sets += InpMaterialText(material);
+    ok = ok && WriteInpText(fp, sets);
+
+    numNodes = nextNode - 1;
+    numElements = elementId - 1;
+    ok = (std::fclose(fp) == 0) && ok;
+    return ok;
+}
+
+// 三角化部件转为 inp 部件
+static void PolyDataToInpPart(vtkPolyData* polyData, InpPart& part)
+{
+    if (!polyData) return;
+    const vtkIdType n = polyData->GetNumberOfPoints();
+    part.points.resize(n * 3);
+    for (vtkIdType i = 0; i < n; ++i) {
+        polyData->GetPoint(i, &part.points[i * 3]);
+    }
+
+    vtkCellArray* polys = polyData->GetPolys();
+    part.cells.reserve(polys->GetNumberOfCells() * part.nodesPerElement);
+    vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+    for (vtkIdType c = 0; c < polys->GetNumberOfCells(); ++c) {
+        polys->GetCellAtId(c, ids);
+        if (ids->GetNumberOfIds() != part.nodesPerElement) continue;
+        for (vtkIdType k = 0; k < ids->GetNumberOfIds(); ++k) {
+            part.cells.push_back(ids->GetId(k));
+        }
+    }
+}
+
+//生成 inp 文件：管体为六面体扫掠网格，三个套筒取自当前弯管模型的三角化结果
+void MainWindow::onGenerateInpClicked()
+{
+    if (m_elbowParameters.tube_length <= 0) {
+        QMessageBox::warning(this, "警告", "请先完成弯管建模！");
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this, tr("保存 inp 文件"), "", tr("Abaqus 输入文件 (*.inp)"));
+    if (fileName.isEmpty()) {
+        return;
+    }
+    if (!fileName.endsWith(".inp", Qt::CaseInsensitive)) {
+        fileName += ".inp";
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<InpPart> parts;
+    try {
+        // 参数未变时全部命中部件缓存
+        std::vector<const ElbowComponent*> components = BuildElbowComponents(m_elbowParameters);
+        const char* names[4] = {"TUBE", "ROTARY_SLEEVE", "FIXED_SLEEVE", "ARC_SLEEVE"};
+        const int rigidBody[4] = {-1, 1, 2, 0}; // 对应 rigidbody.info 中的 Volume3/Volume4/Volume2
+        for (size_t i = 0; i < components.size() && i < 4; ++i) {
+            InpPart part;
+            part.name = names[i];
+            part.rigidBody = rigidBody[i];
+            if (rigidBody[i] < 0) {
+                // 管体：沿轴线扫掠的六面体实体网格
+                TubeSweepSegment segment;
+                segment.end[0] = m_elbowParameters.tube_length;
+                segment.rOut = m_elbowParameters.tube_outer_radius;
+                segment.rIn = m_elbowParameters.tube_inner_radius;
+                const double size = HexAxialElementSize(m_hexElementSize, segment.rOut, m_hexCircumferential);
+                TubeHexMesh mesh;
+                SweepTubeHexMesh({segment}, m_hexThicknessLayers, m_hexCircumferential, size, mesh);
+                part.elementType = "C3D8R";
+                part.nodesPerElement = 8;
+                part.points = std::move(mesh.points);
+                part.cells = std::move(mesh.cells);
+            } else {
+                part.elementType = "R3D3";
+                part.nodesPerElement = 3;
+                PolyDataToInpPart(components[i]->polyData, part);
+            }
+            parts.push_back(std::move(part));
+        }
+    } catch (const std::exception& e) {
+        QMessageBox::critical(this, "错误", QString("生成网格失败: %1").arg(e.what()));
+        return;
+    }
+
+    vtkIdType numNodes = 0, numElements = 0;
+    if (!WriteAbaqusInp(fileName, parts, m_rigidBodyRefs, m_tubeMaterial, numNodes, numElements)) {
+        QMessageBox::critical(this, "错误", "写入 inp 文件失败！");
+        return;
+    }
+
+    qDebug() << "inp 文件写入完成:" << fileName << numNodes << "节点," << numElements << "单元, 耗时" << timer.elapsed() << "ms";
+    QMessageBox::information(this, "成功", QString("inp 文件已保存为: %1\n节点 %2 个, 单元 %3 个")
+                                               .arg(fileName).arg(numNodes).arg(numElements));
+}
+
+//材料：管体材料的弹性参数和塑性硬化表，生成 inp 时写入 *MATERIAL
+void MainWindow::onAddMaterialClicked()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("管体材料");
+    QFormLayout* form = new QFormLayout(&dialog);
+    QLineEdit* nameEdit = new QLineEdit(QString::fromStdString(m_tubeMaterial.name), &dialog);
+    QLineEdit* densityEdit = new QLineEdit(QString::number(m_tubeMaterial.density, 'g', 10), &dialog);
+    QLineEdit* modulusEdit = new QLineEdit(QString::number(m_tubeMaterial.youngsModulus, 'g', 10), &dialog);
+    QLineEdit* poissonEdit = new QLineEdit(QString::number(m_tubeMaterial.poissonRatio, 'g', 10), &dialog);
+    QPlainTextEdit* plasticEdit = new QPlainTextEdit(&dialog);
+    QStringList plasticLines;
+    for (const auto& point : m_tubeMaterial.plastic) {
+        plasticLines << QString("%1, %2").arg(point.first, 0, 'g', 10).arg(point.second, 0, 'g', 10);
+    }
+    plasticEdit->setPlainText(plasticLines.join("\n"));
+    plasticEdit->setToolTip("每行: 屈服应力 (MPa), 塑性应变；第一行塑性应变为 0");
+    form->addRow("名称:", nameEdit);
+    form->addRow("密度 (t/mm³):", densityEdit);
+    form->addRow("弹性模量 (MPa):", modulusEdit);
+    form->addRow("泊松比:", poissonEdit);
+    form->addRow("塑性硬化:", plasticEdit);
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    InpMaterial material;
+    bool ok[3];
+    material.name = nameEdit->text().trimmed().toUpper().replace(' ', '_').toStdString();
+    material.density = densityEdit->text().toDouble(&ok[0]);
+    material.youngsModulus = modulusEdit->text().toDouble(&ok[1]);
+    material.poissonRatio = poissonEdit->text().toDouble(&ok[2]);
+    material.plastic.clear();
+    static const QRegularExpression separators("[\\s,;]+");
+    for (const QString& line : plasticEdit->toPlainText().split('\n', Qt::SkipEmptyParts)) {
+        const QStringList tokens = line.trimmed().split(separators, Qt::SkipEmptyParts);
+        bool okStress = false, okStrain = false;
+        const double stress = tokens.size() == 2 ? tokens[0].toDouble(&okStress) : 0.0;
+        const double strain = tokens.size() == 2 ? tokens[1].toDouble(&okStrain) : 0.0;
+        if (!okStress || !okStrain) {
+            QMessageBox::warning(this, "警告", QString("塑性硬化表格式错误: %1").arg(line));
+            return;
+        }
+        material.plastic.emplace_back(stress, strain);
+    }
+    if (material.name.empty() || !ok[0] || !ok[1] || !ok[2] || material.density <= 0 || material.youngsModulus <= 0 ||
+        material.poissonRatio <= -1.0 || material.poissonRatio >= 0.5) {
+        QMessageBox::warning(this, "警告", "材料参数无效！");
+        return;
+    }
+    if (!material.plastic.empty() && material.plastic.front().second != 0.0) {
+        QMessageBox::warning(this, "警告", "塑性硬化表第一行的塑性应变必须为 0！");
+        return;
+    }
+    m_tubeMaterial = std::move(material);
+}
+
+//----------提交计算（本地作业队列）----------|
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QRegularExpression>
+#include <QThread>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+// 结果帧文件名 Job.NN.vtk 中的帧号，不匹配时返回 -1
+static int JobFrameNumber(const QString& fileName)
+{
+    static const QRegularExpression re("^Job\\.(\\d+)\\.vtk$", QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch m = re.match(fileName);
+    return m.hasMatch() ? m.captured(1).toInt() : -1;
+}
+
+SolverJob* MainWindow::FindSolverJob(int id)
+{
+    for (auto& job : m_solverJobs) {
+        if (job.id == id) return &job;
+    }
+    return nullptr;
+}
+
+//提交计算：命令行中 {job} {dir} {results} {init_step} {all_step} {min_step} {max_step} 会被替换
+void MainWindow::onSubmitJobClicked()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("提交计算");
+    QFormLayout* form = new QFormLayout(&dialog);
+    QLineEdit* commandEdit = new QLineEdit(m_solverCommand, &dialog);
+    commandEdit->setMinimumWidth(420);
+    commandEdit->setToolTip("可用占位符: {job} {dir} {results} {init_step} {all_step} {min_step} {max_step}");
+    QSpinBox* prioritySpin = new QSpinBox(&dialog);
+    prioritySpin->setRange(0, 100);
+    prioritySpin->setValue(m_lastJobPriority);
+    QSpinBox* concurrencySpin = new QSpinBox(&dialog);
+    concurrencySpin->setRange(1, std::max(1, QThread::idealThreadCount()));
+    concurrencySpin->setValue(m_maxConcurrentJobs);
+    form->addRow("求解器命令:", commandEdit);
+    form->addRow("优先级:", prioritySpin);
+    form->addRow("最大并行作业数:", concurrencySpin);
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    m_solverCommand = commandEdit->text().trimmed();
+    m_lastJobPriority = prioritySpin->value();
+    m_maxConcurrentJobs = concurrencySpin->value();
+    if (m_solverCommand.isEmpty()) {
+        QMessageBox::warning(this, "警告", "求解器命令不能为空！");
+        return;
+    }
+
+    SolverJob job;
+    job.id = m_nextJobId++;
+    job.priority = m_lastJobPriority;
+    job.name = QString("Job-%1").arg(job.id);
+    job.workDir = QDir::currentPath() + "/jobs/" + job.name;
+    job.resultsDir = job.workDir + "/results";
+    job.logPath = job.workDir + "/" + job.name + ".log";
+    if (!QDir().mkpath(job.resultsDir)) {
+        QMessageBox::warning(this, "警告", QString("无法创建作业目录: %1").arg(job.resultsDir));
+        return;
+    }
+
+    QString command = m_solverCommand;
+    command.replace("{job}", job.name)
+        .replace("{dir}", job.workDir)
+        .replace("{results}", job.resultsDir)
+        .replace("{init_step}", ui->init_step->text())
+        .replace("{all_step}", ui->all_step->text())
+        .replace("{min_step}", ui->min_step->text())
+        .replace("{max_step}", ui->max_step->text());
+    QStringList tokens = QProcess::splitCommand(command);
+    if (tokens.isEmpty()) {
+        QMessageBox::warning(this, "警告", "无法解析求解器命令！");
+        return;
+    }
+    job.program = tokens.takeFirst();
+    job.arguments = tokens;
+
+    m_solverJobs.push_back(job);
+    qDebug() << "提交作业" << job.name << "优先级" << job.priority << ":" << command;
+    StartQueuedJobs();
+    ReportSolverJobs();
+}
+
+//按优先级（同级先提交先运行）启动排队作业，直到达到并行上限
+void MainWindow::StartQueuedJobs()
+{
+    int running = 0;
+    for (const auto& job : m_solverJobs) {
+        if (job.state == SolverJob::Running) running++;
+    }
+
+    while (running < m_maxConcurrentJobs) {
+        SolverJob* next = nullptr;
+        for (auto& job : m_solverJobs) {
+            if (job.state != SolverJob::Queued) continue;
+            if (!next || job.priority > next->priority) next = &job;
+        }
+        if (!next) break;
+
+        const int id = next->id;
+        QProcess* process = new QProcess(this);
+        process->setWorkingDirectory(next->workDir);
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        process->setStandardOutputFile(next->logPath);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+                [this, id](int exitCode, QProcess::ExitStatus status) {
+            onSolverJobFinished(id, status == QProcess::NormalExit && exitCode == 0);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, id](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) onSolverJobFinished(id, false);
+        });
+
+        next->process = process;
+        next->state = SolverJob::Running;
+        running++;
+
+        m_jobWatcher->addPath(next->resultsDir);
+        if (!m_jobPollTimer->isActive()) m_jobPollTimer->start();
+
+        qDebug() << "启动作业" << next->name << ":" << next->program << next->arguments;
+        process->start(next->program, next->arguments);
+
+        // 还没有查看任何作业时查看第一个启动的作业；之后只在作业队列中切换，其他作业的帧由各自收取
+        if (m_viewedJobId < 0) ViewSolverJob(id);
+    }
+}
+
+//结果视图改为查看指定作业：索引其结果目录，读入已收取的帧，之后该作业写完的帧增量加入
+void MainWindow::ViewSolverJob(int id)
+{
+    SolverJob* job = FindSolverJob(id);
+    if (!job) return;
+    m_viewedJobId = id;
+    m_resultFrames.clear();
+    SetResultIndexDir(job->resultsDir);
+    if (m_sceneLayers.count("results")) {
+        SetSceneLayer("results", {});
+        m_resultScalarBar = nullptr;
+        m_resultLut = nullptr;
+        m_viewWindow->Render();
+    }
+
+    QStringList frames = job->ingestedFrames.values();
+    std::sort(frames.begin(), frames.end(), [](const QString& a, const QString& b) {
+        return JobFrameNumber(QFileInfo(a).fileName()) < JobFrameNumber(QFileInfo(b).fileName());
+    });
+    for (const QString& path : frames) {
+        IngestResultFrame(path);
+    }
+    qDebug() << "结果视图查看作业" << job->name << "，已收取" << frames.size() << "帧";
+    RefreshJobPanel();
+}
+
+//作业队列面板：列出各作业的状态和已收取的帧数，选择一个作业查看其结果
+void MainWindow::onJobPanelClicked()
+{
+    if (!m_jobPanel) {
+        m_jobPanel = new QDialog(this);
+        m_jobPanel->setWindowTitle("作业队列");
+        m_jobPanel->setAttribute(Qt::WA_DeleteOnClose);
+        QVBoxLayout* layout = new QVBoxLayout(m_jobPanel);
+
+        m_jobTable = new QTableWidget(0, 4, m_jobPanel);
+        m_jobTable->setHorizontalHeaderLabels({"作业", "状态", "优先级", "已收取帧"});
+        m_jobTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        m_jobTable->verticalHeader()->setVisible(false);
+        m_jobTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        m_jobTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+        m_jobTable->setSelectionMode(QAbstractItemView::SingleSelection);
+        m_jobTable->setMinimumSize(460, 220);
+        layout->addWidget(m_jobTable);
+
+        QPushButton* viewButton = new QPushButton("查看结果", m_jobPanel);
+        layout->addWidget(viewButton);
+        auto viewSelected = [this]() {
+            const int row = m_jobTable->currentRow();
+            if (row < 0) return;
+            ViewSolverJob(m_jobTable->item(row, 0)->data(Qt::UserRole).toInt());
+        };
+        connect(viewButton, &QPushButton::clicked, this, viewSelected);
+        connect(m_jobTable, &QTableWidget::cellDoubleClicked, this, viewSelected);
+    }
+    RefreshJobPanel();
+    m_jobPanel->show();
+    m_jobPanel->raise();
+}
+
+void MainWindow::RefreshJobPanel()
+{
+    if (!m_jobPanel) return;
+    static const char* const stateNames[] = {"排队", "运行", "完成", "失败"};
+    const int selected = m_jobTable->currentRow();
+    m_jobTable->setRowCount(static_cast<int>(m_solverJobs.size()));
+    for (int row = 0; row < static_cast<int>(m_solverJobs.size()); ++row) {
+        const SolverJob& job = m_solverJobs[row];
+        QTableWidgetItem* nameItem = new QTableWidgetItem(job.id == m_viewedJobId ? job.name + "（查看中）" : job.name);
+        nameItem->setData(Qt::UserRole, job.id);
+        m_jobTable->setItem(row, 0, nameItem);
+        m_jobTable->setItem(row, 1, new QTableWidgetItem(stateNames[job.state]));
+        m_jobTable->setItem(row, 2, new QTableWidgetItem(QString::number(job.priority)));
+        m_jobTable->setItem(row, 3, new QTableWidgetItem(QString::number(job.ingestedFrames.size())));
+    }
+    if (selected >= 0 && selected < m_jobTable->rowCount()) m_jobTable->selectRow(selected);
+}
+
+void MainWindow::onSolverJobFinished(int id, bool success)
+{
+    SolverJob* job = FindSolverJob(id);
+    if (!job || job->state != SolverJob::Running) return;
+
+    // 进程已退出，剩余的帧不会再变化，全部收取
+    job->state = success ? SolverJob::Finished : SolverJob::Failed;
+    PollSolverJob(*job, true);
+    m_jobWatcher->removePath(job->resultsDir);
+    job->process->deleteLater();
+    job->process = nullptr;
+
+    qDebug() << "作业" << job->name << (success ? "完成" : "失败") << "，日志:" << job->logPath;
+    if (!success) {
+        QMessageBox::warning(this, "提交计算", QString("作业 %1 运行失败，请查看日志:\n%2").arg(job->name, job->logPath));
+    }
+
+    StartQueuedJobs();
+    bool anyRunning = false;
+    for (const auto& j : m_solverJobs) {
+        if (j.state == SolverJob::Running) anyRunning = true;
+    }
+    if (!anyRunning) m_jobPollTimer->stop();
+    ReportSolverJobs();
+}
+
+//结果目录变化或定时检查：大小在两次检查之间不再变化的帧视为写完
+void MainWindow::PollSolverJobs()
+{
+    for (auto& job : m_solverJobs) {
+        if (job.state == SolverJob::Running) PollSolverJob(job, false);
+    }
+}
+
+void MainWindow::PollSolverJob(SolverJob& job, bool finished)
+{
+    QDir dir(job.resultsDir);
+    QFileInfoList infos = dir.entryInfoList(QStringList() << "Job.*.vtk", QDir::Files | QDir::NoDotAndDotDot);
+    std::sort(infos.begin(), infos.end(), [](const QFileInfo& a, const QFileInfo& b) {
+        return JobFrameNumber(a.fileName()) < JobFrameNumber(b.fileName());
+    });
+
+    for (const QFileInfo& info : infos) {
+        const QString path = info.absoluteFilePath();
+        if (JobFrameNumber(info.fileName()) < 0 || job.ingestedFrames.contains(path)) continue;
+
+        const qint64 size = info.size();
+        const bool stable = job.pendingFrames.contains(path) && job.pendingFrames.value(path) == size;
+        if (!finished && (size == 0 || !stable)) {
+            job.pendingFrames.insert(path, size);
+            continue;
+        }
+        // 查看中的作业直接读入结果视图，其他作业只记下，切换查看时再读入
+        if (job.id == m_viewedJobId && !IngestResultFrame(path) && !finished) {
+            continue; // 仍在写入（读取失败），下次再试
+        }
+        job.pendingFrames.remove(path);
+        job.ingestedFrames.insert(path);
+    }
+}
+
+//增量加入一帧结果：已打开结果视图时直接添加 Actor 并刷新
+bool MainWindow::IngestResultFrame(const QString& path)
+{
+    // 结果索引可能已经读取过这一帧
+    const QFileInfo info(path);
+    const int existing = FindResultFrame(path);
+    if (existing >= 0 && m_resultFrames[existing].fileSize == info.size() &&
+        m_resultFrames[existing].fileTime == info.lastModified().toMSecsSinceEpoch()) {
+        return true;
+    }
+
+    ResultFrame frame;
+    if (!m_resultReader.LoadResultFrame(path, frame)) {
+        return false;
+    }
+    TouchMemory(kMemResultFrames, path);
+    if (existing >= 0) {
+        m_resultFrames.erase(m_resultFrames.begin() + existing);
+    }
+    m_resultFrames.push_back(std::move(frame));
+    if (!vtkFilePaths.contains(path)) {
+        vtkFilePaths.append(path);
+    }
+
+    // 同步结果索引，避免目录扫描时再次读取
+    ResultIndexEntry entry;
+    entry.path = path;
+    entry.size = m_resultFrames.back().fileSize;
+    entry.mtime = m_resultFrames.back().fileTime;
+    auto it = std::find_if(m_resultIndex.begin(), m_resultIndex.end(),
+                           [&](const ResultIndexEntry& e) { return e.path == path; });
+    if (it != m_resultIndex.end()) {
+        *it = entry;
+    } else {
+        m_resultIndex.push_back(entry);
+    }
+
+    if (existing >= 0) {
+        RebuildResultActors();
+    } else if (m_sceneLayers.count("results")) {
+        if (AddResultFrameActor(m_resultFrames.back())) {
+            if (m_resultFrames.size() == 1 && m_visibleLayers.contains("results")) m_viewRenderer->ResetCamera();
+            m_viewWindow->Render();
+        }
+    }
+    ReportResultMemory();
+    qDebug() << "载入新结果帧:" << path;
+    return true;
+}
+
+void MainWindow::ReportSolverJobs()
+{
+    int queued = 0, running = 0, done = 0, failed = 0;
+    for (const auto& job : m_solverJobs) {
+        switch (job.state) {
+        case SolverJob::Queued: queued++; break;
+        case SolverJob::Running: running++; break;
+        case SolverJob::Finished: done++; break;
+        case SolverJob::Failed: failed++; break;
+        }
+    }
+    statusBar()->showMessage(QString("作业: 运行 %1, 排队 %2, 完成 %3, 失败 %4").arg(running).arg(queued).arg(done).arg(failed));
+    RefreshJobPanel();
+}
+
+//----------自检（--self-test）----------|
+//几何算法的自检：用程序构造的简单形状运行，不依赖界面和模型文件
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepBuilderAPI_MakeWire.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepPrimAPI_MakeTorus.hxx>
+#include <TColStd_Array1OfInteger.hxx>
+#include <TColStd_Array1OfReal.hxx>
+#include <gp_Circ.hxx>
+
+//检查平面网格：三角形不退化、朝向一致，总面积等于 area，且 points 都是网格节点
+static QString CheckPlanarMesh(const Handle(Poly_Triangulation)& tri, double area, const std::vector<gp_Pnt>& points)
+{
+    int positive = 0, negative = 0;
+    double sum = 0;
+    for (Standard_Integer i = 1; i <= tri->NbTriangles(); i++) {
+        Standard_Integer n1, n2, n3;
+        tri->Triangle(i).Get(n1, n2, n3);
+        const gp_Vec normal = gp_Vec(tri->Node(n1), tri->Node(n2)).Crossed(gp_Vec(tri->Node(n1), tri->Node(n3)));
+        if (std::abs(normal.Z()) < 1e-12) return QString("第 %1 个三角形退化").arg(i);
+        (normal.Z() > 0 ? positive : negative)++;
+        sum += std::abs(normal.Z()) / 2;
+    }
+    if (positive > 0 && negative > 0) return QString("%1 个三角形翻转").arg(std::min(positive, negative));
+    if (std::abs(sum - area) > 1e-6 * area) return QString("网格面积 %1，应为 %2").arg(sum).arg(area);
+    for (const gp_Pnt& p : points) {
+        bool found = false;
+        for (Standard_Integer i = 1; i <= tri->NbNodes() && !found; i++) found = tri->Node(i).SquareDistance(p) < 1e-14;
+        if (!found) return QString("等分点 (%1, %2) 不是网格节点").arg(p.X()).arg(p.Y());
+    }
+    return QString();
+}
+
+//圆盘边界的节点链逆着边的参数方向（反向的 PolygonOnTriangulation）：
+//重划分后等分点都应成为边界节点，三角形不翻转，面积等于等分点围成的多边形
+static QString CheckRemeshReversedBoundary()
+{
+    const double size = 1.0;
+    const TopoDS_Edge circle = BRepBuilderAPI_MakeEdge(gp_Circ(gp_Ax2(gp_Pnt(0, 0, 0), gp_Dir(0, 0, 1)), 5.0)).Edge();
+    const TopoDS_Face face = BRepBuilderAPI_MakeFace(BRepBuilderAPI_MakeWire(circle).Wire()).Face();
+    BRepMesh_IncrementalMesh mesher(face, size * kRemeshSeedDeflectionRatio, Standard_False, 0.5, Standard_False);
+    TopLoc_Location loc;
+    Handle(Poly_Triangulation) tri = BRep_Tool::Triangulation(face, loc);
+    if (tri.IsNull()) return "初始三角化失败";
+
+    TopTools_IndexedMapOfShape edgeMap;
+    TopExp::MapShapes(face, TopAbs_EDGE, edgeMap);
+    const TopoDS_Edge edge = TopoDS::Edge(edgeMap(1));
+    Handle(Poly_PolygonOnTriangulation) polygon = BRep_Tool::PolygonOnTriangulation(edge, tri, loc);
+    if (polygon.IsNull() || !polygon->HasParameters() || polygon->NbNodes() < 4) return "初始三角化缺少边界节点链";
+    const int n = polygon->NbNodes();
+    TColStd_Array1OfInteger nodes(1, n);
+    TColStd_Array1OfReal params(1, n);
+    for (int i = 1; i <= n; i++) {
+        nodes(i) = polygon->Node(n + 1 - i);
+        params(i) = polygon->Parameter(n + 1 - i);
+    }
+    BRep_Builder().UpdateEdge(edge, new Poly_PolygonOnTriangulation(nodes, params), tri, loc);
+
+    std::vector<EdgeSamples> samples(edgeMap.Extent());
+    SampleEdgeUniform(edge, size, samples[0]);
+    double area = 0;
+    for (size_t k = 0; k + 1 < samples[0].points.size(); k++) {
+        const gp_Pnt& a = samples[0].points[k];
+        const gp_Pnt& b = samples[0].points[k + 1];
+        area += (a.X() * b.Y() - b.X() * a.Y()) / 2;
+    }
+    area = std::abs(area);
+
+    FaceRemesher remesher(face, size);
+    if (!remesher.Load(tri, loc, edgeMap, samples)) return "载入初始三角化失败";
+    QString error = CheckPlanarMesh(remesher.Result(loc), area, samples[0].points);
+    if (!error.isEmpty()) return "替换边界节点后" + error;
+    remesher.Remesh(kRemeshIterations);
+    error = CheckPlanarMesh(remesher.Result(loc), area, samples[0].points);
+    if (!error.isEmpty()) return "重划分后" + error;
+    return QString();
+}
+
+//把形状中的圆柱面和环面加入复合体（提取的外壁只含这两类面）
+static void AddTubeFaces(const TopoDS_Shape& shape, BRep_Builder& builder, TopoDS_Compound& compound)
+{
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        const GeomAbs_SurfaceType type = BRepAdaptor_Surface(TopoDS::Face(exp.Current())).GetType();
+        if (type == GeomAbs_Cylinder || type == GeomAbs_Torus) builder.Add(compound, exp.Current());
+    }
+}
+
+//直管-弯管-直管的外壁，进口直管剖分为两个同轴圆柱面：中心线应为两段直线和一段 90° 圆弧，
+//长度为两段直管加弯管弧长，与按理论中心线加密的弯曲线之间偏差为零
+static QString CheckCenterlineStraightBendStraight()
+{
+    const double radius = 10.0, bendRadius = 50.0, straight = 100.0;
+    BRep_Builder builder;
+    TopoDS_Compound outer;
+    builder.MakeCompound(outer);
+    // 弯管：圆心在原点，绕 Z 轴由 (R, 0, 0) 转到 (0, R, 0)
+    const gp_Ax2 bendAxes(gp_Pnt(0, 0, 0), gp_Dir(0, 0, 1), gp_Dir(1, 0, 0));
+    AddTubeFaces(BRepPrimAPI_MakeTorus(bendAxes, bendRadius, radius, M_PI / 2).Shape(), builder, outer);
+    // 进口直管沿 +Y 到 (R, 0, 0)，出口直管由 (0, R, 0) 沿 -X
+    const gp_Dir inletDir(0, 1, 0), outletDir(-1, 0, 0);
+    AddTubeFaces(BRepPrimAPI_MakeCylinder(gp_Ax2(gp_Pnt(bendRadius, -straight, 0), inletDir), radius, straight / 2).Shape(),
+                 builder, outer);
+    AddTubeFaces(BRepPrimAPI_MakeCylinder(gp_Ax2(gp_Pnt(bendRadius, -straight / 2, 0), inletDir), radius, straight / 2).Shape(),
+                 builder, outer);
+    AddTubeFaces(BRepPrimAPI_MakeCylinder(gp_Ax2(gp_Pnt(0, bendRadius, 0), outletDir), radius, straight).Shape(), builder, outer);
+
+    const TopoDS_Shape centerline = MainWindow::ExtractAnalyticalCenterlines(outer);
+    if (centerline.IsNull()) return "未提取到中心线";
+    const int numEdges = CountSubShapes(centerline, TopAbs_EDGE);
+    if (numEdges != 3) return QString("中心线有 %1 条边，应为 3 条").arg(numEdges);
+
+    std::vector<gp_Pnt> samples;
+    std::vector<double> weights;
+    const double length = SampleCenterline(centerline, samples, weights);
+    const double expected = 2 * straight + bendRadius * M_PI / 2;
+    if (std::abs(length - expected) > 1e-6 * expected) return QString("中心线长度 %1，应为 %2").arg(length, 0, 'f', 6).arg(expected, 0, 'f', 6);
+
+    std::vector<gp_Pnt> bendingLine{gp_Pnt(bendRadius, -straight, 0)};
+    const int arcSegments = 4000;
+    for (int i = 0; i <= arcSegments; i++) {
+        const double phi = M_PI / 2 * i / arcSegments;
+        bendingLine.emplace_back(bendRadius * std::cos(phi), bendRadius * std::sin(phi), 0);
+    }
+    bendingLine.emplace_back(-straight, bendRadius, 0);
+    double maxDeviation = 0, meanDeviation = 0;
+    CenterlineDeviation(samples, weights, bendingLine, maxDeviation, meanDeviation);
+    if (maxDeviation > 1e-5) return QString("与弯曲线的最大偏差 %1，应为 0").arg(maxDeviation);
+    return QString();
+}
+
+//自检入口（main 中检测到 --self-test 时调用）：逐项运行，返回失败的项数
+int MainWindow::RunSelfTest()
+{
+    const std::vector<std::pair<const char*, QString (*)()>> checks = {
+        {"重划分：反向的边界节点链", CheckRemeshReversedBoundary},
+        {"中心线：直管-弯管-直管的长度和偏差", CheckCenterlineStraightBendStraight},
+    };
+    int failures = 0;
+    for (const auto& check : checks) {
+        QString error;
+        try {
+            error = check.second();
+        } catch (const Standard_Failure& e) {
+            error = QString("OCC 异常: %1").arg(e.GetMessageString());
+        }
+        if (error.isEmpty()) {
+            qDebug() << "通过:" << check.first;
+        } else {
+            qWarning() << "失败:" << check.first << "-" << error;
+            failures++;
+        }
+    }
+    return failures;
+}
+
+
+
+
+
+
+
 
 
 
@@ -3,6 +3,17 @@
 
 #include <QMainWindow>
 #include <QMdiArea>
+#include <QSet>
+#include <QMap>
+#include <QPointer>
+#include <QProcess>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QThreadPool>
+#include <QDialog>
+#include <QTableWidget>
+#include <QProgressBar>
+#include <QLabel>
 
 #include <QMainWindow>
 #include <AIS_InteractiveContext.hxx>
@@ -38,6 +49,7 @@
 #include <vtkRenderWindowInteractor.h>
 #include <vtkRenderer.h>
 #include <TopTools_ListOfShape.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
 #include <NCollection_DataMap.hxx>
 // 在包含完 OpenCASCADE 头文件之后，恢复警告设置
 #pragma GCC diagnostic pop
@@ -61,8 +73,19 @@
 #include <vtkDataArray.h>
 #include <vtkPointData.h>
 #include <vtkUnstructuredGrid.h>
+#include <vtkPolyData.h>
+#include <vtkContextView.h>
+#include <vtkStaticPointLocator.h>
+#include <vtkGenericOpenGLRenderWindow.h>
+#include <QVTKOpenGLNativeWidget.h>
 
 #include <functional>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cmath>
+#include <utility>
+#include <future>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -73,6 +96,252 @@ QT_END_NAMESPACE
 // 定义一个 DataMap 类型
 typedef NCollection_DataMap<TopoDS_Shape, Handle(AIS_Shape), TopTools_ShapeMapHasher> AIS_ShapeMap;
 
+// 结果场存储精度（与 comboBox_ResultPrecision 的顺序一致）
+enum class ResultPrecision {
+    Double = 0,     // 原始双精度
+    Float32 = 1,    // 单精度
+    Quantized16 = 2 // 按分量范围量化为 16 位
+};
+
+// 单个点数据场的紧凑存储，只有探针和导出时才反量化
+struct ResultField {
+    std::string name;
+    int numComponents = 0;
+    vtkIdType numTuples = 0;
+    ResultPrecision precision = ResultPrecision::Double;
+    std::vector<double> f64;
+    std::vector<float> f32;
+    std::vector<uint16_t> q16;
+    std::vector<double> compMin;   // 每个分量的最小值
+    std::vector<double> compScale; // 每个分量的量化步长：v = min + q * scale
+
+    double Value(vtkIdType tuple, int comp) const;
+    void Tuple(vtkIdType tuple, double* out) const;
+    vtkSmartPointer<vtkDataArray> ToVTKArray() const; // 反量化为 VTK 数组
+    size_t ByteSize() const;
+};
+
+// 一个结果帧：网格拓扑和坐标保存在 grid 中，点数据场单独压缩保存
+struct ResultFrame {
+    QString filePath;
+    qint64 fileSize = 0;          // 读取时的文件大小和修改时间，用于判断文件是否已更新
+    qint64 fileTime = 0;
+    ResultPrecision precision = ResultPrecision::Double;
+    vtkSmartPointer<vtkUnstructuredGrid> grid;
+    std::vector<ResultField> fields;
+    size_t boundBytes = 0;        // 绑定在 grid 上着色、不与场存储共用内存的数组字节数
+
+    const ResultField* Field(const std::string& name) const;
+    size_t ByteSize() const;
+};
+
+// 绑定到帧网格上用于着色的数组。量化场直接绑定 16 位数组（多分量场绑定量化后的模），
+// 数组值 a 与场值 v 满足 v = offset + a * scale；单精度/双精度场 offset = 0、scale = 1
+struct BoundResultField {
+    vtkSmartPointer<vtkDataArray> array;
+    double offset = 0.0;
+    double scale = 1.0;
+
+    bool Mapped() const { return offset != 0.0 || scale != 1.0; }
+    void ValueRange(double range[2]) const;                          // 场值范围，多分量取模
+    void ArrayRange(const double valueRange[2], double out[2]) const; // 场值范围换算为数组值范围
+};
+
+// 结果帧的读取、压缩和着色绑定，不依赖界面：主窗口和离屏出图工作进程共用。
+// 文件格式（旧版 .vtk、VTK XML .vtu/.pvd 和 VTKHDF）按文件头自动识别
+class ResultFrameReader
+{
+public:
+    ResultPrecision precision = ResultPrecision::Double; // 点数据场的存储模式
+
+    vtkSmartPointer<vtkUnstructuredGrid> ReadResultGrid(const QString& framePath);
+    bool LoadResultFrame(const QString& fileName, ResultFrame& frame);
+    static BoundResultField BindResultField(ResultFrame& frame, const std::string& name);
+
+private:
+    vtkSmartPointer<vtkUnstructuredGrid> ReadVTKHDFStep(const QString& path, int step);
+
+    vtkSmartPointer<vtkUnstructuredGrid> m_hdfTopology; // 最近读取的 VTKHDF 拓扑，各步共用（只在 HDF5 锁内访问）
+    QString m_hdfTopologyKey;
+};
+
+// 节点主序的时程数据：一个场在全部帧上的值按 [节点][帧][分量] 连续存放，
+// 读取一个节点的时程只需读一段连续内存；缺该场的帧为 NaN
+struct NodeHistoryField {
+    std::string name;
+    int numComponents = 0;
+    int numFrames = 0;
+    vtkIdType numNodes = 0;
+    std::vector<float> values;
+
+    const float* Node(vtkIdType node) const { return values.data() + static_cast<size_t>(node) * numFrames * numComponents; }
+};
+
+// 结果剖切面：每个输出点由共用拓扑上一条边的两端节点插值（剖切保留的原节点两端相同），
+// 只依赖平面位置；切换帧或场时只按权重重新插值
+struct CutGeometry {
+    vtkIdType numNodes = 0;            // 生成时的拓扑节点数
+    std::vector<vtkIdType> pointA, pointB;
+    std::vector<float> weight;         // 输出点 = (1 - w)·A + w·B
+    vtkSmartPointer<vtkPolyData> polyData;
+    vtkSmartPointer<vtkActor> actor;
+    vtkSmartPointer<vtkLookupTable> lut;
+    vtkSmartPointer<vtkScalarBarActor> scalarBar;
+};
+
+// 网格质量：各指标作为单元数据（连续 float 数组）挂在网格上，切换指标时直接复用
+struct MeshQuality {
+    vtkSmartPointer<vtkPointSet> dataSet;  // 表面三角网格（vtkPolyData）或六面体网格（vtkUnstructuredGrid）
+    std::vector<TopoDS_Face> faces;        // 表面网格 FaceId 对应的 OCC 面
+    bool hex = false;
+};
+
+// 结果索引项：按路径跟踪帧文件，大小或修改时间变化即视为新版本
+struct ResultIndexEntry {
+    QString path;
+    qint64 size = 0;
+    qint64 mtime = 0;  // ms since epoch
+};
+
+// 合并共享顶点后的三角网格：32 位紧凑索引，每个三角形记录所属 OCC 面的序号（拾取用）
+using WeldIndex = std::int32_t;
+struct WeldedMesh {
+    std::vector<double> points;        // xyz
+    std::vector<float> normals;        // 节点单位法向，与 points 一一对应
+    std::vector<WeldIndex> triangles;  // 每 3 个一组
+    std::vector<int> faceIds;          // 三角形所属面在 faces 中的序号
+    std::vector<TopoDS_Face> faces;
+    double deflection = 0;             // 三角化的最大弦高偏差，决定合并容差
+};
+
+// 内存账目中的一项：按子系统统计，lastUse 越小越久未用
+struct MemoryEntry {
+    QString subsystem;
+    QString key;
+    size_t bytes = 0;
+    quint64 lastUse = 0;
+    bool evictable = false; // 可淘汰并在需要时重建
+};
+
+// 对比视图中的一个视口：结果帧序号和着色场
+struct CompareViewport {
+    int frame = 0;
+    QString field;
+};
+
+// 弯管建模参数（与 MakeElbowModel 的参数顺序一致）
+struct ElbowParameters {
+    double tube_outer_radius, tube_inner_radius, tube_length;
+    double rotary_sleeve_thickness, rotary_sleeve_length, rotary_sleeve_pos;
+    double fixed_sleeve_thickness, fixed_sleeve_length, fixed_sleeve_pos;
+    double arc_radius, arc_thickness, arc_angle_rad;
+};
+
+// 缓存的弯管部件：OCC 形状及其三角化结果
+struct ElbowComponent {
+    TopoDS_Shape shape;
+    vtkSmartPointer<vtkPolyData> polyData;
+};
+
+// 管体扫掠段：直线段或圆环段，start/end 为中心线端点
+struct TubeSweepSegment {
+    bool toroidal = false;
+    double start[3] = {0.0, 0.0, 0.0};
+    double end[3] = {0.0, 0.0, 0.0};
+    double center[3] = {0.0, 0.0, 0.0}; // 圆环中心
+    double axis[3] = {0.0, 0.0, 1.0};   // 圆环轴，绕其正向旋转 angle 由 start 到 end
+    double angle = 0.0;                 // 圆环段转角 (rad, > 0)
+    double bendRadius = 0.0;            // 圆环段中心线半径
+    double rOut = 0.0, rIn = 0.0;
+
+    double Length() const
+    {
+        if (toroidal) return bendRadius * angle;
+        const double d[3] = {end[0] - start[0], end[1] - start[1], end[2] - start[2]};
+        return std::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+    }
+
+    void Reverse()
+    {
+        std::swap(start, end);
+        for (double& a : axis) a = -a;
+    }
+};
+
+// 管体六面体扫掠网格：截面序号 x 厚度层 x 周向 结构化编号，单元为 8 节点六面体
+struct TubeHexMesh {
+    std::vector<double> points;      // xyz
+    std::vector<vtkIdType> cells;    // 每 8 个一组，VTK/Abaqus 节点顺序
+    std::vector<int> segmentOfCell;  // 单元所属扫掠段
+    vtkIdType numRings = 0;
+    int numThickness = 0, numCircumferential = 0;
+};
+
+// 变形体材料（mm-t-s-MPa 单位制），写入 inp 的 *MATERIAL
+struct InpMaterial {
+    std::string name = "TUBE_STEEL";
+    double density = 7.85e-9;      // t/mm^3
+    double youngsModulus = 206000; // MPa
+    double poissonRatio = 0.3;
+    std::vector<std::pair<double, double>> plastic = { // (屈服应力 MPa, 塑性应变)
+        {245.0, 0.0}, {330.0, 0.05}, {400.0, 0.15}, {450.0, 0.3}};
+};
+
+// 刚体参考点（参考点与转动中心）
+struct RigidBodyRef {
+    std::string name;
+    double ref[3];
+    double rot[3];
+};
+
+// 回弹测量结果
+struct SpringbackResult {
+    bool valid = false;
+    double loadedAngle = 0.0, unloadedAngle = 0.0;   // 弯曲角 (rad)
+    double loadedRadius = 0.0, unloadedRadius = 0.0; // 弯曲半径 (mm)
+    double rmsDeviation = 0.0, maxDeviation = 0.0;   // 配准后偏差 (mm)
+};
+
+// 本地求解作业
+struct SolverJob {
+    enum State { Queued, Running, Finished, Failed };
+    int id = 0;
+    int priority = 0;             // 越大越先运行
+    QString name;
+    QString program;
+    QStringList arguments;
+    QString workDir, resultsDir, logPath;
+    State state = Queued;
+    QProcess* process = nullptr;
+    QMap<QString, qint64> pendingFrames; // 尚未确认写完的帧：路径 -> 上次检查时的大小
+    QSet<QString> ingestedFrames;        // 已确认写完的帧，查看该作业时读入结果视图
+};
+
+// 离屏出图任务：工作进程渲染一帧的全部场和视角，或由 ffmpeg 把一组图片序列编码为视频
+struct RenderJob {
+    enum State { Queued, Running, Finished, Failed };
+    bool encode = false;          // 编码任务在全部帧写完后才启动
+    QString program;
+    QStringList arguments;
+    QString description;
+    State state = Queued;
+    QProcess* process = nullptr;
+};
+
+// 后台导出任务：task 只使用捕获的数据，返回空串表示写入并校验成功，否则为错误信息
+struct ExportJob {
+    enum Format { Step, BRep, Stl, Glb };
+    enum State { Queued, Running, Finished, Failed };
+    int id = 0;
+    Format format = Step;
+    QString path;
+    State state = Queued;
+    QString message;
+    qint64 bytes = 0;
+    std::function<QString()> task;
+    std::future<QString> future;
+};
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -81,11 +350,16 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // 离屏出图工作进程入口（--render-worker），不创建主窗口，返回进程退出码
+    static int RunRenderWorker(const QStringList& arguments);
+    // 几何算法自检入口（--self-test），返回失败的项数
+    static int RunSelfTest();
+
     // 显示形状（支持颜色和线宽）
     void DisplayOuterSurfaceAndCenterline(const TopoDS_Shape& outerShape, const TopoDS_Shape& centerlineShape);
 
     // 提取中心线
-    TopoDS_Shape ExtractAnalyticalCenterlines(const TopoDS_Shape& shape);
+    static TopoDS_Shape ExtractAnalyticalCenterlines(const TopoDS_Shape& shape);
 
     void make_elbow_model(); // 弯管建模
     void import_part(); // 导入数模
@@ -101,12 +375,29 @@ public:
     //网格划分
     void on_meshButton_clicked();
     void DisplayMeshedShape(const TopoDS_Shape& meshedShape);
+    void MeshTubeHex();
+    void RemeshIsotropic(double elementSize);
+    void DisplayTubeHexMesh(const TubeHexMesh& mesh);
 
 private:
     Ui::MainWindow *ui;
     TopoDS_Shape m_currentShape; // 保存当前加载的模型
     TopoDS_Shape m_extractedOuterSurface; // 存储提取的外壁
     TopoDS_Shape m_meshedShape; // 保存网格模型
+    TubeHexMesh m_tubeHexMesh; // 六面体扫掠网格
+    int m_hexThicknessLayers = 2;
+    int m_hexCircumferential = 32;
+    double m_hexElementSize = 0.0; // 轴向单元长度 (mm)，0 表示与周向单元等长；与表面网格弦高无关
+
+    //网格质量（着色显示在 "mesh" 图层）
+    MeshQuality m_meshQuality;
+    QPointer<QDialog> m_qualityPanel;
+    QPointer<QLabel> m_qualitySummary;
+    vtkSmartPointer<vtkContextView> m_qualityChartView;
+    int m_qualityWorstCount = 20;
+    void onMeshQualityClicked();
+    bool BuildMeshQuality(bool hex);
+    void ShowMeshQuality(int metric, int worstCount);
 
     void MakeElbowModel(
         double R_out, double R_in, double length,        // 管体外半径、内半径、长度
@@ -115,24 +406,59 @@ private:
         double rotary_pos, double fixed_pos,             // 套筒位置（距管体右端的距离）
         double arc_R, double arc_t, double arc_angle // 半圆弧套筒半径、厚度、角度（单位：弧度）
         );
+    // 部件缓存：参数未变的部件在重复建模（如回弹补偿迭代）时直接复用
+    ElbowParameters m_elbowParameters = {};
+    std::map<QString, ElbowComponent> m_elbowCache;
+    QSet<QString> m_elbowCacheUsed;
+    QThreadPool m_elbowPool;             // 缓存未命中的部件在此建模
+    quint64 m_elbowBuildGeneration = 0;  // 每次异步建模加一，过期的部件结果丢弃
+    const ElbowComponent& CachedElbowComponent(const QString& key, double deflection,
+                                               const std::function<TopoDS_Shape()>& build);
+    std::vector<const ElbowComponent*> BuildElbowComponents(
+        const ElbowParameters& p, const std::function<void(size_t, const ElbowComponent&)>& onReady = nullptr);
+    std::vector<RigidBodyRef> m_rigidBodyRefs; // 最近一次建模的刚体参考点
     // 辅助函数声明
     vtkSmartPointer<vtkPolyData> ConvertOCCShapeToVTKPolyData(const TopoDS_Shape& shape, double linearDeflection);
     vtkSmartPointer<vtkActor> CreateVTKActor(vtkSmartPointer<vtkPolyData> polyData,
                                              double r, double g, double b);
     // 在MDI子窗口中显示模型的函数
     void ShowModelInMdiArea(vtkSmartPointer<vtkRenderer> renderer);
+    // 场景视图：一个长期存在的渲染窗口，各显示结果按图层保存，切换视图只改可见性
+    QPointer<QVTKOpenGLNativeWidget> m_viewWidget;
+    vtkSmartPointer<vtkGenericOpenGLRenderWindow> m_viewWindow;
+    vtkSmartPointer<vtkRenderer> m_viewRenderer;
+    std::map<QString, std::vector<vtkSmartPointer<vtkProp>>> m_sceneLayers;
+    QStringList m_visibleLayers;
+    void ShowInViewArea(QWidget* widget);
+    vtkRenderer* EnsureSceneView();
+    void SetSceneLayer(const QString& layer, const std::vector<vtkSmartPointer<vtkProp>>& props);
+    void AddToSceneLayer(const QString& layer, vtkProp* prop);
+    void ClearSceneLayer(const QString& layer);
+    bool HasSceneLayer(const QString& layer) const;
+    void ShowSceneLayers(const QStringList& layers, bool resetCamera = true);
+    QString SceneLayerOf(vtkProp* prop) const;
 
     // 读取STEP文件
+    bool m_parallelImportMesh = false; // 转换后并行划分显示网格（转换本身始终串行）
+    // 导入后缝合修复：面片缝合成共享边的壳，结果按文件缓存
+    bool m_healImport = false;
+    double m_sewingTolerance = 1e-2; // 缝合容差 (mm)
+    TopoDS_Shape HealImportedShape(const QString& fileName, const TopoDS_Shape& shape);
+    // 当前模型的边 -> 相邻面表，共享拓扑时用于精确查找相邻面
+    TopoDS_Shape m_adjacencyShape;
+    TopTools_IndexedDataMapOfShapeListOfShape m_edgeFaces;
+    bool m_sharedTopology = false;
+    void BuildEdgeFaceMap(const TopoDS_Shape& shape);
     TopoDS_Shape ReadSTEPFile(const QString& fileName);
     // 读取IGES文件
     TopoDS_Shape ReadIGESFile(const QString& fileName);
-    // 将OCC形状显示到ui->mdiArea（复用渲染逻辑）
-    void DisplayShape(const TopoDS_Shape& shape);
+    // 将OCC形状显示到场景视图的指定图层
+    void DisplayShape(const TopoDS_Shape& shape, const QString& layer = "original");
 
 
     // 用OCC提取表面
-    // 存储 OCC Face 和 VTK CellId 的映射
-    std::map<vtkIdType, TopoDS_Face> m_faceMap;
+    // 各图层的 OCC 面表，按三角形的 FaceId 单元数据索引
+    std::map<QString, std::vector<TopoDS_Face>> m_layerFaces;
     // 辅助函数
     void GetFacesSharingEdge(const TopoDS_Shape& shape, const TopoDS_Edge& edge, TopTools_ListOfShape& faceList);
     bool AreFacesOnSameSide(const TopoDS_Face& f1, const TopoDS_Face& f2);
@@ -158,6 +484,17 @@ private:
     AIS_ShapeMap m_aisShapeMap;
     TopoDS_Shape m_extractedCenterline;   // 保存中心线结果
 
+    //中心线与弯曲线偏差
+    std::vector<gp_Pnt> m_bendingLine;             // 弯曲线折线顶点
+    TopoDS_Shape m_centerlineSampleShape;          // 已采样的中心线，变化后重新采样
+    std::vector<gp_Pnt> m_centerlineSamples;
+    std::vector<double> m_centerlineSampleWeights; // 每个采样点代表的弧长
+    double m_centerlineLength = 0.0;
+    QPointer<QDialog> m_bendingPanel;
+    void onBendingLineClicked();
+    void UpdateBendingDeviation();
+    void DisplayBendingLine(bool resetCamera);
+
     //读取结果文件
     void onTabInitClicked(int index);
     //结果可视化
@@ -171,9 +508,151 @@ private:
     //void UpdateDisplayFrame(int frame); // 假设这是你更新显示的函数
     void VisualVTKGroupFile(const QStringList& fileNames, const QString& scalarType);
     QStringList vtkFilePaths;
+    // 结果视图状态（场景 "results" 图层），供增量加入新帧
+    QString m_resultScalarType = "S_Mises";
+    vtkSmartPointer<vtkLookupTable> m_resultLut;
+    vtkSmartPointer<vtkScalarBarActor> m_resultScalarBar;
+    vtkSmartPointer<vtkActor> AddResultFrameActor(ResultFrame& frame);
+    // 内存预算：按子系统统计占用，超出预算时按 LRU 淘汰结果帧和隐藏图层等可重建的数据
+    std::map<QString, quint64> m_memoryLastUse; // "子系统|键" -> 最近使用序号
+    quint64 m_memoryTick = 0;
+    qint64 m_memoryBudgetMB = 2048;
+    QTimer* m_memoryTimer = nullptr;
+    QPointer<QDialog> m_memoryPanel;
+    QTableWidget* m_memoryTable = nullptr;
+    void TouchMemory(const QString& subsystem, const QString& key);
+    std::vector<MemoryEntry> CollectMemoryEntries() const;
+    bool EvictMemoryEntry(const MemoryEntry& entry);
+    void EnforceMemoryBudget();
+    bool EnsureResultFrameLoaded(ResultFrame& frame);
+    void onMemoryPanelClicked();
+    void RefreshMemoryPanel();
+    // 对比视图：替换场景渲染器的多个同步视口
+    std::vector<vtkSmartPointer<vtkRenderer>> m_compareRenderers;
+    std::vector<CompareViewport> m_compareViewports;
+    void onCompareClicked();
+    void ShowCompareView(const std::vector<CompareViewport>& viewports);
+    void ClearCompareView();
+    // 结果索引：监视结果目录，只读取新增或变化的帧，已读取的帧在切换标签页时保留
+    QString m_resultIndexDir;
+    std::vector<ResultIndexEntry> m_resultIndex;
+    QFileSystemWatcher* m_resultsWatcher = nullptr;
+    QTimer* m_resultIndexTimer = nullptr;
+    void SetResultIndexDir(const QString& dirPath);
+    void RefreshResultIndex();
+    int FindResultFrame(const QString& path) const;
+    void RebuildResultActors();
     void onButtonSClicked();
     void onButtonSMisesClicked();
     void onButtonSPrincipalClicked();
     void onButtonUClicked();
+
+    //结果帧读取（含场存储模式）
+    ResultFrameReader m_resultReader;
+    std::vector<ResultFrame> m_resultFrames; // 已加载的结果帧
+    void ReportResultMemory();
+    bool EnsureResultFramesLoaded();
+    const ResultFrame* AcquireResultFrame(size_t index, ResultFrame& streamed);
+    void TouchResidentResultFrames();
+
+    //节点探针：静态点定位器按拓扑只建一次，时程数据在读取结果后并行转置为节点主序
+    vtkSmartPointer<vtkStaticPointLocator> m_probeLocator;
+    QString m_probeTopologyKey;
+    std::vector<NodeHistoryField> m_nodeHistory;
+    QString m_nodeHistoryKey; // 生成时程数据的各帧路径和时间戳
+    QPointer<QDialog> m_probePanel;
+    vtkSmartPointer<vtkContextView> m_probeChartView;
+    bool BuildNodeHistory();
+    void ProbeResultNode(const double position[3]);
+    void ShowNodeHistory(vtkIdType node, const double position[3]);
+
+    //剖切面（场景 "cut" 图层）
+    CutGeometry m_cut;
+    QPointer<QDialog> m_cutPanel;
+    void onCutPlaneClicked();
+    bool UpdateCutGeometry(bool clip, const double origin[3], const double normal[3]);
+    void UpdateCutScalars(int frameIndex, const QString& fieldName);
+
+    //截面分析（椭圆度/壁厚）
+    vtkSmartPointer<vtkContextView> m_chartView; // 曲线图视图
+    int m_sectionStations = 200; // 沿管长的站位数
+    int m_sectionSectors = 36;   // 周向扇区数（偶数）
+    void RunSectionAnalysis(bool thickness);
+    void ShowStationStepCharts(const QString& title, const std::vector<double>& stations,
+                               const std::vector<std::vector<double>>& values);
+    void onOvalityAllClicked();
+    void onThicknessAllClicked();
+    void onSectionOptionClicked();
+
+    //褶皱检测
+    double m_wrinkleThreshold = 0.1; // 波幅阈值 (mm)
+    void RunWrinkleScan(bool allFrames);
+    void onWrinklesClicked();
+    void onWrinklesAllClicked();
+    void onWrinklesOptionClicked();
+
+    //回弹测量
+    SpringbackResult m_springback;        // 最近一次回弹测量
+    int m_springbackLoadedFrame = -1;     // 最后加载帧，-1 表示倒数第二帧
+    void onSpringbackClicked();
+    void onSpringbackOptionClicked();
+
+    //回弹补偿
+    bool m_compensationActive = false;
+    double m_compensationTargetAngle = 0.0;  // 目标弯曲角 (rad)
+    double m_compensationTargetRadius = 0.0; // 目标弯曲半径 (mm)
+    double m_compensationRelaxation = 0.8;   // 相邻两次补偿之间的松弛因子
+    int m_compensationCycle = 0;             // 已完成的补偿次数
+    void onCompensationClicked();
+    void onCompensationOptionClicked();
+
+    //生成inp文件
+    InpMaterial m_tubeMaterial; // 管体材料
+    void onGenerateInpClicked();
+    void onAddMaterialClicked();
+
+    //提交计算
+    std::vector<SolverJob> m_solverJobs;
+    QString m_solverCommand;
+    int m_lastJobPriority = 0;
+    int m_maxConcurrentJobs = 1;
+    int m_nextJobId = 1;
+    int m_viewedJobId = -1;               // 结果视图查看的作业（在作业队列中选择）
+    QFileSystemWatcher* m_jobWatcher = nullptr;
+    QTimer* m_jobPollTimer = nullptr;
+    QPointer<QDialog> m_jobPanel;
+    QTableWidget* m_jobTable = nullptr;
+    SolverJob* FindSolverJob(int id);
+    void ViewSolverJob(int id);
+    void onJobPanelClicked();
+    void RefreshJobPanel();
+    void onSubmitJobClicked();
+    void StartQueuedJobs();
+    void onSolverJobFinished(int id, bool success);
+    void PollSolverJobs();
+    void PollSolverJob(SolverJob& job, bool finished);
+    bool IngestResultFrame(const QString& path);
+    void ReportSolverJobs();
+
+    //离屏出图
+    std::vector<RenderJob> m_renderJobs;
+    int m_maxRenderWorkers = 2;
+    QString m_renderOutputDir;
+    void onRenderReportClicked();
+    void StartQueuedRenderJobs();
+    void onRenderJobFinished(size_t index, bool success);
+    void ReportRenderJobs();
+
+    //后台导出（外壁 STEP/BRep/STL/GLB）
+    std::vector<ExportJob> m_exportJobs;
+    int m_nextExportId = 1;
+    int m_maxConcurrentExports = 2;
+    int m_exportFormatMask = 1; // 按 ExportJob::Format 的位
+    QString m_exportBasePath;
+    QTimer* m_exportPollTimer = nullptr;
+    QProgressBar* m_exportProgress = nullptr;
+    void StartQueuedExports();
+    void PollExports();
+    void ReportExports();
 };
 #endif // MAINWINDOW_H